@@ -0,0 +1,112 @@
+/**
+ * Microbenchmark comparing the original string/bitset virtual address parser
+ * with the in-place parser used by TextAddressSource.
+ *
+ * Build and run it with:
+ *   make bench
+ */
+
+#include "address_stream/address_stream.h"
+#include "virtual_address/virtual_address.h"
+#include <bitset>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The number of addresses parsed by each benchmark.
+static const size_t NUM_ADDRESSES = 2000000;
+
+
+/**
+ * The original parser: splits the address into two strings one character at a
+ * time and converts each through a bitset.
+ */
+VirtualAddress legacy_from_string(int process_id, string address) {
+    string page = "", offset = "";
+    for (int i = 0; i < VirtualAddress::PAGE_BITS; i++) {
+        page += address.at(i);
+    }
+    for (int i = VirtualAddress::PAGE_BITS; i < VirtualAddress::ADDRESS_BITS; i++) {
+        offset += address.at(i);
+    }
+
+    int page_integer = bitset<VirtualAddress::PAGE_BITS>(page).to_ulong();
+    int offset_integer = bitset<VirtualAddress::OFFSET_BITS>(offset).to_ulong();
+    return VirtualAddress(process_id, page_integer, offset_integer);
+}
+
+
+/**
+ * Runs the given benchmark and prints its time per address.
+ */
+template <typename Function>
+void measure(const string& name, Function function) {
+    auto start = chrono::steady_clock::now();
+    size_t checksum = function();
+    auto elapsed = chrono::steady_clock::now() - start;
+
+    double ns = chrono::duration<double, nano>(elapsed).count() / NUM_ADDRESSES;
+    cout << name << ": " << ns << " ns/address (checksum " << checksum << ")" << endl;
+}
+
+
+int main() {
+    mt19937 random(1);
+    vector<string> addresses;
+    stringstream trace;
+    for (size_t i = 0; i < NUM_ADDRESSES; i++) {
+        addresses.push_back(bitset<VirtualAddress::ADDRESS_BITS>(random()).to_string());
+        trace << (i % 100) << " " << addresses.back() << "\n";
+    }
+    const string trace_text = trace.str();
+
+    measure("legacy from_string        ", [&] {
+        size_t checksum = 0;
+        for (const string& address : addresses) {
+            checksum += legacy_from_string(1, address).page;
+        }
+        return checksum;
+    });
+
+    measure("from_chars                ", [&] {
+        size_t checksum = 0;
+        for (const string& address : addresses) {
+            checksum += VirtualAddress::from_chars(1, address.data(), address.size()).page;
+        }
+        return checksum;
+    });
+
+    measure("legacy istream trace      ", [&] {
+        istringstream in(trace_text);
+        int pid;
+        string address;
+        size_t checksum = 0;
+        while (in >> pid >> address) {
+            checksum += legacy_from_string(pid, address).page;
+        }
+        return checksum;
+    });
+
+    measure("TextAddressSource trace   ", [&] {
+        istringstream in(trace_text);
+        TextAddressSource source(in);
+        vector<VirtualAddress> chunk;
+        size_t checksum = 0;
+        bool more = true;
+        while (more) {
+            chunk.clear();
+            more = source.read_chunk(chunk, AddressStream::CHUNK_SIZE);
+            for (const VirtualAddress& address : chunk) {
+                checksum += address.page;
+            }
+        }
+        return checksum;
+    });
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * This file contains the definition of the AddressLayout template, which
+ * describes how an address splits into a page (or frame) number and an offset.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+
+
+/**
+ * The layout of an address with PageBits bits of page number above OffsetBits
+ * bits of offset. Everything is a compile-time constant, so code written
+ * against a layout costs nothing over hard-coded shifts and masks.
+ */
+template <size_t PageBits, size_t OffsetBits>
+struct AddressLayout {
+    static_assert(PageBits + OffsetBits <= 64, "addresses are at most 64 bits wide");
+
+    /**
+    * The number of bits of page number, of offset, and in all.
+    */
+    static constexpr size_t PAGE_BITS = PageBits;
+    static constexpr size_t OFFSET_BITS = OffsetBits;
+    static constexpr size_t ADDRESS_BITS = PageBits + OffsetBits;
+
+    /**
+    * The number of bytes in a page, and of pages in an address space.
+    */
+    static constexpr uint64_t PAGE_SIZE = uint64_t(1) << OffsetBits;
+    static constexpr uint64_t NUM_PAGES = PageBits == 64 ? 0 : uint64_t(1) << PageBits;
+
+    /**
+    * Bitmasks for the offset and page portions of an address.
+    */
+    static constexpr uint64_t OFFSET_BITMASK = PAGE_SIZE - 1;
+    static constexpr uint64_t PAGE_BITMASK = (NUM_PAGES - 1) << OffsetBits;
+
+    /**
+    * Returns the page number of the given address.
+    */
+    static constexpr uint64_t get_page(uint64_t address) {
+        return (address & PAGE_BITMASK) >> OFFSET_BITS;
+    }
+
+    /**
+    * Returns the offset into its page of the given address.
+    */
+    static constexpr uint64_t get_offset(uint64_t address) {
+        return address & OFFSET_BITMASK;
+    }
+
+    /**
+    * Returns the address of the given offset into the given page.
+    */
+    static constexpr uint64_t make_address(uint64_t page, uint64_t offset) {
+        return (page << OFFSET_BITS) | (offset & OFFSET_BITMASK);
+    }
+};
+
+
+/**
+ * The 64 KiB address spaces with 64-byte pages that the traces use.
+ */
+typedef AddressLayout<10, 6> TraceLayout;
+
+/**
+ * 32-bit and 48-bit address spaces with 4 KiB pages.
+ */
+typedef AddressLayout<20, 12> Layout32;
+typedef AddressLayout<36, 12> Layout48;
@@ -0,0 +1,58 @@
+/**
+ * This file contains tests for the AddressLayout template.
+ */
+
+#include "address_layout/address_layout.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(AddressLayout, TraceLayout) {
+  ASSERT_EQ(16, TraceLayout::ADDRESS_BITS);
+  ASSERT_EQ(64, TraceLayout::PAGE_SIZE);
+  ASSERT_EQ(1024, TraceLayout::NUM_PAGES);
+  ASSERT_EQ(0x3F, TraceLayout::OFFSET_BITMASK);
+  ASSERT_EQ(0xFFC0, TraceLayout::PAGE_BITMASK);
+}
+
+
+TEST(AddressLayout, Layout32) {
+  ASSERT_EQ(32, Layout32::ADDRESS_BITS);
+  ASSERT_EQ(4096, Layout32::PAGE_SIZE);
+  ASSERT_EQ(1 << 20, Layout32::NUM_PAGES);
+  ASSERT_EQ(0xFFFFF000, Layout32::PAGE_BITMASK);
+
+  ASSERT_EQ(0xDEADB, Layout32::get_page(0xDEADBEEF));
+  ASSERT_EQ(0xEEF, Layout32::get_offset(0xDEADBEEF));
+}
+
+
+TEST(AddressLayout, Layout48) {
+  const uint64_t address = 0x7FFF12345678ULL;
+
+  ASSERT_EQ(48, Layout48::ADDRESS_BITS);
+  ASSERT_EQ(1ULL << 36, Layout48::NUM_PAGES);
+  ASSERT_EQ(0x7FFF12345ULL, Layout48::get_page(address));
+  ASSERT_EQ(0x678, Layout48::get_offset(address));
+
+  // Bits above the address width are not part of the page.
+  ASSERT_EQ(0x7FFF12345ULL, Layout48::get_page(address | (1ULL << 50)));
+}
+
+
+TEST(AddressLayout, MakeAddressRoundTrips) {
+  for (size_t page : {size_t(0), size_t(1), size_t(0x12345), Layout48::NUM_PAGES - 1}) {
+    for (size_t offset : {size_t(0), size_t(1), Layout48::PAGE_SIZE - 1}) {
+      uint64_t address = Layout48::make_address(page, offset);
+      ASSERT_EQ(page, Layout48::get_page(address));
+      ASSERT_EQ(offset, Layout48::get_offset(address));
+    }
+  }
+}
+
+
+TEST(AddressLayout, IsCompileTime) {
+  static_assert(Layout32::get_page(0x1000) == 1, "layouts are usable in constant expressions");
+  static_assert(TraceLayout::make_address(2, 3) == 131, "layouts are usable in constant expressions");
+}
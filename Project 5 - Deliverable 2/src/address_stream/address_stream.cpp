@@ -0,0 +1,197 @@
+/**
+ * This file contains implementations for methods in the AddressStream class and
+ * its sources.
+ */
+
+#include "address_stream/address_stream.h"
+#include <cstring>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t TextAddressSource::BUFFER_SIZE;
+const size_t AddressStream::CHUNK_SIZE;
+const size_t AddressStream::NUM_CHUNKS;
+
+
+/**
+ * Returns true for the characters the text format separates tokens with.
+ */
+static bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+bool TextAddressSource::read_chunk(vector<VirtualAddress>& chunk, size_t max_count) {
+    while (chunk.size() < max_count) {
+        const char* start = this->buffer.data();
+        const char* limit = start + this->end;
+        const char* p = start + this->begin;
+
+        // find the PID and address tokens of the next record; if either could
+        // continue past the end of the buffer, read more and start over
+        while (p < limit && is_space(*p)) {
+            p++;
+        }
+        const char* pid_begin = p;
+        while (p < limit && !is_space(*p)) {
+            p++;
+        }
+        const char* pid_end = p;
+        while (p < limit && is_space(*p)) {
+            p++;
+        }
+        const char* address_begin = p;
+        while (p < limit && !is_space(*p)) {
+            p++;
+        }
+        const char* address_end = p;
+
+        // an R or W after the address marks it as a read or a write
+        while (p < limit && is_space(*p)) {
+            p++;
+        }
+        bool write = false;
+        bool has_access_type = false;
+        if (p < limit && (*p == 'R' || *p == 'r' || *p == 'W' || *p == 'w')) {
+            write = (*p == 'W' || *p == 'w');
+            has_access_type = true;
+        }
+
+        if (p == limit && !this->at_eof) {
+            fill();
+            continue;
+        }
+
+        // a missing address or a malformed PID ends the trace
+        if (address_begin == address_end) {
+            return false;
+        }
+
+        bool negative = (*pid_begin == '-');
+        const char* digit = pid_begin + (negative ? 1 : 0);
+        if (digit == pid_end) {
+            return false;
+        }
+
+        int pid = 0;
+        for (; digit < pid_end; digit++) {
+            unsigned value = *digit - '0';
+            if (value > 9) {
+                return false;
+            }
+            pid = pid * 10 + value;
+        }
+        if (negative) {
+            pid = -pid;
+        }
+
+        chunk.push_back(VirtualAddress::from_chars(pid, address_begin, address_end - address_begin, write));
+        this->begin = (has_access_type ? p + 1 : address_end) - start;
+    }
+    return true;
+}
+
+
+void TextAddressSource::fill() {
+    // keep the unparsed tail, growing the buffer if it is all one token
+    size_t remaining = this->end - this->begin;
+    memmove(this->buffer.data(), this->buffer.data() + this->begin, remaining);
+    this->begin = 0;
+    this->end = remaining;
+
+    if (this->end == this->buffer.size()) {
+        this->buffer.resize(this->buffer.size() * 2);
+    }
+
+    this->in.read(this->buffer.data() + this->end, this->buffer.size() - this->end);
+    this->end += this->in.gcount();
+
+    if (!this->in) {
+        this->at_eof = true;
+    }
+}
+
+
+AddressStream::AddressStream(unique_ptr<AddressSource> source)
+    : source(move(source)), ring(NUM_CHUNKS)
+{
+    for (vector<VirtualAddress>& chunk : this->ring) {
+        chunk.reserve(CHUNK_SIZE);
+    }
+    this->parser = thread(&AddressStream::produce, this);
+}
+
+
+AddressStream::~AddressStream() {
+    {
+        lock_guard<std::mutex> lock(this->mutex);
+        this->stopped = true;
+    }
+    this->not_full.notify_all();
+    this->parser.join();
+}
+
+
+bool AddressStream::next_chunk(vector<VirtualAddress>& chunk) {
+    unique_lock<std::mutex> lock(this->mutex);
+    this->not_empty.wait(lock, [this] { return this->count > 0 || this->finished; });
+
+    if (this->count == 0) {
+        if (this->error) {
+            rethrow_exception(this->error);
+        }
+        return false;
+    }
+
+    // hand the full chunk out and keep the caller's old one to refill later
+    this->ring[this->head].swap(chunk);
+    this->ring[this->head].clear();
+    this->head = (this->head + 1) % NUM_CHUNKS;
+    this->count--;
+
+    lock.unlock();
+    this->not_full.notify_one();
+    return true;
+}
+
+
+void AddressStream::produce() {
+    vector<VirtualAddress> chunk;
+    chunk.reserve(CHUNK_SIZE);
+    bool more = true;
+
+    while (more) {
+        try {
+            more = this->source->read_chunk(chunk, CHUNK_SIZE);
+        } catch (...) {
+            lock_guard<std::mutex> lock(this->mutex);
+            this->error = current_exception();
+            more = false;
+        }
+
+        unique_lock<std::mutex> lock(this->mutex);
+        if (!chunk.empty()) {
+            this->not_full.wait(lock, [this] { return this->count < NUM_CHUNKS || this->stopped; });
+            if (this->stopped) {
+                break;
+            }
+
+            // swap the parsed chunk into the next empty slot of the ring
+            this->ring[(this->head + this->count) % NUM_CHUNKS].swap(chunk);
+            this->count++;
+            this->not_empty.notify_one();
+        }
+        if (this->stopped) {
+            break;
+        }
+    }
+
+    {
+        lock_guard<std::mutex> lock(this->mutex);
+        this->finished = true;
+    }
+    this->not_empty.notify_all();
+}
@@ -0,0 +1,176 @@
+/**
+ * This file contains the definition of the AddressStream class, along with the
+ * sources it can read virtual addresses from.
+ */
+
+#pragma once
+#include "virtual_address/virtual_address.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Something virtual addresses can be parsed from, a chunk at a time.
+ */
+class AddressSource {
+public:
+
+    /**
+    * Destructor.
+    */
+    virtual ~AddressSource() {}
+
+    /**
+    * Appends at most max_count addresses to the given chunk. Returns false once
+    * the input is exhausted, and throws if the input is malformed.
+    */
+    virtual bool read_chunk(std::vector<VirtualAddress>& chunk, size_t max_count) = 0;
+};
+
+
+/**
+ * Reads addresses in the text trace format: a decimal PID followed by the
+ * address as a string of binary digits, and optionally an R or W marking the
+ * access as a read (the default) or a write, separated by whitespace.
+ *
+ * The stream is read in large blocks, and records are parsed in place in the
+ * block without building any temporary strings.
+ */
+class TextAddressSource : public AddressSource {
+public:
+
+    /**
+    * The number of bytes read from the stream at a time.
+    */
+    static const size_t BUFFER_SIZE = 1 << 16;
+
+    /**
+    * Constructor. The stream must outlive this source.
+    */
+    TextAddressSource(std::istream& in) : in(in), buffer(BUFFER_SIZE) {}
+
+    bool read_chunk(std::vector<VirtualAddress>& chunk, size_t max_count) override;
+
+private:
+
+    /**
+    * Moves the unparsed bytes to the front of the buffer and reads more bytes
+    * after them, growing the buffer if a single token fills all of it.
+    */
+    void fill();
+
+    /**
+    * The stream addresses are read from.
+    */
+    std::istream& in;
+
+    /**
+    * The block of input being parsed, of which [begin, end) is unparsed.
+    */
+    std::vector<char> buffer;
+    size_t begin = 0;
+    size_t end = 0;
+
+    /**
+    * True once the stream has no more bytes to give.
+    */
+    bool at_eof = false;
+};
+
+
+/**
+ * Streams virtual addresses from a source in bounded-size chunks. A parser
+ * thread fills a fixed ring of chunks which the consumer drains, so parsing
+ * overlaps with simulation and memory use does not depend on trace length.
+ */
+class AddressStream {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The maximum number of addresses in a single chunk.
+    */
+    static const size_t CHUNK_SIZE = 1 << 12;
+
+    /**
+    * The number of chunks in the ring buffer.
+    */
+    static const size_t NUM_CHUNKS = 8;
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. Starts the parser thread right away.
+    */
+    AddressStream(std::unique_ptr<AddressSource> source);
+
+    /**
+    * Destructor. Stops the parser thread if it is still running.
+    */
+    ~AddressStream();
+
+    /**
+    * Replaces the contents of the given chunk with the next chunk of addresses,
+    * blocking until one is available. Returns false once every address has
+    * been handed out. If the source failed, the exception it threw is rethrown
+    * here once the chunks parsed before the failure have been drained.
+    */
+    bool next_chunk(std::vector<VirtualAddress>& chunk);
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * The body of the parser thread.
+    */
+    void produce();
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * Where the addresses come from.
+    */
+    std::unique_ptr<AddressSource> source;
+
+    /**
+    * The ring of chunks, of which count chunks starting at head are full.
+    */
+    std::vector<std::vector<VirtualAddress>> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+    /**
+    * True once the parser thread has produced its last chunk.
+    */
+    bool finished = false;
+
+    /**
+    * True if the consumer has gone away and the parser should stop early.
+    */
+    bool stopped = false;
+
+    /**
+    * The exception that stopped the parser, if any.
+    */
+    std::exception_ptr error;
+
+    /**
+    * Guards the ring and the flags above.
+    */
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+    /**
+    * The parser thread.
+    */
+    std::thread parser;
+};
@@ -0,0 +1,173 @@
+/**
+ * This file contains tests for the AddressStream class.
+ */
+
+#include "address_stream/address_stream.h"
+#include "gtest/gtest.h"
+#include <bitset>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+
+/**
+ * Builds a text trace of the given number of accesses.
+ */
+string make_trace(size_t num_accesses) {
+  stringstream trace;
+  for (size_t i = 0; i < num_accesses; i++) {
+    trace << (i % 3) << " " << bitset<VirtualAddress::ADDRESS_BITS>(i % 65536) << "\n";
+  }
+  return trace.str();
+}
+
+
+TEST(TextAddressSource, ReadChunk) {
+  istringstream in("1 0000000001000010\n7 1111111111111111\n");
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(source.read_chunk(chunk, 10));
+  ASSERT_EQ(2, chunk.size());
+  ASSERT_EQ(1, chunk[0].process_id);
+  ASSERT_EQ(1, chunk[0].page);
+  ASSERT_EQ(2, chunk[0].offset);
+  ASSERT_EQ(7, chunk[1].process_id);
+}
+
+
+TEST(TextAddressSource, ReadChunk_MaxCount) {
+  istringstream in(make_trace(5));
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_TRUE(source.read_chunk(chunk, 3));
+  ASSERT_EQ(3, chunk.size());
+}
+
+
+TEST(TextAddressSource, ReadChunk_LargeInput) {
+  // Records straddle the boundaries between the blocks read from the stream.
+  const size_t num_accesses = TextAddressSource::BUFFER_SIZE / 5;
+  istringstream in(make_trace(num_accesses));
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(source.read_chunk(chunk, num_accesses + 1));
+  ASSERT_EQ(num_accesses, chunk.size());
+  for (size_t i = 0; i < num_accesses; i++) {
+    ASSERT_EQ(i % 3, chunk[i].process_id);
+    ASSERT_EQ((i % 65536) & VirtualAddress::OFFSET_BITMASK, chunk[i].offset);
+  }
+}
+
+
+TEST(TextAddressSource, ReadChunk_IrregularWhitespace) {
+  istringstream in("  12\t0000000001000010\r\n\n3\n1111111111111111");
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(source.read_chunk(chunk, 10));
+  ASSERT_EQ(2, chunk.size());
+  ASSERT_EQ(12, chunk[0].process_id);
+  ASSERT_EQ(3, chunk[1].process_id);
+  ASSERT_EQ(1023, chunk[1].page);
+}
+
+
+TEST(TextAddressSource, ReadChunk_AccessType) {
+  istringstream in("1 0000000001000010 W\n1 0000000001000010\n7 1111111111111111 R\n7 0000000000000000\tw");
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(source.read_chunk(chunk, 10));
+  ASSERT_EQ(4, chunk.size());
+  ASSERT_TRUE(chunk[0].write);
+  ASSERT_FALSE(chunk[1].write);
+  ASSERT_FALSE(chunk[2].write);
+  ASSERT_EQ(7, chunk[2].process_id);
+  ASSERT_EQ(1023, chunk[2].page);
+  ASSERT_TRUE(chunk[3].write);
+}
+
+
+TEST(TextAddressSource, ReadChunk_AccessTypeAcrossBuffers) {
+  // records whose access type lands on every position around a buffer boundary
+  stringstream trace;
+  size_t num_accesses = TextAddressSource::BUFFER_SIZE / 10;
+  for (size_t i = 0; i < num_accesses; i++) {
+    trace << (i % 3) << " " << bitset<VirtualAddress::ADDRESS_BITS>(i) << (i % 2 ? " W" : "") << "\n";
+  }
+  istringstream in(trace.str());
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(source.read_chunk(chunk, num_accesses + 1));
+  ASSERT_EQ(num_accesses, chunk.size());
+  for (size_t i = 0; i < num_accesses; i++) {
+    ASSERT_EQ(i % 3, chunk[i].process_id);
+    ASSERT_EQ(i % 2 == 1, chunk[i].write);
+  }
+}
+
+
+TEST(TextAddressSource, ReadChunk_MalformedPidEndsTrace) {
+  istringstream in("1 0000000001000010\nx 0000000001000010\n");
+  TextAddressSource source(in);
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(source.read_chunk(chunk, 10));
+  ASSERT_EQ(1, chunk.size());
+}
+
+
+TEST(AddressStream, EmptyInput) {
+  istringstream in("");
+  AddressStream stream(unique_ptr<AddressSource>(new TextAddressSource(in)));
+  vector<VirtualAddress> chunk;
+
+  ASSERT_FALSE(stream.next_chunk(chunk));
+}
+
+
+TEST(AddressStream, PreservesOrder) {
+  // Many more addresses than fit in the ring at once.
+  const size_t num_accesses = AddressStream::CHUNK_SIZE * AddressStream::NUM_CHUNKS * 3 + 17;
+  istringstream in(make_trace(num_accesses));
+  AddressStream stream(unique_ptr<AddressSource>(new TextAddressSource(in)));
+  vector<VirtualAddress> chunk;
+
+  size_t seen = 0;
+  while (stream.next_chunk(chunk)) {
+    ASSERT_LE(chunk.size(), AddressStream::CHUNK_SIZE);
+    for (const VirtualAddress& address : chunk) {
+      ASSERT_EQ(seen % 3, address.process_id);
+      ASSERT_EQ((seen % 65536) >> VirtualAddress::OFFSET_BITS, address.page);
+      seen++;
+    }
+  }
+
+  ASSERT_EQ(num_accesses, seen);
+}
+
+
+TEST(AddressStream, RethrowsAfterDraining) {
+  istringstream in("1 0000000001000010\n2 0000\n3 0000000001000010\n");
+  AddressStream stream(unique_ptr<AddressSource>(new TextAddressSource(in)));
+  vector<VirtualAddress> chunk;
+
+  ASSERT_TRUE(stream.next_chunk(chunk));
+  ASSERT_EQ(1, chunk.size());
+  ASSERT_THROW(stream.next_chunk(chunk), out_of_range);
+}
+
+
+TEST(AddressStream, StopsEarly) {
+  // Destroying the stream before draining it must not hang.
+  istringstream in(make_trace(AddressStream::CHUNK_SIZE * AddressStream::NUM_CHUNKS * 2));
+  AddressStream stream(unique_ptr<AddressSource>(new TextAddressSource(in)));
+  vector<VirtualAddress> chunk;
+
+  ASSERT_TRUE(stream.next_chunk(chunk));
+}
@@ -0,0 +1,268 @@
+/**
+ * This file contains implementations for reading and writing the binary trace
+ * format.
+ */
+
+#include "binary_trace/binary_trace.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const char BinaryTraceHeader::MAGIC[8] = {'M', 'E', 'M', 'S', 'I', 'M', 'T', 'R'};
+const uint16_t BinaryTraceHeader::VERSION;
+
+// The mask for a full address.
+static const int64_t ADDRESS_MASK = (1 << VirtualAddress::ADDRESS_BITS) - 1;
+
+
+/**
+ * Zigzag encoding maps small negative and positive numbers to small unsigned
+ * ones: 0, -1, 1, -2, 2, ... become 0, 1, 2, 3, 4, ...
+ */
+static uint64_t zigzag_encode(int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+
+/**
+ * Appends value to out as a varint.
+ */
+static void write_varint(ostream& out, uint64_t value) {
+    char bytes[10];
+    size_t count = 0;
+    while (value >= 0x80) {
+        bytes[count++] = (char) (value | 0x80);
+        value >>= 7;
+    }
+    bytes[count++] = (char) value;
+    out.write(bytes, count);
+}
+
+
+/**
+ * Appends a fixed-width little-endian integer to out.
+ */
+template <typename Integer>
+static void write_fixed(ostream& out, Integer value) {
+    char bytes[sizeof(Integer)];
+    for (size_t i = 0; i < sizeof(Integer); i++) {
+        bytes[i] = (char) ((uint64_t) value >> (8 * i));
+    }
+    out.write(bytes, sizeof(Integer));
+}
+
+
+/**
+ * Reads a fixed-width little-endian integer at data + position, advancing the
+ * position past it.
+ */
+template <typename Integer>
+static Integer read_fixed(const char* data, size_t size, size_t& position) {
+    if (position > size || size - position < sizeof(Integer)) {
+        throw runtime_error("binary trace header is truncated");
+    }
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(Integer); i++) {
+        value |= (uint64_t) (unsigned char) data[position + i] << (8 * i);
+    }
+    position += sizeof(Integer);
+    return (Integer) value;
+}
+
+
+bool BinaryTraceHeader::has_magic(const char* data, size_t size) {
+    return size >= sizeof(MAGIC) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+
+size_t BinaryTraceHeader::read(const char* data, size_t size) {
+    if (!has_magic(data, size)) {
+        throw runtime_error("not a binary trace");
+    }
+    size_t position = sizeof(MAGIC);
+
+    this->version = read_fixed<uint16_t>(data, size, position);
+    if (this->version < 1 || this->version > VERSION) {
+        throw runtime_error("unsupported binary trace version " + to_string(this->version));
+    }
+
+    this->page_bits = read_fixed<uint8_t>(data, size, position);
+    this->offset_bits = read_fixed<uint8_t>(data, size, position);
+    if (this->page_bits != VirtualAddress::PAGE_BITS || this->offset_bits != VirtualAddress::OFFSET_BITS) {
+        throw runtime_error("binary trace was written for " + to_string(this->page_bits)
+            + " page bits and " + to_string(this->offset_bits) + " offset bits");
+    }
+
+    uint32_t num_processes = read_fixed<uint32_t>(data, size, position);
+    this->processes.clear();
+    for (uint32_t i = 0; i < num_processes; i++) {
+        int pid = read_fixed<int32_t>(data, size, position);
+        uint32_t length = read_fixed<uint32_t>(data, size, position);
+        if (size - position < length) {
+            throw runtime_error("binary trace header is truncated");
+        }
+
+        this->processes.emplace_back(pid, string(data + position, length));
+        position += length;
+    }
+
+    return position;
+}
+
+
+void BinaryTraceHeader::write(ostream& out) const {
+    out.write(MAGIC, sizeof(MAGIC));
+    write_fixed<uint16_t>(out, this->version);
+    write_fixed<uint8_t>(out, this->page_bits);
+    write_fixed<uint8_t>(out, this->offset_bits);
+
+    write_fixed<uint32_t>(out, this->processes.size());
+    for (auto& process : this->processes) {
+        write_fixed<int32_t>(out, process.first);
+        write_fixed<uint32_t>(out, process.second.size());
+        out.write(process.second.data(), process.second.size());
+    }
+}
+
+
+BinaryTraceWriter::BinaryTraceWriter(ostream& out, const BinaryTraceHeader& header) : out(out) {
+    header.write(out);
+}
+
+
+void BinaryTraceWriter::write(const VirtualAddress& address) {
+    int64_t full_address = (address.page << VirtualAddress::OFFSET_BITS) | address.offset;
+    int64_t& previous = this->last_address[address.process_id];
+    bool pid_changed = (address.process_id != this->last_pid);
+
+    write_varint(this->out, (zigzag_encode(full_address - previous) << 2)
+        | (address.write ? 2 : 0) | (pid_changed ? 1 : 0));
+    if (pid_changed) {
+        write_varint(this->out, zigzag_encode(address.process_id));
+    }
+
+    previous = full_address;
+    this->last_pid = address.process_id;
+}
+
+
+bool BinaryAddressSource::read_chunk(vector<VirtualAddress>& chunk, size_t max_count) {
+    if (this->current_address == nullptr) {
+        this->current_address = &this->last_address[this->last_pid];
+    }
+
+    size_t size = this->file->size();
+    for (size_t i = 0; i < max_count; i++) {
+        if (this->position >= size) {
+            return false;
+        }
+
+        uint64_t record = read_varint();
+        if (record & 1) {
+            // only look the process up when it changes
+            this->last_pid = (int) zigzag_decode(read_varint());
+            this->current_address = &this->last_address[this->last_pid];
+        }
+
+        bool write = false;
+        if (this->has_write_bit) {
+            write = (record & 2) != 0;
+            record >>= 1;
+        }
+
+        int64_t full_address = *this->current_address + zigzag_decode(record >> 1);
+        if (full_address < 0 || full_address > ADDRESS_MASK) {
+            throw runtime_error("binary trace record decodes to an invalid address");
+        }
+        *this->current_address = full_address;
+
+        chunk.emplace_back(this->last_pid,
+            (full_address & VirtualAddress::PAGE_BITMASK) >> VirtualAddress::OFFSET_BITS,
+            full_address & VirtualAddress::OFFSET_BITMASK, write);
+    }
+    return true;
+}
+
+
+uint64_t BinaryAddressSource::read_varint() {
+    const char* data = this->file->data();
+    size_t size = this->file->size();
+
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (this->position >= size) {
+            throw runtime_error("binary trace ends in the middle of a record");
+        }
+
+        unsigned char byte = data[this->position++];
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw runtime_error("binary trace record is too long");
+}
+
+
+int convert_trace(const string& input_path, const string& output_path) {
+    ifstream in(input_path);
+    if (!in) {
+        cerr << "Unable to open file: " << input_path << endl;
+        return 1;
+    }
+
+    // copy the processes over as-is; their images are only read when simulating
+    BinaryTraceHeader header;
+    int num_processes;
+    in >> num_processes;
+    for (int i = 0; i < num_processes; i++) {
+        int pid;
+        string process_image_path;
+        if (!(in >> pid >> process_image_path)) {
+            cerr << "Error reading processes." << endl;
+            return 1;
+        }
+        header.processes.emplace_back(pid, process_image_path);
+    }
+
+    ofstream out(output_path, ios::binary);
+    if (!out) {
+        cerr << "Unable to open file: " << output_path << endl;
+        return 1;
+    }
+
+    BinaryTraceWriter writer(out, header);
+    TextAddressSource source(in);
+    vector<VirtualAddress> chunk;
+    chunk.reserve(AddressStream::CHUNK_SIZE);
+
+    try {
+        bool more = true;
+        while (more) {
+            chunk.clear();
+            more = source.read_chunk(chunk, AddressStream::CHUNK_SIZE);
+            for (const VirtualAddress& address : chunk) {
+                writer.write(address);
+            }
+        }
+    } catch (const exception& except) {
+        cerr << "Error reading virtual addresses." << endl;
+        cerr << except.what() << endl;
+        return 1;
+    }
+
+    if (!out.flush()) {
+        cerr << "Error writing file: " << output_path << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * This file contains the definitions for reading and writing the binary trace
+ * format.
+ *
+ * A binary trace holds the same information as the text simulation file, much
+ * more compactly. All integers are little-endian.
+ *
+ *   magic        8 bytes, "MEMSIMTR"
+ *   version      uint16
+ *   page bits    uint8, must match VirtualAddress::PAGE_BITS
+ *   offset bits  uint8, must match VirtualAddress::OFFSET_BITS
+ *   processes    uint32 count, then per process: int32 PID, uint32 path
+ *                length, and the path to its image (not null-terminated)
+ *   records      one per access, up to the end of the file
+ *
+ * Each record is a varint (LEB128) holding the zigzag-encoded difference from
+ * the previous address accessed by the same process, shifted left by two. Bit
+ * 1 is set for a write. The low bit is set when the PID differs from that of
+ * the previous record, in which case the zigzag-encoded PID follows as another
+ * varint. Sequential and local accesses therefore take a single byte.
+ *
+ * Version 1 records have no write bit (the difference is shifted left by one),
+ * and every access in them is a read.
+ */
+
+#pragma once
+#include "address_stream/address_stream.h"
+#include "mapped_file/mapped_file.h"
+#include "virtual_address/virtual_address.h"
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/**
+ * The header of a binary trace.
+ */
+struct BinaryTraceHeader {
+
+    /**
+    * The magic bytes every binary trace starts with.
+    */
+    static const char MAGIC[8];
+
+    /**
+    * The current version of the format.
+    */
+    static const uint16_t VERSION = 2;
+
+    /**
+    * The version of the format the trace was written in.
+    */
+    uint16_t version = VERSION;
+
+    /**
+    * The address layout the trace was written with.
+    */
+    uint8_t page_bits = VirtualAddress::PAGE_BITS;
+    uint8_t offset_bits = VirtualAddress::OFFSET_BITS;
+
+    /**
+    * The PID and image path of every process.
+    */
+    std::vector<std::pair<int, std::string>> processes;
+
+    /**
+    * Returns true if the given bytes start with the magic bytes.
+    */
+    static bool has_magic(const char* data, size_t size);
+
+    /**
+    * Parses the header at the start of the given bytes, returning the offset of
+    * the first record. Throws std::runtime_error if the header is malformed or
+    * was written for an unknown version or a different address layout.
+    */
+    size_t read(const char* data, size_t size);
+
+    /**
+    * Writes this header to the given stream.
+    */
+    void write(std::ostream& out) const;
+};
+
+
+/**
+ * Writes access records in the binary trace format, after the header.
+ */
+class BinaryTraceWriter {
+public:
+
+    /**
+    * Constructor. Writes the header to the stream, which must outlive this
+    * writer.
+    */
+    BinaryTraceWriter(std::ostream& out, const BinaryTraceHeader& header);
+
+    /**
+    * Appends a record for the given access.
+    */
+    void write(const VirtualAddress& address);
+
+private:
+
+    /**
+    * The stream records are written to.
+    */
+    std::ostream& out;
+
+    /**
+    * The PID of the previous record.
+    */
+    int last_pid = 0;
+
+    /**
+    * The last address accessed by each process.
+    */
+    std::unordered_map<int, int64_t> last_address;
+};
+
+
+/**
+ * Reads access records from a memory-mapped binary trace.
+ */
+class BinaryAddressSource : public AddressSource {
+public:
+
+    /**
+    * Constructor. Records are decoded from the given offset of the file, in
+    * the given version of the format.
+    */
+    BinaryAddressSource(std::shared_ptr<MappedFile> file, size_t offset,
+            uint16_t version = BinaryTraceHeader::VERSION)
+        : file(file), position(offset), has_write_bit(version >= 2) {}
+
+    bool read_chunk(std::vector<VirtualAddress>& chunk, size_t max_count) override;
+
+private:
+
+    /**
+    * Decodes the varint at the current position. Throws std::runtime_error if
+    * the file ends in the middle of it.
+    */
+    uint64_t read_varint();
+
+    /**
+    * The mapped trace.
+    */
+    std::shared_ptr<MappedFile> file;
+
+    /**
+    * The offset of the next record.
+    */
+    size_t position;
+
+    /**
+    * True if the records carry a write bit.
+    */
+    bool has_write_bit;
+
+    /**
+    * The PID of the previous record.
+    */
+    int last_pid = 0;
+
+    /**
+    * The last address accessed by each process, and that of last_pid.
+    */
+    std::unordered_map<int, int64_t> last_address;
+    int64_t* current_address = nullptr;
+};
+
+
+/**
+ * Converts the text simulation file at input_path into a binary trace at
+ * output_path. Returns nonzero (after printing why) on failure.
+ */
+int convert_trace(const std::string& input_path, const std::string& output_path);
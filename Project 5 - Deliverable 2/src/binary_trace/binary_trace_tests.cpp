@@ -0,0 +1,170 @@
+/**
+ * This file contains tests for the binary trace format.
+ */
+
+#include "binary_trace/binary_trace.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace std;
+
+
+/**
+ * Writes the given bytes to a temporary file and maps it.
+ */
+shared_ptr<MappedFile> map_bytes(const string& bytes) {
+  char path[] = "/tmp/binary_trace_testXXXXXX";
+  close(mkstemp(path));
+  {
+    ofstream out(path, ios::binary);
+    out << bytes;
+  }
+
+  shared_ptr<MappedFile> file = MappedFile::open(path);
+  remove(path);
+  return file;
+}
+
+
+/**
+ * Reads every address out of the given binary trace.
+ */
+vector<VirtualAddress> read_all(const string& bytes) {
+  shared_ptr<MappedFile> file = map_bytes(bytes);
+  BinaryTraceHeader header;
+  size_t offset = header.read(file->data(), file->size());
+  BinaryAddressSource source(file, offset, header.version);
+
+  vector<VirtualAddress> addresses;
+  while (source.read_chunk(addresses, 100)) {
+  }
+  return addresses;
+}
+
+
+TEST(BinaryTrace, HeaderRoundTrip) {
+  BinaryTraceHeader header;
+  header.processes = {{1, "images/one"}, {-7, "images/seven"}};
+
+  stringstream out;
+  header.write(out);
+  string bytes = out.str();
+
+  BinaryTraceHeader read_back;
+  ASSERT_TRUE(BinaryTraceHeader::has_magic(bytes.data(), bytes.size()));
+  ASSERT_EQ(bytes.size(), read_back.read(bytes.data(), bytes.size()));
+  ASSERT_EQ(header.processes, read_back.processes);
+}
+
+
+TEST(BinaryTrace, HasMagic_TextFile) {
+  string text = "2\n1 images/one\n";
+
+  ASSERT_FALSE(BinaryTraceHeader::has_magic(text.data(), text.size()));
+  ASSERT_FALSE(BinaryTraceHeader::has_magic("MEMS", 4));
+}
+
+
+TEST(BinaryTrace, Header_WrongVersion) {
+  BinaryTraceHeader header;
+  header.version = BinaryTraceHeader::VERSION + 1;
+
+  stringstream out;
+  header.write(out);
+  string bytes = out.str();
+
+  BinaryTraceHeader read_back;
+  ASSERT_THROW(read_back.read(bytes.data(), bytes.size()), runtime_error);
+}
+
+
+TEST(BinaryTrace, Header_WrongLayout) {
+  BinaryTraceHeader header;
+  header.offset_bits = VirtualAddress::OFFSET_BITS + 6;
+
+  stringstream out;
+  header.write(out);
+  string bytes = out.str();
+
+  BinaryTraceHeader read_back;
+  ASSERT_THROW(read_back.read(bytes.data(), bytes.size()), runtime_error);
+}
+
+
+TEST(BinaryTrace, RecordsRoundTrip) {
+  mt19937 random(5);
+  vector<VirtualAddress> addresses;
+  for (int i = 0; i < 5000; i++) {
+    int pid = (i / 7) % 3 == 0 ? 12 : -4;
+    addresses.emplace_back(pid, random() % 1024, random() % 64, random() % 4 == 0);
+  }
+  addresses.emplace_back(0, 1023, 63);
+  addresses.emplace_back(0, 0, 0);
+
+  stringstream out;
+  BinaryTraceWriter writer(out, BinaryTraceHeader());
+  for (const VirtualAddress& address : addresses) {
+    writer.write(address);
+  }
+
+  vector<VirtualAddress> read_back = read_all(out.str());
+  ASSERT_EQ(addresses.size(), read_back.size());
+  for (size_t i = 0; i < addresses.size(); i++) {
+    ASSERT_EQ(addresses[i].process_id, read_back[i].process_id);
+    ASSERT_EQ(addresses[i].page, read_back[i].page);
+    ASSERT_EQ(addresses[i].offset, read_back[i].offset);
+    ASSERT_EQ(addresses[i].write, read_back[i].write);
+  }
+}
+
+
+TEST(BinaryTrace, ReadsVersion1) {
+  // a version 1 trace of process 5 reading 0x0042 and then 0x0041
+  BinaryTraceHeader header;
+  header.version = 1;
+  header.processes = {{5, "images/five"}};
+
+  stringstream out;
+  header.write(out);
+  out << (char) 0x89 << (char) 0x02 << (char) 0x0A;
+  out << (char) 0x02;
+
+  vector<VirtualAddress> read_back = read_all(out.str());
+  ASSERT_EQ(2, read_back.size());
+  ASSERT_EQ(5, read_back[0].process_id);
+  ASSERT_EQ(1, read_back[0].page);
+  ASSERT_EQ(2, read_back[0].offset);
+  ASSERT_FALSE(read_back[0].write);
+  ASSERT_EQ(1, read_back[1].offset);
+  ASSERT_FALSE(read_back[1].write);
+}
+
+
+TEST(BinaryTrace, SequentialRecordsTakeOneByte) {
+  stringstream out;
+  BinaryTraceWriter writer(out, BinaryTraceHeader());
+  size_t header_size = out.str().size();
+
+  for (int i = 0; i < 1000; i++) {
+    writer.write(VirtualAddress(0, i / 64, i % 64));
+  }
+
+  ASSERT_EQ(header_size + 1000, out.str().size());
+}
+
+
+TEST(BinaryTrace, TruncatedRecord) {
+  stringstream out;
+  BinaryTraceWriter writer(out, BinaryTraceHeader());
+  writer.write(VirtualAddress(3, 1000, 1));
+  string bytes = out.str();
+  bytes.pop_back();
+
+  ASSERT_THROW(read_all(bytes), runtime_error);
+}
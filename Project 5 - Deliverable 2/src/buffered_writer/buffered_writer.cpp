@@ -0,0 +1,55 @@
+/**
+ * This file contains implementations for methods in the BufferedWriter class.
+ */
+
+#include "buffered_writer/buffered_writer.h"
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t BufferedWriter::DEFAULT_CAPACITY;
+
+
+BufferedWriter::BufferedWriter(ostream& out, size_t capacity) : out(out), capacity(capacity) {
+    this->buffer.reserve(capacity);
+}
+
+
+BufferedWriter::~BufferedWriter() {
+    this->flush();
+}
+
+
+void BufferedWriter::write(const char* bytes, size_t size) {
+    if (this->buffer.size() + size > this->capacity && !this->buffer.empty()) {
+        this->out.write(this->buffer.data(), this->buffer.size());
+        this->buffer.clear();
+        this->writes++;
+    }
+    this->buffer.append(bytes, size);
+}
+
+
+void BufferedWriter::write(const string& text) {
+    this->write(text.data(), text.size());
+}
+
+
+void BufferedWriter::flush() {
+    if (!this->buffer.empty()) {
+        this->out.write(this->buffer.data(), this->buffer.size());
+        this->buffer.clear();
+        this->writes++;
+    }
+    this->out.flush();
+}
+
+
+size_t BufferedWriter::get_buffered() const {
+    return this->buffer.size();
+}
+
+
+size_t BufferedWriter::get_writes() const {
+    return this->writes;
+}
@@ -0,0 +1,89 @@
+/**
+ * This file contains the definition of the BufferedWriter class.
+ */
+
+#pragma once
+#include <cstdlib>
+#include <ostream>
+#include <string>
+
+
+/**
+ * Collects output in a buffer of its own and hands it to a stream in large
+ * blocks, so that writing many short lines (a row per process per window,
+ * say) costs a few large writes rather than one per line.
+ *
+ * Whatever is left in the buffer is written out by flush() or when the
+ * writer is destroyed.
+ */
+class BufferedWriter {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The default size of the buffer, in bytes.
+    */
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor, for a writer buffering up to capacity bytes at a time
+    * before writing them to out.
+    */
+    BufferedWriter(std::ostream& out, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+    * Destructor. Flushes the buffer.
+    */
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /**
+    * Appends the given bytes, writing the buffer out first if they would not
+    * fit in it.
+    */
+    void write(const char* bytes, size_t size);
+    void write(const std::string& text);
+
+    /**
+    * Writes out everything buffered, and flushes the stream.
+    */
+    void flush();
+
+    /**
+    * Returns the number of bytes waiting in the buffer.
+    */
+    size_t get_buffered() const;
+
+    /**
+    * Returns the number of times the buffer was written to the stream.
+    */
+    size_t get_writes() const;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The stream written to.
+    */
+    std::ostream& out;
+
+    /**
+    * The size the buffer is written out at.
+    */
+    size_t capacity;
+
+    /**
+    * The bytes not yet written.
+    */
+    std::string buffer;
+
+    /**
+    * The number of times the buffer was written out.
+    */
+    size_t writes = 0;
+};
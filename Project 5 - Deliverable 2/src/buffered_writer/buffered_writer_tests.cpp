@@ -0,0 +1,52 @@
+/**
+ * This file contains tests for the BufferedWriter class.
+ */
+
+#include "buffered_writer/buffered_writer.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+using namespace std;
+
+
+TEST(BufferedWriter, HoldsOutputUntilFlushed) {
+  ostringstream out;
+  BufferedWriter writer(out, 16);
+
+  writer.write("abc\n");
+  writer.write("def\n");
+  ASSERT_EQ("", out.str());
+  ASSERT_EQ(8, writer.get_buffered());
+
+  writer.flush();
+  ASSERT_EQ("abc\ndef\n", out.str());
+  ASSERT_EQ(0, writer.get_buffered());
+  ASSERT_EQ(1, writer.get_writes());
+}
+
+
+TEST(BufferedWriter, WritesOutWhenFull) {
+  ostringstream out;
+  BufferedWriter writer(out, 8);
+
+  writer.write("12345");
+  writer.write("6789");
+  ASSERT_EQ("12345", out.str());
+  ASSERT_EQ(4, writer.get_buffered());
+
+  // more than the whole buffer still goes through in order
+  writer.write("abcdefghijkl");
+  ASSERT_EQ("123456789", out.str());
+  writer.flush();
+  ASSERT_EQ("123456789abcdefghijkl", out.str());
+}
+
+
+TEST(BufferedWriter, FlushesWhenDestroyed) {
+  ostringstream out;
+  {
+    BufferedWriter writer(out);
+    writer.write(string("left over"));
+  }
+  ASSERT_EQ("left over", out.str());
+}
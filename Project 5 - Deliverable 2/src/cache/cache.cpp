@@ -0,0 +1,197 @@
+/**
+ * This file contains implementations for methods in the Cache and
+ * CacheHierarchy classes.
+ */
+
+#include "cache/cache.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t Cache::NONE;
+const uint64_t Cache::EMPTY;
+
+
+Cache::Cache(size_t size, size_t line_size, size_t ways, Policy policy)
+    : num_sets(size / line_size / ways), ways(ways), policy(policy),
+      tags(size / line_size, EMPTY), stamps(size / line_size, 0)
+{
+    assert(line_size > 0 && (line_size & (line_size - 1)) == 0 && this->num_sets > 0);
+    while ((size_t(1) << this->line_bits) < line_size) {
+        this->line_bits++;
+    }
+}
+
+
+bool Cache::access(uint64_t address) {
+    uint64_t line = address >> this->line_bits;
+    size_t set = line % this->num_sets;
+    size_t first = set * this->ways;
+    size_t way = find(set, line);
+    this->clock++;
+
+    if (way != NONE) {
+        if (this->policy == Policy::LRU) {
+            this->stamps[first + way] = this->clock;
+        }
+        this->hits++;
+        return true;
+    }
+    this->misses++;
+
+    // fill an empty line if there is one, or else replace one
+    way = find(set, EMPTY);
+    if (way == NONE) {
+        if (this->policy == Policy::RANDOM) {
+            // xorshift64
+            this->random_state ^= this->random_state << 13;
+            this->random_state ^= this->random_state >> 7;
+            this->random_state ^= this->random_state << 17;
+            way = this->random_state % this->ways;
+        } else {
+            // the oldest stamp was used (LRU) or filled (FIFO) longest ago
+            way = min_element(this->stamps.begin() + first, this->stamps.begin() + first + this->ways)
+                - (this->stamps.begin() + first);
+        }
+        this->evictions++;
+    }
+
+    this->tags[first + way] = line;
+    this->stamps[first + way] = this->clock;
+    return false;
+}
+
+
+void Cache::invalidate(uint64_t address, size_t bytes) {
+    uint64_t last = (address + bytes - 1) >> this->line_bits;
+    for (uint64_t line = address >> this->line_bits; line <= last; line++) {
+        size_t set = line % this->num_sets;
+        size_t way = find(set, line);
+        if (way != NONE) {
+            this->tags[set * this->ways + way] = EMPTY;
+            this->invalidations++;
+        }
+    }
+}
+
+
+size_t Cache::get_line_count() const {
+    return this->tags.size() - count(this->tags.begin(), this->tags.end(), EMPTY);
+}
+
+
+size_t Cache::find(size_t set, uint64_t line) const {
+    const uint64_t* first = &this->tags[set * this->ways];
+
+    for (size_t way = 0; way < this->ways; way++) {
+        if (first[way] == line) {
+            return way;
+        }
+    }
+    return NONE;
+}
+
+
+CacheHierarchy::CacheHierarchy(const vector<Level>& levels, size_t line_size, Cache::Policy policy,
+        double memory_latency)
+    : levels(levels), memory_latency(memory_latency),
+      hits_by_asid(levels.size()), misses_by_asid(levels.size())
+{
+    for (const Level& level : levels) {
+        this->caches.emplace_back(level.size, line_size, level.ways, policy);
+    }
+}
+
+
+size_t CacheHierarchy::access(size_t asid, uint64_t address) {
+    if (!this->levels.empty() && asid >= this->hits_by_asid[0].size()) {
+        for (size_t level = 0; level < this->levels.size(); level++) {
+            this->hits_by_asid[level].resize(asid + 1, 0);
+            this->misses_by_asid[level].resize(asid + 1, 0);
+        }
+    }
+
+    for (size_t level = 0; level < this->levels.size(); level++) {
+        if (this->caches[level].access(address)) {
+            this->hits_by_asid[level][asid]++;
+            return level;
+        }
+        this->misses_by_asid[level][asid]++;
+    }
+    return this->levels.size();
+}
+
+
+void CacheHierarchy::invalidate(uint64_t address, size_t bytes) {
+    for (Cache& cache : this->caches) {
+        cache.invalidate(address, bytes);
+    }
+}
+
+
+size_t CacheHierarchy::get_level_count() const {
+    return this->levels.size();
+}
+
+
+const string& CacheHierarchy::get_name(size_t level) const {
+    return this->levels[level].name;
+}
+
+
+const Cache& CacheHierarchy::get_cache(size_t level) const {
+    return this->caches[level];
+}
+
+
+size_t CacheHierarchy::get_hits(size_t level, size_t asid) const {
+    const vector<size_t>& hits = this->hits_by_asid[level];
+    return asid < hits.size() ? hits[asid] : 0;
+}
+
+
+size_t CacheHierarchy::get_misses(size_t level, size_t asid) const {
+    const vector<size_t>& misses = this->misses_by_asid[level];
+    return asid < misses.size() ? misses[asid] : 0;
+}
+
+
+/**
+ * Returns the average access time for the given lookups of each level: every
+ * lookup of a level costs its hit time, and every miss of the last level a
+ * trip to memory.
+ */
+static double average_time(const vector<CacheHierarchy::Level>& levels, const vector<size_t>& lookups,
+        size_t memory_accesses, double memory_latency) {
+    if (levels.empty() || lookups[0] == 0) {
+        return 0.0;
+    }
+
+    double time = memory_accesses * memory_latency;
+    for (size_t level = 0; level < levels.size(); level++) {
+        time += lookups[level] * levels[level].latency;
+    }
+    return time / lookups[0];
+}
+
+
+double CacheHierarchy::get_amat(size_t asid) const {
+    vector<size_t> lookups;
+    for (size_t level = 0; level < this->levels.size(); level++) {
+        lookups.push_back(this->get_hits(level, asid) + this->get_misses(level, asid));
+    }
+    size_t memory_accesses = this->levels.empty() ? 0 : this->get_misses(this->levels.size() - 1, asid);
+    return average_time(this->levels, lookups, memory_accesses, this->memory_latency);
+}
+
+
+double CacheHierarchy::get_amat() const {
+    vector<size_t> lookups;
+    for (const Cache& cache : this->caches) {
+        lookups.push_back(cache.hits + cache.misses);
+    }
+    size_t memory_accesses = this->caches.empty() ? 0 : this->caches.back().misses;
+    return average_time(this->levels, lookups, memory_accesses, this->memory_latency);
+}
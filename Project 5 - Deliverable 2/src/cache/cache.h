@@ -0,0 +1,205 @@
+/**
+ * This file contains the definitions of the Cache and CacheHierarchy classes.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+
+/**
+ * One level of a set-associative CPU cache, caching lines of physical memory.
+ *
+ * Like the TLB, the sets are laid out one after another in flat arrays of
+ * tags and replacement stamps, with no object per line, so a lookup only
+ * reads a few adjacent words. Only which lines are cached is modelled, not
+ * their contents; a miss always fills the line.
+ */
+class Cache {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The way reported when there is none.
+    */
+    static const size_t NONE = -1;
+
+    /**
+    * The policies for choosing which line of a full set to replace.
+    */
+    enum class Policy {
+        LRU,
+        FIFO,
+        RANDOM
+    };
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. line_size must be a power of two, and size a positive
+    * multiple of line_size * ways.
+    */
+    Cache(size_t size, size_t line_size, size_t ways, Policy policy);
+
+    /**
+    * Looks up the line holding the given physical address, returning true on
+    * a hit. On a miss the line is brought in, replacing a line of its set if
+    * it is full.
+    */
+    bool access(uint64_t address);
+
+    /**
+    * Drops every cached line overlapping the given bytes (as when the frame
+    * holding them is given a new page).
+    */
+    void invalidate(uint64_t address, size_t bytes);
+
+    /**
+    * Returns the number of lines currently cached.
+    */
+    size_t get_line_count() const;
+
+// CLASS INSTANCE VARIABLES
+public:
+
+    /**
+    * The number of lookups that hit and missed, of lines replaced to make
+    * room, and of lines dropped by invalidate().
+    */
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t invalidations = 0;
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Returns the way of the given set holding the given line, or NONE.
+    */
+    size_t find(size_t set, uint64_t line) const;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The tag of an empty line.
+    */
+    static const uint64_t EMPTY = -1;
+
+    /**
+    * The shape of the cache.
+    */
+    size_t line_bits = 0;
+    size_t num_sets;
+    size_t ways;
+    Policy policy;
+
+    /**
+    * For each line, set by set: the number of the line of memory it holds
+    * (its address over the line size), and when it was last used (LRU) or
+    * filled (FIFO).
+    */
+    std::vector<uint64_t> tags;
+    std::vector<size_t> stamps;
+
+    /**
+    * Advances on every lookup, to stamp lines with.
+    */
+    size_t clock = 0;
+
+    /**
+    * The state of the generator picking victims for the RANDOM policy.
+    */
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+};
+
+
+/**
+ * A hierarchy of caches in front of main memory, from L1 out to the last
+ * level. An access looks in each level in turn until one hits, and the line
+ * is brought into every level that missed on the way. Hits and misses are
+ * kept per level and per address space, for hit rates and the average
+ * memory access time (AMAT) of each process.
+ */
+class CacheHierarchy {
+// PUBLIC TYPES
+public:
+
+    /**
+    * The name, size in bytes, associativity and hit time (in nanoseconds) of
+    * a level.
+    */
+    struct Level {
+        std::string name;
+        size_t size;
+        size_t ways;
+        double latency;
+    };
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor, for the given levels (L1 first) sharing a line size and
+    * replacement policy, in front of memory taking memory_latency.
+    */
+    CacheHierarchy(const std::vector<Level>& levels, size_t line_size, Cache::Policy policy,
+        double memory_latency);
+
+    /**
+    * Accesses the given physical address on behalf of the given address
+    * space, and returns the level that hit, or get_level_count() if the
+    * access went all the way to memory.
+    */
+    size_t access(size_t asid, uint64_t address);
+
+    /**
+    * Drops the given bytes from every level.
+    */
+    void invalidate(uint64_t address, size_t bytes);
+
+    /**
+    * Returns the number of levels, and the given level's name and cache.
+    */
+    size_t get_level_count() const;
+    const std::string& get_name(size_t level) const;
+    const Cache& get_cache(size_t level) const;
+
+    /**
+    * Returns the number of lookups in the given level by the given address
+    * space that hit, and that missed.
+    */
+    size_t get_hits(size_t level, size_t asid) const;
+    size_t get_misses(size_t level, size_t asid) const;
+
+    /**
+    * Returns the average time, in nanoseconds, the given address space's
+    * accesses took, or that all of them did.
+    */
+    double get_amat(size_t asid) const;
+    double get_amat() const;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The levels, and their caches.
+    */
+    std::vector<Level> levels;
+    std::vector<Cache> caches;
+
+    /**
+    * The time an access that misses every level takes in memory.
+    */
+    double memory_latency;
+
+    /**
+    * Hits and misses of each level by ASID.
+    */
+    std::vector<std::vector<size_t>> hits_by_asid;
+    std::vector<std::vector<size_t>> misses_by_asid;
+};
@@ -0,0 +1,89 @@
+/**
+ * This file contains tests for the Cache and CacheHierarchy classes.
+ */
+
+#include "cache/cache.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(Cache, MissThenHit) {
+  Cache cache(256, 16, 4, Cache::Policy::LRU);
+
+  ASSERT_FALSE(cache.access(100));
+  ASSERT_TRUE(cache.access(100));
+
+  // the rest of the line was brought in too
+  ASSERT_TRUE(cache.access(96));
+  ASSERT_TRUE(cache.access(111));
+  ASSERT_FALSE(cache.access(112));
+
+  ASSERT_EQ(3, cache.hits);
+  ASSERT_EQ(2, cache.misses);
+  ASSERT_EQ(2, cache.get_line_count());
+}
+
+
+TEST(Cache, LruReplacement) {
+  // Two sets of two ways; even lines share set 0.
+  Cache cache(64, 16, 2, Cache::Policy::LRU);
+
+  cache.access(0 * 16);
+  cache.access(2 * 16);
+  ASSERT_TRUE(cache.access(0 * 16));
+  cache.access(4 * 16);
+
+  ASSERT_EQ(1, cache.evictions);
+  ASSERT_TRUE(cache.access(0 * 16));
+  ASSERT_TRUE(cache.access(4 * 16));
+  ASSERT_FALSE(cache.access(2 * 16));
+}
+
+
+TEST(Cache, FifoReplacement) {
+  Cache cache(64, 16, 2, Cache::Policy::FIFO);
+
+  cache.access(0 * 16);
+  cache.access(2 * 16);
+  ASSERT_TRUE(cache.access(0 * 16));
+  cache.access(4 * 16);
+
+  // the first line filled goes first, however recently it was used
+  ASSERT_FALSE(cache.access(0 * 16));
+}
+
+
+TEST(Cache, Invalidate) {
+  Cache cache(256, 16, 4, Cache::Policy::LRU);
+  for (uint64_t address = 0; address < 128; address += 16) {
+    cache.access(address);
+  }
+
+  cache.invalidate(64, 64);
+  ASSERT_EQ(4, cache.invalidations);
+  ASSERT_TRUE(cache.access(48));
+  ASSERT_FALSE(cache.access(64));
+}
+
+
+TEST(CacheHierarchy, FillsOnTheWayBack) {
+  CacheHierarchy caches({{"L1", 64, 2, 1.0}, {"L2", 256, 4, 4.0}}, 16, Cache::Policy::LRU, 100.0);
+  ASSERT_EQ(2, caches.get_level_count());
+
+  ASSERT_EQ(2, caches.access(0, 0));
+  ASSERT_EQ(0, caches.access(0, 0));
+
+  // push line 0 out of the L1 set, but not out of the L2
+  caches.access(1, 2 * 16);
+  caches.access(1, 4 * 16);
+  ASSERT_EQ(1, caches.access(0, 0));
+
+  ASSERT_EQ(1, caches.get_hits(0, 0));
+  ASSERT_EQ(2, caches.get_misses(0, 0));
+  ASSERT_EQ(1, caches.get_hits(1, 0));
+  ASSERT_EQ(0, caches.get_hits(0, 7));
+
+  // three L1 lookups, two L2 lookups and one trip to memory
+  ASSERT_DOUBLE_EQ((3 * 1.0 + 2 * 4.0 + 100.0) / 3, caches.get_amat(0));
+}
@@ -0,0 +1,74 @@
+/**
+ * This file contains implementations for methods in the ChunkQueue class.
+ */
+
+#include "chunk_queue/chunk_queue.h"
+
+using namespace std;
+
+// Ensure NUM_CHUNKS is initialized.
+const size_t ChunkQueue::NUM_CHUNKS;
+
+
+void TraceChunk::push_back(const VirtualAddress& address, size_t position) {
+    this->addresses.push_back(address);
+    this->positions.push_back(position);
+}
+
+
+void TraceChunk::clear() {
+    this->addresses.clear();
+    this->positions.clear();
+}
+
+
+size_t TraceChunk::size() const {
+    return this->addresses.size();
+}
+
+
+void ChunkQueue::push(TraceChunk& chunk) {
+    unique_lock<std::mutex> lock(this->mutex);
+    this->not_full.wait(lock, [this] { return this->count < NUM_CHUNKS; });
+
+    // swap the chunk into the next empty slot, handing back an empty one
+    TraceChunk& slot = this->ring[(this->head + this->count) % NUM_CHUNKS];
+    slot.addresses.swap(chunk.addresses);
+    slot.positions.swap(chunk.positions);
+    chunk.clear();
+    this->count++;
+
+    lock.unlock();
+    this->not_empty.notify_one();
+}
+
+
+bool ChunkQueue::pop(TraceChunk& chunk) {
+    unique_lock<std::mutex> lock(this->mutex);
+    this->not_empty.wait(lock, [this] { return this->count > 0 || this->closed; });
+
+    if (this->count == 0) {
+        return false;
+    }
+
+    // hand the full chunk out and keep the caller's old one to refill later
+    TraceChunk& slot = this->ring[this->head];
+    slot.addresses.swap(chunk.addresses);
+    slot.positions.swap(chunk.positions);
+    slot.clear();
+    this->head = (this->head + 1) % NUM_CHUNKS;
+    this->count--;
+
+    lock.unlock();
+    this->not_full.notify_one();
+    return true;
+}
+
+
+void ChunkQueue::close() {
+    {
+        lock_guard<std::mutex> lock(this->mutex);
+        this->closed = true;
+    }
+    this->not_empty.notify_all();
+}
@@ -0,0 +1,98 @@
+/**
+ * This file contains the definition of the ChunkQueue class, which hands runs
+ * of accesses from the thread reading the trace to a worker thread.
+ */
+
+#pragma once
+#include "virtual_address/virtual_address.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * A run of accesses, along with the position of each one in the whole trace.
+ */
+struct TraceChunk {
+    std::vector<VirtualAddress> addresses;
+    std::vector<size_t> positions;
+
+    /**
+    * Appends an access at the given position in the trace.
+    */
+    void push_back(const VirtualAddress& address, size_t position);
+
+    /**
+    * Removes every access, keeping the memory for reuse.
+    */
+    void clear();
+
+    /**
+    * Returns the number of accesses in the chunk.
+    */
+    size_t size() const;
+};
+
+
+/**
+ * A bounded, blocking single-producer single-consumer queue of chunks. Chunks
+ * are swapped in and out rather than copied, so their memory is recycled.
+ */
+class ChunkQueue {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The number of chunks the queue holds before push() blocks.
+    */
+    static const size_t NUM_CHUNKS = 8;
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor.
+    */
+    ChunkQueue() : ring(NUM_CHUNKS) {}
+
+    /**
+    * Moves the contents of the given chunk onto the queue, blocking while it
+    * is full, and leaves an empty chunk in its place.
+    */
+    void push(TraceChunk& chunk);
+
+    /**
+    * Replaces the contents of the given chunk with the oldest chunk on the
+    * queue, blocking while it is empty. Returns false once the queue has been
+    * closed and drained.
+    */
+    bool pop(TraceChunk& chunk);
+
+    /**
+    * Marks the end of the chunks, waking the consumer.
+    */
+    void close();
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The ring of chunks, of which count chunks starting at head are full.
+    */
+    std::vector<TraceChunk> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+    /**
+    * True once the producer has pushed its last chunk.
+    */
+    bool closed = false;
+
+    /**
+    * Guards the ring and the flag above.
+    */
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+};
@@ -0,0 +1,78 @@
+/**
+ * This file contains tests for the ChunkQueue class.
+ */
+
+#include "chunk_queue/chunk_queue.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace std;
+
+
+TEST(TraceChunk, PushBackAndClear) {
+  TraceChunk chunk;
+
+  chunk.push_back(VirtualAddress(1, 2, 3), 42);
+  ASSERT_EQ(1, chunk.size());
+  ASSERT_EQ(2, chunk.addresses[0].page);
+  ASSERT_EQ(42, chunk.positions[0]);
+
+  chunk.clear();
+  ASSERT_EQ(0, chunk.size());
+  ASSERT_EQ(0, chunk.positions.size());
+}
+
+
+TEST(ChunkQueue, ClosedEmpty) {
+  ChunkQueue queue;
+  TraceChunk chunk;
+
+  queue.close();
+  ASSERT_FALSE(queue.pop(chunk));
+}
+
+
+TEST(ChunkQueue, PushLeavesEmptyChunk) {
+  ChunkQueue queue;
+  TraceChunk chunk;
+
+  chunk.push_back(VirtualAddress(1, 2, 3), 0);
+  queue.push(chunk);
+  ASSERT_EQ(0, chunk.size());
+
+  ASSERT_TRUE(queue.pop(chunk));
+  ASSERT_EQ(1, chunk.size());
+}
+
+
+TEST(ChunkQueue, PreservesOrderAcrossThreads) {
+  // Many more chunks than fit in the queue at once.
+  const size_t num_chunks = ChunkQueue::NUM_CHUNKS * 4 + 3;
+  const size_t chunk_size = 100;
+  ChunkQueue queue;
+
+  thread producer([&] {
+    TraceChunk chunk;
+    for (size_t i = 0; i < num_chunks * chunk_size; i++) {
+      chunk.push_back(VirtualAddress(1, i % 1024, 0), i);
+      if (chunk.size() == chunk_size) {
+        queue.push(chunk);
+      }
+    }
+    queue.close();
+  });
+
+  TraceChunk chunk;
+  size_t seen = 0;
+  while (queue.pop(chunk)) {
+    ASSERT_EQ(chunk_size, chunk.size());
+    for (size_t i = 0; i < chunk.size(); i++) {
+      ASSERT_EQ(seen, chunk.positions[i]);
+      ASSERT_EQ(seen % 1024, chunk.addresses[i].page);
+      seen++;
+    }
+  }
+  producer.join();
+
+  ASSERT_EQ(num_chunks * chunk_size, seen);
+}
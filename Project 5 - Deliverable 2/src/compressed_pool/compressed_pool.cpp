@@ -0,0 +1,165 @@
+/**
+ * This file contains implementations for methods in the CompressedPool class.
+ */
+
+#include "compressed_pool/compressed_pool.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t CompressedPool::MIN_MATCH;
+const size_t CompressedPool::MAX_MATCH;
+const size_t CompressedPool::MAX_LITERALS;
+
+
+/**
+ * Appends the given literal bytes to the compressed output.
+ */
+static void push_literals(const char* bytes, size_t count, vector<uint8_t>& out) {
+    while (count > 0) {
+        size_t run = min(count, CompressedPool::MAX_LITERALS);
+        out.push_back(run - 1);
+        out.insert(out.end(), bytes, bytes + run);
+        bytes += run;
+        count -= run;
+    }
+}
+
+
+vector<uint8_t> CompressedPool::compress(const char* bytes, size_t size) {
+    vector<uint8_t> out;
+
+    // the last position each hash of three bytes was seen at
+    const size_t HASH_SIZE = 256;
+    vector<size_t> last_seen(HASH_SIZE, SIZE_MAX);
+
+    size_t literals = 0;
+    size_t i = 0;
+    while (i + MIN_MATCH <= size) {
+        size_t hash = ((unsigned char) bytes[i] * 33 * 33
+            + (unsigned char) bytes[i + 1] * 33 + (unsigned char) bytes[i + 2]) % HASH_SIZE;
+        size_t candidate = last_seen[hash];
+        last_seen[hash] = i;
+
+        if (candidate == SIZE_MAX || i - candidate > UINT16_MAX
+                || memcmp(bytes + candidate, bytes + i, MIN_MATCH) != 0) {
+            i++;
+            continue;
+        }
+
+        size_t length = MIN_MATCH;
+        while (i + length < size && length < MAX_MATCH && bytes[candidate + length] == bytes[i + length]) {
+            length++;
+        }
+
+        push_literals(bytes + literals, i - literals, out);
+        size_t distance = i - candidate;
+        out.push_back(0x80 | (length - MIN_MATCH));
+        out.push_back(distance & 0xFF);
+        out.push_back(distance >> 8);
+
+        i += length;
+        literals = i;
+    }
+
+    push_literals(bytes + literals, size - literals, out);
+    return out;
+}
+
+
+string CompressedPool::decompress(const vector<uint8_t>& compressed) {
+    string out;
+    size_t i = 0;
+    while (i < compressed.size()) {
+        uint8_t token = compressed[i++];
+        if (token < 0x80) {
+            out.append((const char*) &compressed[i], token + 1);
+            i += token + 1;
+        } else {
+            size_t length = (token & 0x7F) + MIN_MATCH;
+            size_t distance = compressed[i] | (compressed[i + 1] << 8);
+            i += 2;
+
+            // copy a byte at a time, since the match may overlap itself
+            for (size_t j = 0; j < length; j++) {
+                out.push_back(out[out.size() - distance]);
+            }
+        }
+    }
+    return out;
+}
+
+
+bool CompressedPool::store(uint64_t key, const char* bytes, size_t size, bool dirty,
+        vector<pair<uint64_t, bool>>& evicted) {
+    this->discard(key);
+
+    vector<uint8_t> compressed = compress(bytes, size);
+    if (compressed.size() >= size || compressed.size() > this->capacity) {
+        this->rejects++;
+        return false;
+    }
+
+    this->stores++;
+    this->original_bytes += size;
+    this->compressed_bytes += compressed.size();
+    this->used += compressed.size();
+
+    this->entries.push_back(Entry{key, dirty, move(compressed)});
+    this->index[key] = prev(this->entries.end());
+
+    while (this->used > this->capacity) {
+        evicted.emplace_back(this->entries.front().key, this->entries.front().dirty);
+        this->remove(this->entries.begin());
+        this->evictions++;
+    }
+    this->peak_used = max(this->peak_used, this->used);
+    return true;
+}
+
+
+bool CompressedPool::load(uint64_t key, string& bytes, bool& dirty) {
+    auto found = this->index.find(key);
+    if (found == this->index.end()) {
+        this->misses++;
+        return false;
+    }
+
+    bytes = decompress(found->second->compressed);
+    dirty = found->second->dirty;
+    this->remove(found->second);
+    this->hits++;
+    return true;
+}
+
+
+void CompressedPool::discard(uint64_t key) {
+    auto found = this->index.find(key);
+    if (found != this->index.end()) {
+        this->remove(found->second);
+    }
+}
+
+
+size_t CompressedPool::get_used() const {
+    return this->used;
+}
+
+
+size_t CompressedPool::get_peak_used() const {
+    return this->peak_used;
+}
+
+
+double CompressedPool::get_compression_ratio() const {
+    return this->compressed_bytes == 0 ? 0.0 : (double) this->original_bytes / this->compressed_bytes;
+}
+
+
+void CompressedPool::remove(list<Entry>::iterator entry) {
+    this->used -= entry->compressed.size();
+    this->index.erase(entry->key);
+    this->entries.erase(entry);
+}
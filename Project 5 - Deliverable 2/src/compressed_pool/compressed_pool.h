@@ -0,0 +1,156 @@
+/**
+ * This file contains the definition of the CompressedPool class.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/**
+ * A bounded pool of compressed pages in memory, in the style of zswap, that
+ * evicted pages are kept in so a later fault can decompress them instead of
+ * reading them back from disk.
+ *
+ * Pages are compressed with a small LZ77 compressor. Pages that do not
+ * compress at all are rejected. Once the pool is over its capacity, the pages
+ * stored longest ago are evicted from it (and, if dirty, written back).
+ * Entries are keyed by the caller, and a page is taken out of the pool when
+ * it is loaded.
+ */
+class CompressedPool {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The shortest and longest runs of bytes the compressor copies from
+    * earlier in the page.
+    */
+    static const size_t MIN_MATCH = 3;
+    static const size_t MAX_MATCH = 127 + MIN_MATCH;
+
+    /**
+    * The longest run of literal bytes in one token.
+    */
+    static const size_t MAX_LITERALS = 128;
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Compresses the given bytes. Each token starts with a byte: below 0x80,
+    * that many literal bytes plus one follow; otherwise, the low seven bits
+    * plus MIN_MATCH are the length of a match, and two bytes follow with its
+    * distance back (little-endian).
+    */
+    static std::vector<uint8_t> compress(const char* bytes, size_t size);
+
+    /**
+    * Decompresses the output of compress().
+    */
+    static std::string decompress(const std::vector<uint8_t>& compressed);
+
+    /**
+    * Constructor, for a pool holding up to capacity bytes of compressed
+    * pages.
+    */
+    CompressedPool(size_t capacity) : capacity(capacity) {}
+
+    /**
+    * Compresses the given page and stores it under the given key, replacing
+    * any page stored under it already. Returns false if the page was
+    * rejected. The keys of pages evicted to make room, and whether they were
+    * dirty, are appended to evicted.
+    */
+    bool store(uint64_t key, const char* bytes, size_t size, bool dirty,
+        std::vector<std::pair<uint64_t, bool>>& evicted);
+
+    /**
+    * Takes the page stored under the given key out of the pool, setting
+    * bytes to its contents and dirty to whether it was stored dirty, and
+    * returns true, or returns false if there is none.
+    */
+    bool load(uint64_t key, std::string& bytes, bool& dirty);
+
+    /**
+    * Drops the page stored under the given key, if any, without counting it
+    * as a load.
+    */
+    void discard(uint64_t key);
+
+    /**
+    * Returns the number of compressed bytes stored, now and at the most.
+    */
+    size_t get_used() const;
+    size_t get_peak_used() const;
+
+    /**
+    * Returns the number of bytes of the pages stored over the bytes they were
+    * compressed to, or 0 if none were.
+    */
+    double get_compression_ratio() const;
+
+// CLASS INSTANCE VARIABLES
+public:
+
+    /**
+    * The number of pages stored and rejected, of loads that found their page
+    * and that did not, and of pages evicted.
+    */
+    size_t stores = 0;
+    size_t rejects = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+
+// PRIVATE TYPES
+private:
+
+    /**
+    * A stored page.
+    */
+    struct Entry {
+        uint64_t key;
+        bool dirty;
+        std::vector<uint8_t> compressed;
+    };
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Removes the given entry.
+    */
+    void remove(std::list<Entry>::iterator entry);
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The most compressed bytes the pool holds.
+    */
+    size_t capacity;
+
+    /**
+    * The compressed bytes stored, now and at the most.
+    */
+    size_t used = 0;
+    size_t peak_used = 0;
+
+    /**
+    * The bytes of every page stored, before and after compression.
+    */
+    size_t original_bytes = 0;
+    size_t compressed_bytes = 0;
+
+    /**
+    * The stored pages, oldest first, and where each key's page is.
+    */
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+};
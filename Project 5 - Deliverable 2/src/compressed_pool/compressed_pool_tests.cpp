@@ -0,0 +1,74 @@
+/**
+ * This file contains tests for the CompressedPool class.
+ */
+
+#include "compressed_pool/compressed_pool.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(CompressedPool, RoundTrips) {
+  string repetitive(200, 'a');
+  string text = "the quick brown fox jumps over the lazy dog, the lazy dog sleeps";
+  string mixed = text + repetitive + "xyz" + text;
+
+  for (const string& bytes : {repetitive, text, mixed, string("ab")}) {
+    vector<uint8_t> compressed = CompressedPool::compress(bytes.data(), bytes.size());
+    ASSERT_EQ(bytes, CompressedPool::decompress(compressed));
+  }
+
+  // a run of one byte is one literal and a few overlapping matches
+  ASSERT_LT(CompressedPool::compress(repetitive.data(), repetitive.size()).size(), 10);
+}
+
+
+TEST(CompressedPool, StoreAndLoad) {
+  CompressedPool pool(100);
+  vector<pair<uint64_t, bool>> evicted;
+  string zeros(64, '\0');
+  string bytes;
+  bool dirty;
+
+  ASSERT_TRUE(pool.store(1, zeros.data(), zeros.size(), true, evicted));
+  ASSERT_GT(pool.get_used(), 0);
+  ASSERT_GT(pool.get_compression_ratio(), 1.0);
+
+  ASSERT_TRUE(pool.load(1, bytes, dirty));
+  ASSERT_EQ(zeros, bytes);
+  ASSERT_TRUE(dirty);
+  ASSERT_FALSE(pool.load(1, bytes, dirty));
+  ASSERT_EQ(1, pool.hits);
+  ASSERT_EQ(1, pool.misses);
+  ASSERT_EQ(0, pool.get_used());
+}
+
+
+TEST(CompressedPool, RejectsIncompressible) {
+  CompressedPool pool(100);
+  vector<pair<uint64_t, bool>> evicted;
+  string bytes = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+  ASSERT_FALSE(pool.store(1, bytes.data(), bytes.size(), false, evicted));
+  ASSERT_EQ(1, pool.rejects);
+  ASSERT_EQ(0, pool.get_used());
+}
+
+
+TEST(CompressedPool, EvictsOldest) {
+  string zeros(64, '\0');
+  size_t size = CompressedPool::compress(zeros.data(), zeros.size()).size();
+  CompressedPool pool(2 * size);
+  vector<pair<uint64_t, bool>> evicted;
+
+  pool.store(1, zeros.data(), zeros.size(), true, evicted);
+  pool.store(2, zeros.data(), zeros.size(), false, evicted);
+  ASSERT_TRUE(evicted.empty());
+
+  pool.store(3, zeros.data(), zeros.size(), false, evicted);
+  ASSERT_EQ(1, evicted.size());
+  ASSERT_EQ(1, evicted[0].first);
+  ASSERT_TRUE(evicted[0].second);
+  ASSERT_EQ(1, pool.evictions);
+  ASSERT_EQ(2 * size, pool.get_peak_used());
+}
@@ -1,9 +1,56 @@
 #include "flag_parser/flag_parser.h"
+#include "page/page.h"
 #include <iostream>
 #include <getopt.h>
 
 using namespace std;
 
+/**
+ * Values for the flags that only have a long form.
+ */
+enum LongFlag {
+    MRC_MAX_KEYS = 256,
+    MRC_ERROR,
+    CONVERT,
+    COMPARE,
+    SCOPE,
+    FRAME_COUNT,
+    ALLOCATION,
+    WINDOW,
+    PFF_LOW,
+    PFF_HIGH,
+    THREADS,
+    TLB,
+    TLB_WAYS,
+    TLB_POLICY,
+    TLB_FLUSH,
+    TLB_LATENCY,
+    MEMORY_LATENCY,
+    PREFER_CLEAN,
+    PAGE_IN_LATENCY,
+    WRITEBACK_LATENCY,
+    PREFETCH,
+    PREFETCH_DEPTH,
+    DEDUP,
+    FRAME_ALLOCATOR,
+    HUGE_PAGES,
+    SWAP,
+    QUEUE_DEPTH,
+    SWAP_BANDWIDTH,
+    ZSWAP,
+    ZSWAP_LATENCY,
+    L1_CACHE,
+    L2_CACHE,
+    LLC_CACHE,
+    CACHE_LINE,
+    CACHE_POLICY,
+    INTERVAL,
+    INTERVAL_FORMAT,
+    INTERVAL_OUTPUT,
+    EVENT_LOG,
+    DECODE_EVENTS
+};
+
 
 void print_usage() {
   cout <<
@@ -13,21 +60,238 @@ void print_usage() {
       "  -v, --verbose\n"
       "      Output information about every memory access.\n"
       "\n"
-      "  -s, --strategy <FIFO | LRU>\n"
-      "      The replacement strategy to use. One of FIFO or LRU.\n"
+      "  -s, --strategy <FIFO | LRU | CLOCK | SECOND_CHANCE | ENHANCED_CLOCK |\n"
+      "                  OPT | ARC | 2Q>\n"
+      "      The replacement strategy to use. ENHANCED_CLOCK also considers\n"
+      "      the dirty bit, preferring to evict clean pages. OPT (Belady's\n"
+      "      optimal policy) reads the whole trace into memory first. ARC and\n"
+      "      2Q resist scans by remembering recently evicted pages.\n"
       "\n"
       "  -f, --max-frames <positive integer>\n"
       "      The maximum number of frames a process may be allocated.\n"
       "\n"
+      "  --scope <local | global>\n"
+      "      Whether victims are chosen among the faulting process's pages\n"
+      "      (the default), or among every page in memory. Global replacement\n"
+      "      ignores --max-frames, and does not support ARC or 2Q.\n"
+      "\n"
+      "  --num-frames <positive integer>\n"
+      "      The number of frames in main memory (512 by default).\n"
+      "\n"
+      "  --frame-allocator <stack | bitmap | buddy>\n"
+      "      How free frames are handed out: the most recently freed first\n"
+      "      (the default), always the lowest-numbered free frame, or from\n"
+      "      power-of-two blocks (the default with --huge-pages).\n"
+      "\n"
+      "  --huge-pages <order>\n"
+      "      Also map aligned runs of 2^order pages with huge pages, backed by\n"
+      "      as many contiguous frames. A run is promoted to a huge page once\n"
+      "      all of it is in memory, faults back in whole after that, and is\n"
+      "      demoted to base pages when a frame has to be found with none\n"
+      "      free. Only with the fixed allocation, and not with --prefetch,\n"
+      "      --dedup or --threads.\n"
+      "\n"
+      "  --allocation <fixed | ws | pff>\n"
+      "      How many frames each (local) process may hold: --max-frames, as\n"
+      "      many as its working set needs, or a budget that starts at\n"
+      "      --max-frames and follows its page-fault frequency. Not supported\n"
+      "      with ARC or 2Q.\n"
+      "\n"
+      "  --window <positive integer>\n"
+      "      The working-set window, or the number of accesses a process's\n"
+      "      fault rate is measured over (1000 by default).\n"
+      "\n"
+      "  --pff-low <rate>, --pff-high <rate>\n"
+      "      The fault rates (0.1 and 0.5 by default) below which and above\n"
+      "      which pff shrinks or grows a process's budget by a quarter.\n"
+      "\n"
+      "  --threads <positive integer>\n"
+      "      Simulate the processes on up to this many worker threads, each\n"
+      "      with its own share of the frames. Needs local replacement with a\n"
+      "      fixed allocation, and cannot be combined with -v.\n"
+      "\n"
+      "  --tlb <entries>\n"
+      "      Put a TLB with this many entries in front of the page tables.\n"
+      "      Not supported with --threads.\n"
+      "\n"
+      "  --tlb-ways <positive integer>\n"
+      "      The associativity of the TLB (4 by default), which must divide\n"
+      "      the number of entries.\n"
+      "\n"
+      "  --tlb-policy <LRU | FIFO | RANDOM>\n"
+      "      How the TLB picks an entry to replace within a set.\n"
+      "\n"
+      "  --tlb-flush\n"
+      "      Flush the TLB on every context switch instead of tagging its\n"
+      "      entries with address space identifiers.\n"
+      "\n"
+      "  --tlb-latency <ns>, --memory-latency <ns>\n"
+      "      The cost of a TLB lookup (1 by default) and of a memory reference\n"
+      "      (100 by default), for the effective access time.\n"
+      "\n"
+      "  --l1 <bytes>[:<ways>[:<ns>]], --l2 <...>, --llc <...>\n"
+      "      Put a level of CPU cache of this size in front of physical\n"
+      "      memory, optionally with its associativity and hit time (4-way\n"
+      "      and 1 ns, 8-way and 4 ns, and 16-way and 12 ns by default). Hit\n"
+      "      rates and the average memory access time are reported. The size\n"
+      "      must be a multiple of the line size times the ways. Not supported\n"
+      "      with --threads.\n"
+      "\n"
+      "  --cache-line <bytes>, --cache-policy <LRU | FIFO | RANDOM>\n"
+      "      The line size of every cache level (16 by default), a power of\n"
+      "      two no larger than a page, and how lines are replaced.\n"
+      "\n"
+      "  --prefer-clean\n"
+      "      Have FIFO and LRU evict the coldest clean page in the colder half\n"
+      "      of memory before any dirty one, and CLOCK skip unreferenced dirty\n"
+      "      pages like ENHANCED_CLOCK does. Only for those strategies (and\n"
+      "      --compare).\n"
+      "\n"
+      "  --page-in-latency <ns>, --writeback-latency <ns>\n"
+      "      The cost of reading a page in on a fault and of writing a dirty\n"
+      "      page back when it is evicted (5 ms each by default), for the total\n"
+      "      I/O cost. Traces mark writes with a W after the address.\n"
+      "\n"
+      "  --swap\n"
+      "      Time the trace against a swap device, using the page-in and\n"
+      "      writeback latencies. A process waits for its page-ins while the\n"
+      "      others keep running, and the makespan and device utilization are\n"
+      "      reported. Not supported with OPT or --threads.\n"
+      "\n"
+      "  --queue-depth <positive integer>, --swap-bandwidth <MB/s>\n"
+      "      How many requests the swap device services at once (1 by\n"
+      "      default), and how fast it transfers pages (100 MB/s by default).\n"
+      "\n"
+      "  --zswap <frames>\n"
+      "      Keep evicted pages compressed in a pool of this many frames' worth\n"
+      "      of bytes, so faulting them back in only costs a decompression.\n"
+      "      Pages that do not compress are not kept, and the oldest are\n"
+      "      pushed out (and written back if dirty) when the pool is full.\n"
+      "      Not supported with --huge-pages or --threads.\n"
+      "\n"
+      "  --zswap-latency <ns>\n"
+      "      The cost of decompressing a page from the pool (10 us by default).\n"
+      "\n"
+      "  --prefetch <next-n | stride | readahead>\n"
+      "      Also load pages ahead of time: the pages after each faulting\n"
+      "      page, pages along a stride seen between faults, or a readahead\n"
+      "      window that doubles as its pages get used. Prefetches stay\n"
+      "      within the process's frame budget. Not supported with OPT, ARC,\n"
+      "      2Q or --threads.\n"
+      "\n"
+      "  --prefetch-depth <positive integer>\n"
+      "      The most pages prefetched at a time (8 by default).\n"
+      "\n"
+      "  --dedup\n"
+      "      Let pages that have never been written share a frame with an\n"
+      "      identical page already in memory, copying them on their first\n"
+      "      write. The trace is also run without merging, for comparison.\n"
+      "      Not supported with --threads.\n"
+      "\n"
+      "  --interval <positive integer>\n"
+      "      Also write each process's accesses, faults, hits, RSS and fault\n"
+      "      rate for every window of this many accesses, to spot phases such\n"
+      "      as thrashing. Not supported with --compare or --threads.\n"
+      "\n"
+      "  --interval-format <csv | json>, --interval-output <file>\n"
+      "      Write the windows as CSV rows (the default) or JSON lines, and to\n"
+      "      the given file rather than ahead of the summary.\n"
+      "\n"
       "  -i, --file-verbose\n"
       "      Print process size and virtual addresses when reading in file.\n"
       "\n"
+      "  -m, --mrc\n"
+      "      Print the LRU fault count for every frame budget up to\n"
+      "      --num-frames, in one pass.\n"
+      "\n"
+      "  -r, --sample-rate <rate in (0, 1]>\n"
+      "      With --mrc, only sample this fraction of the pages.\n"
+      "\n"
+      "  --mrc-max-keys <positive integer>\n"
+      "      With --mrc, track at most this many pages, lowering the rate.\n"
+      "\n"
+      "  --mrc-error\n"
+      "      With a sampled --mrc, also report the error against the exact curve.\n"
+      "\n"
+      "  --convert <output file>\n"
+      "      Convert the (text) simulation file into a binary trace and exit.\n"
+      "      Binary traces are detected automatically when simulating.\n"
+      "\n"
+      "  --event-log <output file>\n"
+      "      Record what happens on each access, as -v prints it, in a compact\n"
+      "      binary log instead of printing it. Not supported with --compare\n"
+      "      or --threads.\n"
+      "\n"
+      "  --decode-events\n"
+      "      Print the event log given as the filename as -v text and exit.\n"
+      "\n"
+      "  --compare\n"
+      "      Run every strategy on the trace and print their fault counts.\n"
+      "\n"
       "  -h --help\n"
       "      Display a help message about these flags and exit\n"
       "\n";
 }
 
 
+string to_string(ReplacementStrategy strategy) {
+    switch (strategy) {
+        case ReplacementStrategy::FIFO:
+            return "FIFO";
+        case ReplacementStrategy::LRU:
+            return "LRU";
+        case ReplacementStrategy::CLOCK:
+            return "CLOCK";
+        case ReplacementStrategy::SECOND_CHANCE:
+            return "SECOND_CHANCE";
+        case ReplacementStrategy::ENHANCED_CLOCK:
+            return "ENHANCED_CLOCK";
+        case ReplacementStrategy::OPT:
+            return "OPT";
+        case ReplacementStrategy::ARC:
+            return "ARC";
+        case ReplacementStrategy::TWO_QUEUE:
+            return "2Q";
+    }
+    return "";
+}
+
+
+/**
+ * Parses a cache level given as <bytes>[:<ways>[:<ns>]], keeping the level's
+ * defaults for the parts left out. Returns false if the size or ways are not
+ * positive integers or the latency is not a number of nanoseconds.
+ */
+static bool parse_cache_level(const char* spec, CacheHierarchy::Level& level) {
+    char* end;
+    long size = strtol(spec, &end, 10);
+    if (end == spec || size < 1) {
+        return false;
+    }
+    level.size = size;
+
+    if (*end == ':') {
+        const char* ways_spec = end + 1;
+        long ways = strtol(ways_spec, &end, 10);
+        if (end == ways_spec || ways < 1) {
+            return false;
+        }
+        level.ways = ways;
+    }
+
+    if (*end == ':') {
+        const char* latency_spec = end + 1;
+        double latency = strtod(latency_spec, &end);
+        if (end == latency_spec || latency < 0.0) {
+            return false;
+        }
+        level.latency = latency;
+    }
+
+    return *end == '\0';
+}
+
+
 bool parse_flags(int argc, char** argv, FlagOptions& flags) {
     // Command-line flags accepted by this program.
     static struct option flag_options[] = {
@@ -37,16 +301,59 @@ bool parse_flags(int argc, char** argv, FlagOptions& flags) {
         {"max-frames",          required_argument, 0, 'f'},
         {"help",                no_argument,       0, 'h'},
         {"file-verbose",        no_argument,       0, 'i'},
+        {"mrc",                 no_argument,       0, 'm'},
+        {"sample-rate",         required_argument, 0, 'r'},
+        {"mrc-max-keys",        required_argument, 0, MRC_MAX_KEYS},
+        {"mrc-error",           no_argument,       0, MRC_ERROR},
+        {"convert",             required_argument, 0, CONVERT},
+        {"compare",             no_argument,       0, COMPARE},
+        {"scope",               required_argument, 0, SCOPE},
+        {"num-frames",          required_argument, 0, FRAME_COUNT},
+        {"allocation",          required_argument, 0, ALLOCATION},
+        {"window",              required_argument, 0, WINDOW},
+        {"pff-low",             required_argument, 0, PFF_LOW},
+        {"pff-high",            required_argument, 0, PFF_HIGH},
+        {"threads",             required_argument, 0, THREADS},
+        {"tlb",                 required_argument, 0, TLB},
+        {"tlb-ways",            required_argument, 0, TLB_WAYS},
+        {"tlb-policy",          required_argument, 0, TLB_POLICY},
+        {"tlb-flush",           no_argument,       0, TLB_FLUSH},
+        {"tlb-latency",         required_argument, 0, TLB_LATENCY},
+        {"memory-latency",      required_argument, 0, MEMORY_LATENCY},
+        {"prefer-clean",        no_argument,       0, PREFER_CLEAN},
+        {"page-in-latency",     required_argument, 0, PAGE_IN_LATENCY},
+        {"writeback-latency",   required_argument, 0, WRITEBACK_LATENCY},
+        {"prefetch",            required_argument, 0, PREFETCH},
+        {"prefetch-depth",      required_argument, 0, PREFETCH_DEPTH},
+        {"dedup",               no_argument,       0, DEDUP},
+        {"frame-allocator",     required_argument, 0, FRAME_ALLOCATOR},
+        {"huge-pages",          required_argument, 0, HUGE_PAGES},
+        {"swap",                no_argument,       0, SWAP},
+        {"queue-depth",         required_argument, 0, QUEUE_DEPTH},
+        {"swap-bandwidth",      required_argument, 0, SWAP_BANDWIDTH},
+        {"zswap",               required_argument, 0, ZSWAP},
+        {"zswap-latency",       required_argument, 0, ZSWAP_LATENCY},
+        {"l1",                  required_argument, 0, L1_CACHE},
+        {"l2",                  required_argument, 0, L2_CACHE},
+        {"llc",                 required_argument, 0, LLC_CACHE},
+        {"cache-line",          required_argument, 0, CACHE_LINE},
+        {"cache-policy",        required_argument, 0, CACHE_POLICY},
+        {"interval",            required_argument, 0, INTERVAL},
+        {"interval-format",     required_argument, 0, INTERVAL_FORMAT},
+        {"interval-output",     required_argument, 0, INTERVAL_OUTPUT},
+        {"event-log",           required_argument, 0, EVENT_LOG},
+        {"decode-events",       no_argument,       0, DECODE_EVENTS},
         {0, 0, 0, 0}
     };
 
     int option_index;
-    char flag_char;
+    int flag_char;
+    bool chose_frame_allocator = false;
 
     // Parse flags entered by the user.
     while (true) {
         flag_char =
-            getopt_long(argc, argv, "-vcs:f:w:hi", flag_options, &option_index);
+            getopt_long(argc, argv, "-vcs:f:w:himr:", flag_options, &option_index);
 
         // Detect the end of the options.
         if (flag_char == -1) {
@@ -70,6 +377,18 @@ bool parse_flags(int argc, char** argv, FlagOptions& flags) {
                     flags.strategy = ReplacementStrategy::FIFO;
                 } else if (string(optarg) == "LRU") {
                     flags.strategy = ReplacementStrategy::LRU;
+                } else if (string(optarg) == "CLOCK") {
+                    flags.strategy = ReplacementStrategy::CLOCK;
+                } else if (string(optarg) == "SECOND_CHANCE") {
+                    flags.strategy = ReplacementStrategy::SECOND_CHANCE;
+                } else if (string(optarg) == "ENHANCED_CLOCK") {
+                    flags.strategy = ReplacementStrategy::ENHANCED_CLOCK;
+                } else if (string(optarg) == "OPT") {
+                    flags.strategy = ReplacementStrategy::OPT;
+                } else if (string(optarg) == "ARC") {
+                    flags.strategy = ReplacementStrategy::ARC;
+                } else if (string(optarg) == "2Q") {
+                    flags.strategy = ReplacementStrategy::TWO_QUEUE;
                 } else {
                     return false;
                 }
@@ -93,6 +412,312 @@ bool parse_flags(int argc, char** argv, FlagOptions& flags) {
                 flags.file_verbose = true;
                 break;
 
+            case 'm':
+                flags.mrc = true;
+                break;
+
+            case 'r':
+                flags.sample_rate = atof(optarg);
+
+                if (flags.sample_rate <= 0.0 || flags.sample_rate > 1.0) {
+                    return false;
+                }
+
+                break;
+
+            case MRC_MAX_KEYS:
+                if (atoi(optarg) < 1) {
+                    return false;
+                }
+
+                flags.mrc_max_keys = atoi(optarg);
+                break;
+
+            case MRC_ERROR:
+                flags.mrc_error = true;
+                break;
+
+            case CONVERT:
+                flags.convert_output = optarg;
+                break;
+
+            case COMPARE:
+                flags.compare = true;
+                break;
+
+            case SCOPE:
+                if (string(optarg) == "local") {
+                    flags.scope = ReplacementScope::LOCAL;
+                } else if (string(optarg) == "global") {
+                    flags.scope = ReplacementScope::GLOBAL;
+                } else {
+                    return false;
+                }
+                break;
+
+            case FRAME_COUNT:
+                flags.num_frames = atoi(optarg);
+
+                if (flags.num_frames < 1) {
+                    return false;
+                }
+
+                break;
+
+            case ALLOCATION:
+                if (string(optarg) == "fixed") {
+                    flags.allocation = FrameAllocation::FIXED;
+                } else if (string(optarg) == "ws") {
+                    flags.allocation = FrameAllocation::WORKING_SET;
+                } else if (string(optarg) == "pff") {
+                    flags.allocation = FrameAllocation::PFF;
+                } else {
+                    return false;
+                }
+                break;
+
+            case WINDOW:
+                if (atoi(optarg) < 1) {
+                    return false;
+                }
+
+                flags.window = atoi(optarg);
+                break;
+
+            case PFF_LOW:
+                flags.pff_low = atof(optarg);
+                break;
+
+            case PFF_HIGH:
+                flags.pff_high = atof(optarg);
+                break;
+
+            case THREADS:
+                flags.threads = atoi(optarg);
+
+                if (flags.threads < 1) {
+                    return false;
+                }
+
+                break;
+
+            case TLB:
+                flags.tlb_entries = atoi(optarg);
+
+                if (flags.tlb_entries < 1) {
+                    return false;
+                }
+
+                break;
+
+            case TLB_WAYS:
+                flags.tlb_ways = atoi(optarg);
+
+                if (flags.tlb_ways < 1) {
+                    return false;
+                }
+
+                break;
+
+            case TLB_POLICY:
+                if (string(optarg) == "LRU") {
+                    flags.tlb_policy = Tlb::Policy::LRU;
+                } else if (string(optarg) == "FIFO") {
+                    flags.tlb_policy = Tlb::Policy::FIFO;
+                } else if (string(optarg) == "RANDOM") {
+                    flags.tlb_policy = Tlb::Policy::RANDOM;
+                } else {
+                    return false;
+                }
+                break;
+
+            case TLB_FLUSH:
+                flags.tlb_flush = true;
+                break;
+
+            case TLB_LATENCY:
+                flags.tlb_latency = atof(optarg);
+
+                if (flags.tlb_latency < 0.0) {
+                    return false;
+                }
+
+                break;
+
+            case MEMORY_LATENCY:
+                flags.memory_latency = atof(optarg);
+
+                if (flags.memory_latency < 0.0) {
+                    return false;
+                }
+
+                break;
+
+            case PREFER_CLEAN:
+                flags.prefer_clean = true;
+                break;
+
+            case PAGE_IN_LATENCY:
+                flags.page_in_latency = atof(optarg);
+
+                if (flags.page_in_latency < 0.0) {
+                    return false;
+                }
+
+                break;
+
+            case WRITEBACK_LATENCY:
+                flags.writeback_latency = atof(optarg);
+
+                if (flags.writeback_latency < 0.0) {
+                    return false;
+                }
+
+                break;
+
+            case PREFETCH:
+                if (string(optarg) == "next-n") {
+                    flags.prefetch = Prefetcher::Policy::NEXT_N;
+                } else if (string(optarg) == "stride") {
+                    flags.prefetch = Prefetcher::Policy::STRIDE;
+                } else if (string(optarg) == "readahead") {
+                    flags.prefetch = Prefetcher::Policy::READAHEAD;
+                } else {
+                    return false;
+                }
+                break;
+
+            case PREFETCH_DEPTH:
+                if (atoi(optarg) < 1) {
+                    return false;
+                }
+
+                flags.prefetch_depth = atoi(optarg);
+                break;
+
+            case DEDUP:
+                flags.dedup = true;
+                break;
+
+            case FRAME_ALLOCATOR:
+                if (string(optarg) == "stack") {
+                    flags.frame_allocator = FrameAllocator::Policy::STACK;
+                } else if (string(optarg) == "bitmap") {
+                    flags.frame_allocator = FrameAllocator::Policy::BITMAP;
+                } else if (string(optarg) == "buddy") {
+                    flags.frame_allocator = FrameAllocator::Policy::BUDDY;
+                } else {
+                    return false;
+                }
+                chose_frame_allocator = true;
+                break;
+
+            case HUGE_PAGES:
+                if (atoi(optarg) < 1 || atoi(optarg) > 16) {
+                    return false;
+                }
+
+                flags.huge_page_order = atoi(optarg);
+                break;
+
+            case SWAP:
+                flags.swap = true;
+                break;
+
+            case QUEUE_DEPTH:
+                if (atoi(optarg) < 1) {
+                    return false;
+                }
+
+                flags.queue_depth = atoi(optarg);
+                break;
+
+            case SWAP_BANDWIDTH:
+                flags.swap_bandwidth = atof(optarg);
+
+                if (flags.swap_bandwidth <= 0.0) {
+                    return false;
+                }
+
+                break;
+
+            case ZSWAP:
+                if (atoi(optarg) < 1) {
+                    return false;
+                }
+
+                flags.zswap_frames = atoi(optarg);
+                break;
+
+            case ZSWAP_LATENCY:
+                flags.zswap_latency = atof(optarg);
+
+                if (flags.zswap_latency < 0.0) {
+                    return false;
+                }
+
+                break;
+
+            case L1_CACHE:
+            case L2_CACHE:
+            case LLC_CACHE:
+                if (!parse_cache_level(optarg, flags.cache_levels[flag_char - L1_CACHE])) {
+                    return false;
+                }
+                break;
+
+            case CACHE_LINE:
+                flags.cache_line = atoi(optarg);
+
+                if (atoi(optarg) < 1 || (flags.cache_line & (flags.cache_line - 1)) != 0
+                        || flags.cache_line > Page::PAGE_SIZE) {
+                    return false;
+                }
+
+                break;
+
+            case CACHE_POLICY:
+                if (string(optarg) == "LRU") {
+                    flags.cache_policy = Cache::Policy::LRU;
+                } else if (string(optarg) == "FIFO") {
+                    flags.cache_policy = Cache::Policy::FIFO;
+                } else if (string(optarg) == "RANDOM") {
+                    flags.cache_policy = Cache::Policy::RANDOM;
+                } else {
+                    return false;
+                }
+                break;
+
+            case INTERVAL:
+                if (atoi(optarg) < 1) {
+                    return false;
+                }
+
+                flags.interval = atoi(optarg);
+                break;
+
+            case INTERVAL_FORMAT:
+                if (string(optarg) == "csv") {
+                    flags.interval_format = IntervalFormat::CSV;
+                } else if (string(optarg) == "json") {
+                    flags.interval_format = IntervalFormat::JSON;
+                } else {
+                    return false;
+                }
+                break;
+
+            case INTERVAL_OUTPUT:
+                flags.interval_output = optarg;
+                break;
+
+            case EVENT_LOG:
+                flags.event_log = optarg;
+                break;
+
+            case DECODE_EVENTS:
+                flags.decode_events = true;
+                break;
+
             case 1:
                 flags.filename = optarg;
                 break;
@@ -106,5 +731,101 @@ bool parse_flags(int argc, char** argv, FlagOptions& flags) {
         return false;
     }
 
+    // huge pages need contiguous frames, which the buddy allocator is for
+    if (flags.huge_page_order > 0 && !chose_frame_allocator) {
+        flags.frame_allocator = FrameAllocator::Policy::BUDDY;
+    }
+
+    // the adaptive policies' ghost lists are per process, and only pick
+    // victims to make room for a particular page
+    bool adaptive = flags.strategy == ReplacementStrategy::ARC
+        || flags.strategy == ReplacementStrategy::TWO_QUEUE;
+    if (adaptive && (flags.scope == ReplacementScope::GLOBAL
+            || flags.allocation != FrameAllocation::FIXED)) {
+        return false;
+    }
+
+    // dynamic allocation gives each process its own share of memory
+    if (flags.scope == ReplacementScope::GLOBAL && flags.allocation != FrameAllocation::FIXED) {
+        return false;
+    }
+
+    // workers only share frames through a fixed partition, and would garble
+    // the verbose output
+    if (flags.threads > 1 && (flags.verbose || flags.scope == ReplacementScope::GLOBAL
+            || flags.allocation != FrameAllocation::FIXED)) {
+        return false;
+    }
+
+    // the TLB is shared by every process, and its sets must all be full
+    if (flags.tlb_entries > 0 && (flags.threads > 1 || flags.tlb_entries % flags.tlb_ways != 0)) {
+        return false;
+    }
+
+    // the other strategies already order pages their own way
+    bool cleanable = flags.strategy == ReplacementStrategy::FIFO
+        || flags.strategy == ReplacementStrategy::LRU
+        || flags.strategy == ReplacementStrategy::CLOCK;
+    if (flags.prefer_clean && !cleanable && !flags.compare) {
+        return false;
+    }
+
+    // OPT and the adaptive policies only know about pages the trace accesses,
+    // and workers do not share the fault path prefetches go through
+    bool prefetchable = flags.strategy != ReplacementStrategy::OPT && !adaptive;
+    if (flags.prefetch != Prefetcher::Policy::NONE
+            && (flags.threads > 1 || (!prefetchable && !flags.compare))) {
+        return false;
+    }
+
+    // shared frames belong to more than one process, and so to more than one
+    // worker
+    if (flags.dedup && flags.threads > 1) {
+        return false;
+    }
+
+    // huge pages are made and broken up on the shared fault path, a whole
+    // run at a time, which prefetching, shared frames and frames given back
+    // one at a time would all have to work around
+    if (flags.huge_page_order > 0 && (flags.threads > 1 || flags.dedup
+            || flags.prefetch != Prefetcher::Policy::NONE
+            || flags.allocation != FrameAllocation::FIXED)) {
+        return false;
+    }
+
+    // the swap device reorders the accesses of waiting processes, which OPT
+    // cannot see coming, and workers keep no shared clock
+    if (flags.swap && (flags.threads > 1
+            || (flags.strategy == ReplacementStrategy::OPT && !flags.compare))) {
+        return false;
+    }
+
+    // the pool holds base pages, which a huge page is not evicted as, and
+    // is shared by every worker
+    if (flags.zswap_frames > 0 && (flags.threads > 1 || flags.huge_page_order > 0)) {
+        return false;
+    }
+
+    // every level must be made of whole sets, and is shared by every process
+    for (const CacheHierarchy::Level& level : flags.cache_levels) {
+        if (level.size > 0 && (flags.threads > 1 || level.size % (flags.cache_line * level.ways) != 0)) {
+            return false;
+        }
+    }
+
+    // the log follows a single run of the trace, like -v
+    if (!flags.event_log.empty() && (flags.compare || flags.threads > 1)) {
+        return false;
+    }
+
+    // windows follow a single run of the trace, in order
+    if (flags.interval > 0 && (flags.compare || flags.threads > 1)) {
+        return false;
+    }
+
+    if (flags.pff_low < 0.0 || flags.pff_low > flags.pff_high || flags.pff_high > 1.0) {
+        return false;
+    }
+
     return true;
 }
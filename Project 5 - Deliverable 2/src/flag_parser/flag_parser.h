@@ -6,7 +6,13 @@
  */
 
 #pragma once
+#include "cache/cache.h"
+#include "frame_allocator/frame_allocator.h"
+#include "prefetcher/prefetcher.h"
+#include "tlb/tlb.h"
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 
 /**
@@ -14,7 +20,44 @@
  */
 enum class ReplacementStrategy {
     FIFO,
-    LRU
+    LRU,
+    CLOCK,
+    SECOND_CHANCE,
+    ENHANCED_CLOCK,
+    OPT,
+    ARC,
+    TWO_QUEUE
+};
+
+
+/**
+ * Enum representing whether victims are chosen among the faulting process's
+ * own pages, or among every page in memory.
+ */
+enum class ReplacementScope {
+    LOCAL,
+    GLOBAL
+};
+
+
+/**
+ * Enum representing how many frames each process may hold: a fixed number, as
+ * many as its working set needs, or a budget adjusted by its fault frequency.
+ */
+enum class FrameAllocation {
+    FIXED,
+    WORKING_SET,
+    PFF
+};
+
+
+/**
+ * Enum representing how the per-interval metrics are written: as CSV rows, or
+ * as one JSON object per line.
+ */
+enum class IntervalFormat {
+    CSV,
+    JSON
 };
 
 
@@ -52,6 +95,211 @@ struct FlagOptions {
     * The maximum number of frames that can be allocated to a process.
     */
     int max_frames = 10;
+
+    /**
+    * Whether replacement is local to each process or global.
+    */
+    ReplacementScope scope = ReplacementScope::LOCAL;
+
+    /**
+    * The number of frames in main memory.
+    */
+    int num_frames = 512;
+
+    /**
+    * The backend that hands out free frames.
+    */
+    FrameAllocator::Policy frame_allocator = FrameAllocator::Policy::STACK;
+
+    /**
+    * How frames are allocated to processes.
+    */
+    FrameAllocation allocation = FrameAllocation::FIXED;
+
+    /**
+    * The working-set window, or the number of a process's accesses over
+    * which the page-fault-frequency allocator measures its fault rate.
+    */
+    size_t window = 1000;
+
+    /**
+    * The fault rates below which and above which the page-fault-frequency
+    * allocator shrinks or grows a process's frame budget.
+    */
+    double pff_low = 0.1;
+    double pff_high = 0.5;
+
+    /**
+    * The number of worker threads to shard the processes across. More than
+    * one requires local replacement with a fixed allocation, and no -v.
+    */
+    int threads = 1;
+
+    /**
+    * The number of entries in the TLB, or 0 to simulate without one.
+    */
+    int tlb_entries = 0;
+
+    /**
+    * The associativity of the TLB.
+    */
+    int tlb_ways = 4;
+
+    /**
+    * How the TLB picks which entry of a full set to replace.
+    */
+    Tlb::Policy tlb_policy = Tlb::Policy::LRU;
+
+    /**
+    * Whether the TLB is flushed on every context switch, rather than tagging
+    * its entries with address space identifiers.
+    */
+    bool tlb_flush = false;
+
+    /**
+    * The time a TLB lookup and a memory reference take, in nanoseconds, for
+    * estimating the effective access time.
+    */
+    double tlb_latency = 1.0;
+    double memory_latency = 100.0;
+
+    /**
+    * The levels of the CPU cache in front of physical memory, L1 first, each
+    * with its size in bytes (0 to leave it out), associativity and hit time
+    * in nanoseconds.
+    */
+    std::vector<CacheHierarchy::Level> cache_levels = {
+        {"L1", 0, 4, 1.0},
+        {"L2", 0, 8, 4.0},
+        {"LLC", 0, 16, 12.0}
+    };
+
+    /**
+    * The line size of every cache level, in bytes, and how a level picks the
+    * line to replace within a set.
+    */
+    size_t cache_line = 16;
+    Cache::Policy cache_policy = Cache::Policy::LRU;
+
+    /**
+    * Whether FIFO, LRU and CLOCK should pass over dirty pages for clean ones
+    * when picking a victim, to save writebacks.
+    */
+    bool prefer_clean = false;
+
+    /**
+    * The time reading a page in from disk and writing a dirty page back take,
+    * in nanoseconds, for estimating the total I/O cost.
+    */
+    double page_in_latency = 5000000.0;
+    double writeback_latency = 5000000.0;
+
+    /**
+    * Whether to time the trace against a swap device, overlapping each
+    * process's page-ins with the other processes' accesses.
+    */
+    bool swap = false;
+
+    /**
+    * How many requests the swap device services at once, and its bandwidth,
+    * in MB/s.
+    */
+    size_t queue_depth = 1;
+    double swap_bandwidth = 100.0;
+
+    /**
+    * The size of the compressed pool evicted pages are kept in, in frames'
+    * worth of bytes, or 0 for none.
+    */
+    size_t zswap_frames = 0;
+
+    /**
+    * The time decompressing a page from the pool takes, in nanoseconds.
+    */
+    double zswap_latency = 10000.0;
+
+    /**
+    * How pages are picked to prefetch on faults, if at all.
+    */
+    Prefetcher::Policy prefetch = Prefetcher::Policy::NONE;
+
+    /**
+    * The most pages prefetched at a time (the largest readahead window).
+    */
+    size_t prefetch_depth = 8;
+
+    /**
+    * Whether pages with identical contents share frames (same-page merging),
+    * across processes as well as within them.
+    */
+    bool dedup = false;
+
+    /**
+    * The order of huge pages, which map 2^order pages each, or 0 for base
+    * pages only.
+    */
+    size_t huge_page_order = 0;
+
+    /**
+    * The number of accesses in each window that per-process metrics are
+    * written for, or 0 for none.
+    */
+    size_t interval = 0;
+
+    /**
+    * How the per-interval metrics are written, and the file they are written
+    * to (standard output if empty).
+    */
+    IntervalFormat interval_format = IntervalFormat::CSV;
+    std::string interval_output;
+
+    /**
+    * Whether to compute the LRU miss-ratio curve of the trace instead of
+    * running a single simulation.
+    */
+    bool mrc = false;
+
+    /**
+    * The fraction of pages whose accesses the miss-ratio curve analysis
+    * samples. Values below 1 give an approximate curve (SHARDS).
+    */
+    double sample_rate = 1.0;
+
+    /**
+    * The maximum number of pages the miss-ratio curve analysis tracks at once,
+    * lowering the sample rate as needed, or 0 for no limit.
+    */
+    size_t mrc_max_keys = 0;
+
+    /**
+    * Whether a sampled miss-ratio curve should also be computed exactly, and
+    * the error of the approximation reported.
+    */
+    bool mrc_error = false;
+
+    /**
+    * If set, the text simulation file is converted to a binary trace at this
+    * path instead of being simulated.
+    */
+    std::string convert_output;
+
+    /**
+    * If set, the events of each access are recorded in a binary event log at
+    * this path instead of being printed.
+    */
+    std::string event_log;
+
+    /**
+    * Whether the file is an event log to print as verbose text, instead of a
+    * simulation file.
+    */
+    bool decode_events = false;
+
+    /**
+    * Whether to run every replacement strategy on the trace and print their
+    * fault counts side by side instead of running a single simulation.
+    */
+    bool compare = false;
 };
 
 
@@ -60,6 +308,11 @@ struct FlagOptions {
 */
 void print_usage();
 
+/**
+* Returns the name of the given strategy, as accepted by the -s flag.
+*/
+std::string to_string(ReplacementStrategy strategy);
+
 /**
 * Parses any provided flags, populating the provided FlagOptions instance.
 * Returns true if the parsing succeeded, or false in the case of errors. If the
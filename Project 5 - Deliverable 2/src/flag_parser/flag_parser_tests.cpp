@@ -118,6 +118,54 @@ TEST(ParseFlags, StrategyLruShort) {
 }
 
 
+TEST(ParseFlags, StrategyClock) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--strategy", "CLOCK"}, flags));
+  ASSERT_EQ(ReplacementStrategy::CLOCK, flags.strategy);
+}
+
+
+TEST(ParseFlags, StrategySecondChance) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-s", "SECOND_CHANCE"}, flags));
+  ASSERT_EQ(ReplacementStrategy::SECOND_CHANCE, flags.strategy);
+}
+
+
+TEST(ParseFlags, StrategyEnhancedClock) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-s", "ENHANCED_CLOCK"}, flags));
+  ASSERT_EQ(ReplacementStrategy::ENHANCED_CLOCK, flags.strategy);
+}
+
+
+TEST(ParseFlags, StrategyOpt) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-s", "OPT"}, flags));
+  ASSERT_EQ(ReplacementStrategy::OPT, flags.strategy);
+}
+
+
+TEST(ParseFlags, StrategyArc) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-s", "ARC"}, flags));
+  ASSERT_EQ(ReplacementStrategy::ARC, flags.strategy);
+}
+
+
+TEST(ParseFlags, StrategyTwoQueue) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-s", "2Q"}, flags));
+  ASSERT_EQ(ReplacementStrategy::TWO_QUEUE, flags.strategy);
+}
+
+
 TEST(ParseFlags, StrategyNoArg) {
   FlagOptions flags;
 
@@ -184,6 +232,496 @@ TEST(ParseFlags, MaxFramesNonInteger) {
 }
 
 
+TEST(ParseFlags, DefaultMrc) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file"}, flags));
+  ASSERT_FALSE(flags.mrc);
+}
+
+
+TEST(ParseFlags, Mrc) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--mrc"}, flags));
+  ASSERT_TRUE(flags.mrc);
+}
+
+
+TEST(ParseFlags, MrcShort) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-m"}, flags));
+  ASSERT_TRUE(flags.mrc);
+}
+
+
+TEST(ParseFlags, MrcNumFrames) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--mrc", "--num-frames", "1024"}, flags));
+  ASSERT_TRUE(flags.mrc);
+  ASSERT_EQ(1024, flags.num_frames);
+
+  FlagOptions small_flags;
+  ASSERT_TRUE(parse_flags({"file", "--mrc", "--num-frames", "64"}, small_flags));
+  ASSERT_EQ(64, small_flags.num_frames);
+}
+
+
+TEST(ParseFlags, DefaultSampleRate) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file"}, flags));
+  ASSERT_DOUBLE_EQ(1.0, flags.sample_rate);
+  ASSERT_EQ(0, flags.mrc_max_keys);
+  ASSERT_FALSE(flags.mrc_error);
+}
+
+
+TEST(ParseFlags, SampleRate) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--mrc", "--sample-rate", "0.01"}, flags));
+  ASSERT_DOUBLE_EQ(0.01, flags.sample_rate);
+}
+
+
+TEST(ParseFlags, SampleRateOutOfRange) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "-r", "0"}, flags));
+  ASSERT_FALSE(parse_flags({"file", "-r", "1.5"}, flags));
+}
+
+
+TEST(ParseFlags, MrcMaxKeysAndError) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--mrc-max-keys", "1000", "--mrc-error"}, flags));
+  ASSERT_EQ(1000, flags.mrc_max_keys);
+  ASSERT_TRUE(flags.mrc_error);
+}
+
+
+TEST(ParseFlags, MrcMaxKeysZero) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--mrc-max-keys", "0"}, flags));
+}
+
+
+TEST(ParseFlags, Convert) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--convert", "file.bin"}, flags));
+  ASSERT_EQ("file", flags.filename);
+  ASSERT_EQ("file.bin", flags.convert_output);
+}
+
+
+TEST(ParseFlags, ConvertNoArg) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--convert"}, flags));
+}
+
+
+TEST(ParseFlags, Compare) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--compare"}, flags));
+  ASSERT_TRUE(flags.compare);
+}
+
+
+TEST(ParseFlags, ScopeDefault) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file"}, flags));
+  ASSERT_EQ(ReplacementScope::LOCAL, flags.scope);
+}
+
+
+TEST(ParseFlags, ScopeGlobal) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--scope", "global"}, flags));
+  ASSERT_EQ(ReplacementScope::GLOBAL, flags.scope);
+}
+
+
+TEST(ParseFlags, ScopeLocal) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--scope", "local"}, flags));
+  ASSERT_EQ(ReplacementScope::LOCAL, flags.scope);
+}
+
+
+TEST(ParseFlags, ScopeInvalid) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--scope", "everywhere"}, flags));
+}
+
+
+TEST(ParseFlags, ScopeGlobalArc) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--scope", "global", "-s", "ARC"}, flags));
+}
+
+
+TEST(ParseFlags, NumFrames) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--num-frames", "64"}, flags));
+  ASSERT_EQ(64, flags.num_frames);
+}
+
+
+TEST(ParseFlags, NumFramesZero) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--num-frames", "0"}, flags));
+}
+
+
+TEST(ParseFlags, AllocationDefault) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file"}, flags));
+  ASSERT_EQ(FrameAllocation::FIXED, flags.allocation);
+}
+
+
+TEST(ParseFlags, AllocationWorkingSet) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--allocation", "ws", "--window", "500"}, flags));
+  ASSERT_EQ(FrameAllocation::WORKING_SET, flags.allocation);
+  ASSERT_EQ(500, flags.window);
+}
+
+
+TEST(ParseFlags, AllocationPff) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags(
+      {"file", "--allocation", "pff", "--pff-low", "0.2", "--pff-high", "0.6"}, flags));
+  ASSERT_EQ(FrameAllocation::PFF, flags.allocation);
+  ASSERT_DOUBLE_EQ(0.2, flags.pff_low);
+  ASSERT_DOUBLE_EQ(0.6, flags.pff_high);
+}
+
+
+TEST(ParseFlags, AllocationInvalid) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--allocation", "greedy"}, flags));
+}
+
+
+TEST(ParseFlags, AllocationGlobal) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--allocation", "ws", "--scope", "global"}, flags));
+}
+
+
+TEST(ParseFlags, AllocationTwoQueue) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--allocation", "pff", "-s", "2Q"}, flags));
+}
+
+
+TEST(ParseFlags, WindowZero) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--window", "0"}, flags));
+}
+
+
+TEST(ParseFlags, PffThresholdsOutOfOrder) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--pff-low", "0.7", "--pff-high", "0.6"}, flags));
+}
+
+
+TEST(ParseFlags, Threads) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--threads", "4"}, flags));
+  ASSERT_EQ(4, flags.threads);
+}
+
+
+TEST(ParseFlags, ThreadsZero) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--threads", "0"}, flags));
+}
+
+
+TEST(ParseFlags, ThreadsVerbose) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--threads", "4", "-v"}, flags));
+}
+
+
+TEST(ParseFlags, ThreadsGlobal) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--threads", "4", "--scope", "global"}, flags));
+}
+
+
+TEST(ParseFlags, TlbDefault) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file"}, flags));
+  ASSERT_EQ(0, flags.tlb_entries);
+}
+
+
+TEST(ParseFlags, Tlb) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags(
+      {"file", "--tlb", "64", "--tlb-ways", "8", "--tlb-policy", "FIFO", "--tlb-flush"}, flags));
+  ASSERT_EQ(64, flags.tlb_entries);
+  ASSERT_EQ(8, flags.tlb_ways);
+  ASSERT_EQ(Tlb::Policy::FIFO, flags.tlb_policy);
+  ASSERT_TRUE(flags.tlb_flush);
+}
+
+
+TEST(ParseFlags, TlbLatencies) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--tlb", "16", "--tlb-latency", "0.5", "--memory-latency", "80"}, flags));
+  ASSERT_DOUBLE_EQ(0.5, flags.tlb_latency);
+  ASSERT_DOUBLE_EQ(80.0, flags.memory_latency);
+}
+
+
+TEST(ParseFlags, TlbWaysMustDivideEntries) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--tlb", "10", "--tlb-ways", "4"}, flags));
+}
+
+
+TEST(ParseFlags, TlbPolicyInvalid) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--tlb", "16", "--tlb-policy", "MRU"}, flags));
+}
+
+
+TEST(ParseFlags, TlbThreads) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--tlb", "16", "--threads", "2"}, flags));
+}
+
+
+TEST(ParseFlags, PreferClean) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "-s", "LRU", "--prefer-clean"}, flags));
+  ASSERT_TRUE(flags.prefer_clean);
+}
+
+
+TEST(ParseFlags, PreferCleanUnsupportedStrategy) {
+  FlagOptions flags;
+
+  ASSERT_FALSE(parse_flags({"file", "-s", "OPT", "--prefer-clean"}, flags));
+}
+
+
+TEST(ParseFlags, IoLatencies) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--page-in-latency", "100000", "--writeback-latency", "250000"}, flags));
+  ASSERT_DOUBLE_EQ(100000.0, flags.page_in_latency);
+  ASSERT_DOUBLE_EQ(250000.0, flags.writeback_latency);
+  ASSERT_FALSE(parse_flags({"file", "--writeback-latency", "-1"}, flags));
+}
+
+
+TEST(ParseFlags, PrefetchDefault) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file"}, flags));
+  ASSERT_EQ(Prefetcher::Policy::NONE, flags.prefetch);
+}
+
+
+TEST(ParseFlags, Prefetch) {
+  FlagOptions flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--prefetch", "readahead", "--prefetch-depth", "32"}, flags));
+  ASSERT_EQ(Prefetcher::Policy::READAHEAD, flags.prefetch);
+  ASSERT_EQ(32, flags.prefetch_depth);
+  ASSERT_FALSE(parse_flags({"file", "--prefetch", "markov"}, flags));
+}
+
+
+TEST(ParseFlags, PrefetchUnsupported) {
+  FlagOptions flags;
+
+  FlagOptions other_flags;
+
+  ASSERT_FALSE(parse_flags({"file", "--prefetch", "stride", "-s", "ARC"}, flags));
+  ASSERT_FALSE(parse_flags({"file", "--prefetch", "stride", "--threads", "2"}, other_flags));
+}
+
+
+TEST(ParseFlags, Dedup) {
+  FlagOptions flags;
+  FlagOptions threaded_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--dedup"}, flags));
+  ASSERT_TRUE(flags.dedup);
+  ASSERT_FALSE(parse_flags({"file", "--dedup", "--threads", "2"}, threaded_flags));
+}
+
+
+TEST(ParseFlags, FrameAllocator) {
+  FlagOptions flags;
+  FlagOptions bad_flags;
+
+  ASSERT_EQ(FrameAllocator::Policy::STACK, flags.frame_allocator);
+  ASSERT_TRUE(parse_flags({"file", "--frame-allocator", "bitmap"}, flags));
+  ASSERT_EQ(FrameAllocator::Policy::BITMAP, flags.frame_allocator);
+  ASSERT_FALSE(parse_flags({"file", "--frame-allocator", "list"}, bad_flags));
+}
+
+
+TEST(ParseFlags, HugePages) {
+  FlagOptions flags;
+  FlagOptions bitmap_flags;
+  FlagOptions bad_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--huge-pages", "2"}, flags));
+  ASSERT_EQ(2, flags.huge_page_order);
+  ASSERT_EQ(FrameAllocator::Policy::BUDDY, flags.frame_allocator);
+
+  ASSERT_TRUE(parse_flags({"file", "--huge-pages", "2", "--frame-allocator", "bitmap"}, bitmap_flags));
+  ASSERT_EQ(FrameAllocator::Policy::BITMAP, bitmap_flags.frame_allocator);
+
+  ASSERT_FALSE(parse_flags({"file", "--huge-pages", "0"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--huge-pages", "2", "--dedup"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--huge-pages", "2", "--allocation", "pff"}, bad_flags));
+}
+
+
+TEST(ParseFlags, Swap) {
+  FlagOptions flags;
+  FlagOptions opt_flags;
+  FlagOptions bad_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--swap", "--queue-depth", "4", "--swap-bandwidth", "250"}, flags));
+  ASSERT_TRUE(flags.swap);
+  ASSERT_EQ(4, flags.queue_depth);
+  ASSERT_DOUBLE_EQ(250.0, flags.swap_bandwidth);
+
+  ASSERT_FALSE(parse_flags({"file", "--swap", "-s", "OPT"}, opt_flags));
+  ASSERT_FALSE(parse_flags({"file", "--queue-depth", "0"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--swap-bandwidth", "0"}, bad_flags));
+}
+
+
+TEST(ParseFlags, Zswap) {
+  FlagOptions flags;
+  FlagOptions bad_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--zswap", "64", "--zswap-latency", "2000"}, flags));
+  ASSERT_EQ(64, flags.zswap_frames);
+  ASSERT_DOUBLE_EQ(2000.0, flags.zswap_latency);
+
+  ASSERT_FALSE(parse_flags({"file", "--zswap", "0"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--zswap", "64", "--huge-pages", "2"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--zswap-latency", "-1"}, bad_flags));
+}
+
+
+TEST(ParseFlags, Caches) {
+  FlagOptions flags;
+  FlagOptions thread_flags;
+  FlagOptions bad_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--l1", "512", "--llc", "4096:8:20", "--cache-line", "32",
+      "--cache-policy", "FIFO"}, flags));
+  ASSERT_EQ(512, flags.cache_levels[0].size);
+  ASSERT_EQ(4, flags.cache_levels[0].ways);
+  ASSERT_EQ(0, flags.cache_levels[1].size);
+  ASSERT_EQ(4096, flags.cache_levels[2].size);
+  ASSERT_EQ(8, flags.cache_levels[2].ways);
+  ASSERT_DOUBLE_EQ(20.0, flags.cache_levels[2].latency);
+  ASSERT_EQ(32, flags.cache_line);
+  ASSERT_EQ(Cache::Policy::FIFO, flags.cache_policy);
+
+  ASSERT_FALSE(parse_flags({"file", "--l1", "512:x"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--l1", "100"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--cache-line", "24"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--l2", "1024", "--threads", "2"}, thread_flags));
+}
+
+
+TEST(ParseFlags, Interval) {
+  FlagOptions flags;
+  FlagOptions bad_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--interval", "500", "--interval-format", "json",
+      "--interval-output", "windows.jsonl"}, flags));
+  ASSERT_EQ(500, flags.interval);
+  ASSERT_EQ(IntervalFormat::JSON, flags.interval_format);
+  ASSERT_EQ("windows.jsonl", flags.interval_output);
+
+  ASSERT_FALSE(parse_flags({"file", "--interval", "0"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--interval-format", "xml"}, bad_flags));
+  ASSERT_FALSE(parse_flags({"file", "--interval", "500", "--compare"}, bad_flags));
+}
+
+
+TEST(ParseFlags, EventLog) {
+  FlagOptions flags;
+  FlagOptions decode_flags;
+  FlagOptions bad_flags;
+
+  ASSERT_TRUE(parse_flags({"file", "--event-log", "events.log"}, flags));
+  ASSERT_EQ("events.log", flags.event_log);
+  ASSERT_FALSE(flags.verbose);
+
+  ASSERT_TRUE(parse_flags({"--decode-events", "events.log"}, decode_flags));
+  ASSERT_TRUE(decode_flags.decode_events);
+  ASSERT_EQ("events.log", decode_flags.filename);
+
+  ASSERT_FALSE(parse_flags({"file", "--event-log", "events.log", "--threads", "2"}, bad_flags));
+}
+
+
+TEST(StrategyToString, RoundTrips) {
+  for (ReplacementStrategy strategy : {
+      ReplacementStrategy::FIFO, ReplacementStrategy::LRU,
+      ReplacementStrategy::CLOCK, ReplacementStrategy::SECOND_CHANCE,
+      ReplacementStrategy::ENHANCED_CLOCK, ReplacementStrategy::OPT,
+      ReplacementStrategy::ARC, ReplacementStrategy::TWO_QUEUE}) {
+    FlagOptions flags;
+
+    ASSERT_TRUE(parse_flags({"file", "-s", to_string(strategy)}, flags));
+    ASSERT_EQ(strategy, flags.strategy);
+  }
+}
+
+
 bool parse_flags(initializer_list<string> arg_list, FlagOptions& flags) {
   vector<string> args(arg_list);
   vector<char*> argv;
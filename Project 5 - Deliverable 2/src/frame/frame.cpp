@@ -10,12 +10,45 @@ using namespace std;
 
 void Frame::set_page(Process* process, size_t page_number) {
     // set the contents
-    this->contents = process->pages[page_number];
+    if (process->is_valid_page(page_number)) {
+        this->contents = &process->pages[page_number];
+    } else {
+        this->contents = nullptr;
+    }
 
     // set the process and the page number
     this->process = process;
     this->page_number = page_number;
+    this->mappings.assign(1, make_pair(process, page_number));
 
     // return when done
     return;
 }
+
+
+void Frame::add_mapping(Process* process, size_t page_number) {
+    this->mappings.emplace_back(process, page_number);
+}
+
+
+size_t Frame::remove_mapping(Process* process, size_t page_number) {
+    for (size_t i = 0; i < this->mappings.size(); i++) {
+        if (this->mappings[i].first == process && this->mappings[i].second == page_number) {
+            this->mappings.erase(this->mappings.begin() + i);
+            break;
+        }
+    }
+
+    // the next sharer holds the same contents, so it can stand in
+    if (!this->mappings.empty()) {
+        this->process = this->mappings.front().first;
+        this->page_number = this->mappings.front().second;
+        this->contents = &this->process->pages[this->page_number];
+    }
+    return this->mappings.size();
+}
+
+
+size_t Frame::get_reference_count() const {
+    return this->mappings.size();
+}
@@ -5,10 +5,17 @@
 #pragma once
 #include "page/page.h"
 #include "process/process.h"
+#include <utility>
+#include <vector>
 
 
 /**
  * A convenience for representing a frame of memory.
+ *
+ * A frame normally holds a single page, but with same-page merging several
+ * pages with identical contents may share it. The frame keeps a reverse
+ * mapping of every page mapped to it, so that all of them can be found (and
+ * unmapped) when it is evicted.
  */
 class Frame {
 // PUBLIC API METHODS
@@ -19,6 +26,24 @@ public:
     */
     void set_page(Process* process, size_t page_number);
 
+    /**
+    * Maps the given page of the given process to this frame as well, sharing
+    * the page already in it.
+    */
+    void add_mapping(Process* process, size_t page_number);
+
+    /**
+    * Unmaps the given page of the given process from this frame. If it is the
+    * page the frame was loaded for, the next page sharing the frame takes its
+    * place. Returns the number of pages still mapped.
+    */
+    size_t remove_mapping(Process* process, size_t page_number);
+
+    /**
+    * Returns the number of pages mapped to this frame.
+    */
+    size_t get_reference_count() const;
+
 // CLASS INSTANCE VARIABLES
 public:
 
@@ -27,7 +52,7 @@ public:
     * than copying the contents from the page to the frame directly, since this
     * is easier and accomplishes the same thing. =)
     */
-    Page* contents = nullptr;
+    const Page* contents = nullptr;
 
     /**
     * The page number this frame holds (pretend that this is stored in some OS
@@ -40,4 +65,10 @@ public:
     * is stored in some OS data structure).
     */
     Process* process = nullptr;
+
+    /**
+    * Every page mapped to this frame, as (process, page number) pairs, with
+    * the one described by process and page_number first.
+    */
+    std::vector<std::pair<Process*, size_t>> mappings;
 };
@@ -49,5 +49,86 @@ TEST(Frame, SetPage_Contents) {
   frame.set_page(process, 1);
 
   ASSERT_NE(nullptr, process);
-  ASSERT_EQ(process->pages[1], frame.contents);
+  ASSERT_EQ(&process->pages[1], frame.contents);
+}
+
+
+TEST(Frame, SetPage_ReferenceCount) {
+  Frame frame;
+
+  ASSERT_EQ(0, frame.get_reference_count());
+
+  frame.set_page(create_process(), 1);
+  ASSERT_EQ(1, frame.get_reference_count());
+}
+
+
+TEST(Frame, AddMapping) {
+  Frame frame;
+  Process* first = create_process();
+  Process* second = create_process();
+
+  frame.set_page(first, 1);
+  frame.add_mapping(second, 1);
+
+  ASSERT_EQ(2, frame.get_reference_count());
+  ASSERT_EQ(first, frame.process);
+  ASSERT_EQ(second, frame.mappings[1].first);
+}
+
+
+TEST(Frame, RemoveMapping_PromotesSharer) {
+  Frame frame;
+  Process* first = create_process();
+  Process* second = create_process();
+
+  frame.set_page(first, 1);
+  frame.add_mapping(second, 0);
+
+  ASSERT_EQ(1, frame.remove_mapping(first, 1));
+  ASSERT_EQ(second, frame.process);
+  ASSERT_EQ(0, frame.page_number);
+  ASSERT_EQ(&second->pages[0], frame.contents);
+
+  ASSERT_EQ(0, frame.remove_mapping(second, 0));
+}
+
+
+TEST(Frame, GlobalVictim_FromAnotherProcess) {
+  vector<Frame> frames(2);
+  PageTable frame_table(2);
+  Process* first = create_process();
+  Process* second = create_process();
+
+  // each process holds one frame; the second's page is touched least recently
+  first->page_table.load_page(0, 0, 1);
+  frame_table.load_page(0, 0, 1);
+  frames[0].set_page(first, 0);
+  second->page_table.load_page(1, 1, 2);
+  frame_table.load_page(1, 1, 2);
+  frames[1].set_page(second, 1);
+  first->page_table.touch_page(0, 3);
+  frame_table.touch_page(0, 3);
+
+  // the first process faults with memory full, so the victim comes from the
+  // whole frame table and its owner is found through the frame's mappings
+  size_t victim = frame_table.get_least_recently_used_page();
+  ASSERT_EQ(1, victim);
+  for (auto& mapping : frames[victim].mappings) {
+    mapping.first->page_table.unload_page(mapping.second);
+  }
+  frames[victim].mappings.clear();
+  frame_table.unload_page(victim);
+
+  first->page_table.load_page(1, victim, 4);
+  frame_table.load_page(victim, victim, 4);
+  frames[victim].set_page(first, 1);
+
+  ASSERT_FALSE(second->page_table.rows[1].present);
+  ASSERT_EQ(0, second->get_rss());
+  ASSERT_EQ(2, first->get_rss());
+  ASSERT_EQ(victim, first->page_table.rows[1].frame);
+  ASSERT_EQ(first, frames[victim].process);
+  ASSERT_EQ(1, frames[victim].get_reference_count());
+  ASSERT_EQ(&first->pages[1], frames[victim].contents);
 }
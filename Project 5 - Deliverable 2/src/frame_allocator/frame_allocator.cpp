@@ -0,0 +1,397 @@
+/**
+ * This file contains implementations for methods in the FrameAllocator class
+ * and its backends.
+ */
+
+#include "frame_allocator/frame_allocator.h"
+#include <cassert>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t FrameAllocator::NONE;
+
+
+unique_ptr<FrameAllocator> FrameAllocator::create(Policy policy, size_t num_frames) {
+    switch (policy) {
+        case Policy::STACK:
+            return unique_ptr<FrameAllocator>(new StackFrameAllocator(num_frames));
+
+        case Policy::BITMAP:
+            return unique_ptr<FrameAllocator>(new BitmapFrameAllocator(num_frames));
+
+        case Policy::BUDDY:
+            return unique_ptr<FrameAllocator>(new BuddyFrameAllocator(num_frames));
+    }
+    return nullptr;
+}
+
+
+size_t FrameAllocator::allocate() {
+    if (this->free_count == 0) {
+        this->failed_allocations++;
+        return NONE;
+    }
+
+    this->free_count--;
+    this->allocations++;
+    return this->take();
+}
+
+
+size_t FrameAllocator::allocate_contiguous(size_t count, size_t alignment) {
+    assert(count > 0 && alignment > 0);
+    size_t start = count <= this->free_count ? this->find_run(count, alignment) : NONE;
+    if (start == NONE) {
+        this->failed_allocations++;
+        return NONE;
+    }
+
+    for (size_t frame = start; frame < start + count; frame++) {
+        this->take(frame);
+    }
+    this->free_count -= count;
+    this->allocations += count;
+    return start;
+}
+
+
+void FrameAllocator::reserve(size_t frame) {
+    assert(this->is_free(frame));
+    this->take(frame);
+    this->free_count--;
+    this->allocations++;
+}
+
+
+void FrameAllocator::free(size_t frame) {
+    assert(!this->is_free(frame));
+    this->give(frame);
+    this->free_count++;
+    this->frees++;
+}
+
+
+void FrameAllocator::free_contiguous(size_t frame, size_t count) {
+    for (size_t i = frame; i < frame + count; i++) {
+        this->free(i);
+    }
+}
+
+
+void FrameAllocator::reset() {
+    this->clear();
+    this->free_count = this->num_frames;
+    this->allocations = 0;
+    this->frees = 0;
+    this->failed_allocations = 0;
+}
+
+
+size_t FrameAllocator::get_frame_count() const {
+    return this->num_frames;
+}
+
+
+size_t FrameAllocator::get_free_count() const {
+    return this->free_count;
+}
+
+
+size_t FrameAllocator::get_allocations() const {
+    return this->allocations;
+}
+
+
+size_t FrameAllocator::get_frees() const {
+    return this->frees;
+}
+
+
+size_t FrameAllocator::get_failed_allocations() const {
+    return this->failed_allocations;
+}
+
+
+size_t FrameAllocator::find_run(size_t count, size_t alignment) const {
+    for (size_t start = 0; start + count <= this->num_frames; start += alignment) {
+        size_t length = 0;
+        while (length < count && this->is_free(start + length)) {
+            length++;
+        }
+        if (length == count) {
+            return start;
+        }
+    }
+    return NONE;
+}
+
+
+StackFrameAllocator::StackFrameAllocator(size_t num_frames) : FrameAllocator(num_frames) {
+    this->clear();
+}
+
+
+bool StackFrameAllocator::is_free(size_t frame) const {
+    return this->positions[frame] != NONE;
+}
+
+
+size_t StackFrameAllocator::take() {
+    size_t frame = this->stack.back();
+    this->stack.pop_back();
+    this->positions[frame] = NONE;
+    return frame;
+}
+
+
+void StackFrameAllocator::take(size_t frame) {
+    // move the top of the stack into the frame's place
+    size_t position = this->positions[frame];
+    size_t top = this->stack.back();
+    this->stack[position] = top;
+    this->positions[top] = position;
+
+    this->stack.pop_back();
+    this->positions[frame] = NONE;
+}
+
+
+void StackFrameAllocator::give(size_t frame) {
+    this->positions[frame] = this->stack.size();
+    this->stack.push_back(frame);
+}
+
+
+void StackFrameAllocator::clear() {
+    this->stack.resize(this->num_frames);
+    this->positions.resize(this->num_frames);
+    for (size_t i = 0; i < this->num_frames; i++) {
+        this->stack[i] = this->num_frames - 1 - i;
+        this->positions[this->num_frames - 1 - i] = i;
+    }
+}
+
+
+BitmapFrameAllocator::BitmapFrameAllocator(size_t num_frames) : FrameAllocator(num_frames) {
+    this->clear();
+}
+
+
+bool BitmapFrameAllocator::is_free(size_t frame) const {
+    return (this->words[frame / 64] >> (frame % 64)) & 1;
+}
+
+
+size_t BitmapFrameAllocator::take() {
+    while (this->words[this->first_word] == 0) {
+        this->first_word++;
+    }
+
+    size_t bit = __builtin_ctzll(this->words[this->first_word]);
+    this->words[this->first_word] &= this->words[this->first_word] - 1;
+    return this->first_word * 64 + bit;
+}
+
+
+void BitmapFrameAllocator::take(size_t frame) {
+    this->words[frame / 64] &= ~(uint64_t(1) << (frame % 64));
+}
+
+
+void BitmapFrameAllocator::give(size_t frame) {
+    this->words[frame / 64] |= uint64_t(1) << (frame % 64);
+    this->first_word = min(this->first_word, frame / 64);
+}
+
+
+size_t BitmapFrameAllocator::find_run(size_t count, size_t alignment) const {
+    size_t start = this->first_word * 64;
+    start += (alignment - start % alignment) % alignment;
+
+    while (start + count <= this->num_frames) {
+        if (this->is_run_free(start, count)) {
+            return start;
+        }
+        start += alignment;
+    }
+    return NONE;
+}
+
+
+bool BitmapFrameAllocator::is_run_free(size_t frame, size_t count) const {
+    size_t end = frame + count;
+    while (frame < end) {
+        // check up to the end of the run or of the word, whichever is first
+        size_t bits = min(64 - frame % 64, end - frame);
+        uint64_t mask = bits == 64 ? ~uint64_t(0) : ((uint64_t(1) << bits) - 1) << (frame % 64);
+        if ((this->words[frame / 64] & mask) != mask) {
+            return false;
+        }
+        frame += bits;
+    }
+    return true;
+}
+
+
+void BitmapFrameAllocator::clear() {
+    this->words.assign((this->num_frames + 63) / 64, ~uint64_t(0));
+    if (this->num_frames % 64 != 0) {
+        this->words.back() = (uint64_t(1) << (this->num_frames % 64)) - 1;
+    }
+    this->first_word = 0;
+}
+
+
+BuddyFrameAllocator::BuddyFrameAllocator(size_t num_frames) : FrameAllocator(num_frames) {
+    while ((size_t(2) << this->max_order) <= num_frames) {
+        this->max_order++;
+    }
+    this->clear();
+}
+
+
+bool BuddyFrameAllocator::is_free(size_t frame) const {
+    return this->free_frames[frame];
+}
+
+
+size_t BuddyFrameAllocator::get_block_count(size_t order) const {
+    size_t count = 0;
+    for (size_t block = this->heads[order]; block != NONE; block = this->next[block]) {
+        count++;
+    }
+    return count;
+}
+
+
+size_t BuddyFrameAllocator::take() {
+    size_t order = 0;
+    while (this->heads[order] == NONE) {
+        order++;
+    }
+
+    // split the block, keeping its first frame
+    size_t frame = this->heads[order];
+    this->remove_block(frame);
+    while (order > 0) {
+        order--;
+        this->push_block(frame + (size_t(1) << order), order);
+    }
+
+    this->free_frames[frame] = false;
+    return frame;
+}
+
+
+void BuddyFrameAllocator::take(size_t frame) {
+    // find the free block holding the frame
+    size_t order = 0;
+    size_t block = frame;
+    while (this->orders[block] != order) {
+        order++;
+        block = frame & ~((size_t(1) << order) - 1);
+    }
+
+    // split it, freeing the halves without the frame
+    this->remove_block(block);
+    while (order > 0) {
+        order--;
+        size_t half = size_t(1) << order;
+        if (frame < block + half) {
+            this->push_block(block + half, order);
+        } else {
+            this->push_block(block, order);
+            block += half;
+        }
+    }
+
+    this->free_frames[frame] = false;
+}
+
+
+void BuddyFrameAllocator::give(size_t frame) {
+    this->free_frames[frame] = true;
+
+    // merge with the buddy for as long as it is a whole free block
+    size_t order = 0;
+    while (order < this->max_order) {
+        size_t buddy = frame ^ (size_t(1) << order);
+        if (buddy >= this->num_frames || this->orders[buddy] != order) {
+            break;
+        }
+        this->remove_block(buddy);
+        frame = min(frame, buddy);
+        order++;
+    }
+    this->push_block(frame, order);
+}
+
+
+size_t BuddyFrameAllocator::find_run(size_t count, size_t alignment) const {
+    // a block of the run's size, aligned to it, is a matter of finding a
+    // large enough free block; anything else has to be searched for
+    size_t order = 0;
+    while ((size_t(1) << order) < count) {
+        order++;
+    }
+    if ((size_t(1) << order) != count || count % alignment != 0) {
+        return FrameAllocator::find_run(count, alignment);
+    }
+
+    for (; order <= this->max_order; order++) {
+        if (this->heads[order] != NONE) {
+            return this->heads[order];
+        }
+    }
+    return NONE;
+}
+
+
+void BuddyFrameAllocator::clear() {
+    this->heads.assign(this->max_order + 1, NONE);
+    this->next.assign(this->num_frames, NONE);
+    this->prev.assign(this->num_frames, NONE);
+    this->orders.assign(this->num_frames, NONE);
+    this->free_frames.assign(this->num_frames, true);
+
+    // cover the frames with the largest aligned blocks that fit, pushing the
+    // lowest ones last so that they are at the top of their free lists
+    vector<pair<size_t, size_t>> blocks;
+    for (size_t frame = 0; frame < this->num_frames;) {
+        size_t order = this->max_order;
+        while (frame % (size_t(1) << order) != 0 || frame + (size_t(1) << order) > this->num_frames) {
+            order--;
+        }
+        blocks.emplace_back(frame, order);
+        frame += size_t(1) << order;
+    }
+    for (auto block = blocks.rbegin(); block != blocks.rend(); block++) {
+        this->push_block(block->first, block->second);
+    }
+}
+
+
+void BuddyFrameAllocator::push_block(size_t frame, size_t order) {
+    this->orders[frame] = order;
+    this->prev[frame] = NONE;
+    this->next[frame] = this->heads[order];
+    if (this->heads[order] != NONE) {
+        this->prev[this->heads[order]] = frame;
+    }
+    this->heads[order] = frame;
+}
+
+
+void BuddyFrameAllocator::remove_block(size_t frame) {
+    size_t order = this->orders[frame];
+    if (this->prev[frame] != NONE) {
+        this->next[this->prev[frame]] = this->next[frame];
+    } else {
+        this->heads[order] = this->next[frame];
+    }
+    if (this->next[frame] != NONE) {
+        this->prev[this->next[frame]] = this->prev[frame];
+    }
+    this->orders[frame] = NONE;
+}
@@ -0,0 +1,313 @@
+/**
+ * This file contains the definition of the FrameAllocator class and the
+ * backends that implement it.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Hands out the free frames of main memory and takes them back. A frame is
+ * either free or allocated; the backends differ in which free frame they hand
+ * out next and in how cheaply they find a run of contiguous free frames.
+ *
+ * Allocations, frees and allocations that found no free frame are counted,
+ * until the next reset().
+ */
+class FrameAllocator {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The frame reported when there is none.
+    */
+    static const size_t NONE = -1;
+
+    /**
+    * The backends an allocator can be created with.
+    */
+    enum class Policy {
+        STACK,
+        BITMAP,
+        BUDDY
+    };
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Returns a new allocator using the given backend, managing num_frames
+    * frames that all start out free.
+    */
+    static std::unique_ptr<FrameAllocator> create(Policy policy, size_t num_frames);
+
+    /**
+    * Destructor.
+    */
+    virtual ~FrameAllocator() {}
+
+    /**
+    * Allocates a free frame and returns it, or NONE if every frame is in use.
+    */
+    size_t allocate();
+
+    /**
+    * Allocates count contiguous free frames, the first a multiple of
+    * alignment, and returns the first of them, or NONE if there is no such
+    * run.
+    */
+    size_t allocate_contiguous(size_t count, size_t alignment = 1);
+
+    /**
+    * Allocates the given frame, which must be free.
+    */
+    void reserve(size_t frame);
+
+    /**
+    * Returns the given allocated frame to the free frames.
+    */
+    void free(size_t frame);
+
+    /**
+    * Returns count contiguous allocated frames, starting at the given one.
+    */
+    void free_contiguous(size_t frame, size_t count);
+
+    /**
+    * Frees every frame and zeroes the counters.
+    */
+    void reset();
+
+    /**
+    * Returns whether the given frame is free.
+    */
+    virtual bool is_free(size_t frame) const = 0;
+
+    /**
+    * Returns the number of frames managed, and how many of them are free.
+    */
+    size_t get_frame_count() const;
+    size_t get_free_count() const;
+
+    /**
+    * Returns the number of frames allocated and freed, and the number of
+    * allocations that failed, since the last reset().
+    */
+    size_t get_allocations() const;
+    size_t get_frees() const;
+    size_t get_failed_allocations() const;
+
+// PROTECTED METHODS
+protected:
+
+    /**
+    * Constructor.
+    */
+    FrameAllocator(size_t num_frames) : num_frames(num_frames), free_count(num_frames) {}
+
+    /**
+    * Takes a free frame out of the backend, which has at least one.
+    */
+    virtual size_t take() = 0;
+
+    /**
+    * Takes the given free frame out of the backend.
+    */
+    virtual void take(size_t frame) = 0;
+
+    /**
+    * Puts the given allocated frame back into the backend.
+    */
+    virtual void give(size_t frame) = 0;
+
+    /**
+    * Finds count contiguous free frames starting at a multiple of alignment,
+    * without taking them. By default, checks every aligned start in turn.
+    */
+    virtual size_t find_run(size_t count, size_t alignment) const;
+
+    /**
+    * Makes every frame free again.
+    */
+    virtual void clear() = 0;
+
+    /**
+    * The number of frames managed.
+    */
+    const size_t num_frames;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The number of frames currently free.
+    */
+    size_t free_count;
+
+    /**
+    * The counters since the last reset().
+    */
+    size_t allocations = 0;
+    size_t frees = 0;
+    size_t failed_allocations = 0;
+};
+
+
+/**
+ * Keeps the free frames on a stack, so allocating and freeing a frame is a
+ * single push or pop and the most recently freed frame is reused first. The
+ * stack starts out with the lowest frame on top, so frames are first handed
+ * out in order.
+ */
+class StackFrameAllocator : public FrameAllocator {
+public:
+
+    /**
+    * Constructor.
+    */
+    StackFrameAllocator(size_t num_frames);
+
+    bool is_free(size_t frame) const override;
+
+protected:
+
+    size_t take() override;
+
+    void take(size_t frame) override;
+
+    void give(size_t frame) override;
+
+    void clear() override;
+
+private:
+
+    /**
+    * The free frames, the next to be allocated last.
+    */
+    std::vector<size_t> stack;
+
+    /**
+    * The index of each frame in the stack, or NONE if it is allocated, so
+    * that any frame can be taken out of the middle.
+    */
+    std::vector<size_t> positions;
+};
+
+
+/**
+ * Keeps one bit per frame, set while it is free, and always allocates the
+ * lowest free frame using a find-first-set over 64 frames at a time. Runs of
+ * contiguous frames are found a word at a time as well, which makes this the
+ * backend for allocations of more than one frame.
+ */
+class BitmapFrameAllocator : public FrameAllocator {
+public:
+
+    /**
+    * Constructor.
+    */
+    BitmapFrameAllocator(size_t num_frames);
+
+    bool is_free(size_t frame) const override;
+
+protected:
+
+    size_t take() override;
+
+    void take(size_t frame) override;
+
+    void give(size_t frame) override;
+
+    size_t find_run(size_t count, size_t alignment) const override;
+
+    void clear() override;
+
+private:
+
+    /**
+    * Returns whether count frames starting at the given one are all free.
+    */
+    bool is_run_free(size_t frame, size_t count) const;
+
+    /**
+    * The free bits, 64 frames per word.
+    */
+    std::vector<uint64_t> words;
+
+    /**
+    * No word before this one has a free frame.
+    */
+    size_t first_word = 0;
+};
+
+
+/**
+ * A binary buddy allocator, keeping free memory as aligned blocks of 2^order
+ * frames on one free list per order. An allocation splits the smallest block
+ * large enough in halves until it fits, and a freed frame merges with its
+ * buddy for as long as the buddy is free too, so aligned runs of a power of
+ * two frames are found without any scanning.
+ */
+class BuddyFrameAllocator : public FrameAllocator {
+public:
+
+    /**
+    * Constructor.
+    */
+    BuddyFrameAllocator(size_t num_frames);
+
+    bool is_free(size_t frame) const override;
+
+    /**
+    * Returns the number of free blocks of the given order.
+    */
+    size_t get_block_count(size_t order) const;
+
+protected:
+
+    size_t take() override;
+
+    void take(size_t frame) override;
+
+    void give(size_t frame) override;
+
+    size_t find_run(size_t count, size_t alignment) const override;
+
+    void clear() override;
+
+private:
+
+    /**
+    * Adds the block of the given order starting at the given frame to its
+    * free list, or removes it.
+    */
+    void push_block(size_t frame, size_t order);
+    void remove_block(size_t frame);
+
+    /**
+    * The order of the largest block.
+    */
+    size_t max_order = 0;
+
+    /**
+    * The first free block of each order.
+    */
+    std::vector<size_t> heads;
+
+    /**
+    * For the first frame of each free block: the neighbouring blocks on its
+    * free list, and its order (or NONE for any other frame).
+    */
+    std::vector<size_t> next;
+    std::vector<size_t> prev;
+    std::vector<size_t> orders;
+
+    /**
+    * Whether each frame is free.
+    */
+    std::vector<bool> free_frames;
+};
@@ -0,0 +1,140 @@
+/**
+ * This file contains tests for the FrameAllocator class and its backends.
+ */
+
+#include "frame_allocator/frame_allocator.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(FrameAllocator, Create) {
+  ASSERT_NE(nullptr, dynamic_cast<StackFrameAllocator*>(FrameAllocator::create(FrameAllocator::Policy::STACK, 4).get()));
+  ASSERT_NE(nullptr, dynamic_cast<BitmapFrameAllocator*>(FrameAllocator::create(FrameAllocator::Policy::BITMAP, 4).get()));
+}
+
+
+TEST(FrameAllocator, Counters) {
+  for (auto policy : {FrameAllocator::Policy::STACK, FrameAllocator::Policy::BITMAP}) {
+    unique_ptr<FrameAllocator> allocator = FrameAllocator::create(policy, 2);
+
+    ASSERT_EQ(0, allocator->allocate());
+    ASSERT_EQ(1, allocator->allocate());
+    ASSERT_EQ(FrameAllocator::NONE, allocator->allocate());
+    ASSERT_EQ(0, allocator->get_free_count());
+
+    allocator->free(0);
+    ASSERT_TRUE(allocator->is_free(0));
+    ASSERT_EQ(1, allocator->get_free_count());
+    ASSERT_EQ(2, allocator->get_allocations());
+    ASSERT_EQ(1, allocator->get_frees());
+    ASSERT_EQ(1, allocator->get_failed_allocations());
+
+    allocator->reset();
+    ASSERT_EQ(2, allocator->get_free_count());
+    ASSERT_EQ(0, allocator->get_allocations());
+    ASSERT_EQ(0, allocator->get_frees());
+    ASSERT_EQ(0, allocator->get_failed_allocations());
+  }
+}
+
+
+TEST(StackFrameAllocator, ReusesLastFreed) {
+  StackFrameAllocator allocator(4);
+  for (size_t i = 0; i < 4; i++) {
+    ASSERT_EQ(i, allocator.allocate());
+  }
+
+  allocator.free(1);
+  allocator.free(3);
+  ASSERT_EQ(3, allocator.allocate());
+  ASSERT_EQ(1, allocator.allocate());
+}
+
+
+TEST(StackFrameAllocator, Reserve) {
+  StackFrameAllocator allocator(4);
+  allocator.reserve(0);
+  allocator.reserve(2);
+  ASSERT_FALSE(allocator.is_free(2));
+
+  ASSERT_EQ(1, allocator.allocate());
+  ASSERT_EQ(3, allocator.allocate());
+  ASSERT_EQ(FrameAllocator::NONE, allocator.allocate());
+}
+
+
+TEST(BitmapFrameAllocator, AllocatesLowestFree) {
+  BitmapFrameAllocator allocator(200);
+  for (size_t i = 0; i < 200; i++) {
+    ASSERT_EQ(i, allocator.allocate());
+  }
+
+  allocator.free(150);
+  allocator.free(70);
+  ASSERT_EQ(70, allocator.allocate());
+  ASSERT_EQ(150, allocator.allocate());
+  ASSERT_EQ(FrameAllocator::NONE, allocator.allocate());
+}
+
+
+TEST(BitmapFrameAllocator, AllocateContiguous) {
+  BitmapFrameAllocator allocator(256);
+  allocator.reserve(3);
+  allocator.reserve(100);
+
+  // the run skips the reserved frame, and can cross a word
+  ASSERT_EQ(4, allocator.allocate_contiguous(4));
+  ASSERT_EQ(32, allocator.allocate_contiguous(32, 32));
+  ASSERT_EQ(128, allocator.allocate_contiguous(70, 64));
+  ASSERT_FALSE(allocator.is_free(197));
+  ASSERT_TRUE(allocator.is_free(198));
+
+  // no free run of 64 aligned frames is left
+  ASSERT_EQ(FrameAllocator::NONE, allocator.allocate_contiguous(64, 64));
+  ASSERT_EQ(1, allocator.get_failed_allocations());
+
+  allocator.free_contiguous(128, 70);
+  ASSERT_EQ(128, allocator.allocate_contiguous(64, 64));
+  ASSERT_EQ(256 - 2 - 4 - 32 - 64, allocator.get_free_count());
+}
+
+
+TEST(BuddyFrameAllocator, SplitsAndMerges) {
+  BuddyFrameAllocator allocator(16);
+  ASSERT_EQ(1, allocator.get_block_count(4));
+
+  // the first frame splits the block all the way down
+  ASSERT_EQ(0, allocator.allocate());
+  for (size_t order = 0; order < 4; order++) {
+    ASSERT_EQ(1, allocator.get_block_count(order));
+  }
+  ASSERT_EQ(0, allocator.get_block_count(4));
+
+  // and freeing it merges the halves back up
+  allocator.free(0);
+  ASSERT_EQ(0, allocator.get_block_count(0));
+  ASSERT_EQ(1, allocator.get_block_count(4));
+}
+
+
+TEST(BuddyFrameAllocator, AllocateContiguous) {
+  BuddyFrameAllocator allocator(24);
+  allocator.reserve(5);
+
+  // aligned powers of two come from the smallest block large enough
+  ASSERT_EQ(8, allocator.allocate_contiguous(8, 8));
+  ASSERT_EQ(0, allocator.allocate_contiguous(4, 4));
+  ASSERT_EQ(16, allocator.allocate_contiguous(4, 4));
+  ASSERT_EQ(20, allocator.allocate_contiguous(4, 4));
+  ASSERT_EQ(FrameAllocator::NONE, allocator.allocate_contiguous(4, 4));
+
+  // other runs are searched for
+  ASSERT_EQ(FrameAllocator::NONE, allocator.allocate_contiguous(3));
+  ASSERT_EQ(6, allocator.allocate_contiguous(2));
+  ASSERT_EQ(1, allocator.get_free_count());
+
+  // frees of single frames merge into whole blocks again
+  allocator.free_contiguous(16, 8);
+  ASSERT_EQ(1, allocator.get_block_count(3));
+}
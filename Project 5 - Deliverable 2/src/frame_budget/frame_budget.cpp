@@ -0,0 +1,47 @@
+/**
+ * This file contains implementations for methods in the FrameBudget class.
+ */
+
+#include "frame_budget/frame_budget.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+
+FrameBudget::FrameBudget(size_t window, double low, double high, size_t num_frames)
+    : window(window), low(low), high(high), num_frames(num_frames)
+{
+    assert(window > 0 && num_frames > 0);
+}
+
+
+size_t FrameBudget::get_expired_frame(const PageTable& frame_table, size_t time) const {
+    // the least recently used frame holds the page that left a working set
+    // first, if any has
+    if (frame_table.get_present_page_count() == 0) {
+        return PageTable::NONE;
+    }
+    size_t frame = frame_table.get_least_recently_used_page();
+    if (frame_table.rows[frame].last_accessed_at + this->window > time) {
+        return PageTable::NONE;
+    }
+    return frame;
+}
+
+
+bool FrameBudget::is_window_end(size_t accesses) const {
+    return accesses % this->window == 0;
+}
+
+
+size_t FrameBudget::adjust(size_t budget, size_t window_faults) const {
+    double fault_rate = (double) window_faults / this->window;
+    size_t step = max<size_t>(1, budget / 4);
+    if (fault_rate > this->high) {
+        return min<size_t>(budget + step, this->num_frames);
+    } else if (fault_rate < this->low && budget > 1) {
+        return max<size_t>(1, budget - step);
+    }
+    return budget;
+}
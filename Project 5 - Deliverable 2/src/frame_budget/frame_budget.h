@@ -0,0 +1,64 @@
+/**
+ * This file contains the definition of the FrameBudget class.
+ */
+
+#pragma once
+#include "page_table/page_table.h"
+#include <cstdlib>
+
+
+/**
+ * The decisions behind the variable frame allocators, kept apart from the
+ * simulation that carries them out.
+ *
+ * Under the working-set allocator, a page belongs to its process's working set
+ * for a window of accesses after it was last touched, and its frame is taken
+ * back once it falls out. Under the page-fault-frequency allocator, each
+ * process's budget is revisited at the end of every window of its own
+ * accesses: a fault rate above the high threshold grows it by a quarter, and
+ * one below the low threshold shrinks it by a quarter (by at least one frame
+ * either way).
+ */
+class FrameBudget {
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. Budgets never grow beyond num_frames.
+    */
+    FrameBudget(size_t window, double low, double high, size_t num_frames);
+
+    /**
+    * Returns the least recently used frame in the given frame table if its
+    * page has dropped out of its working set by the given time, or
+    * PageTable::NONE if every page is still in one.
+    */
+    size_t get_expired_frame(const PageTable& frame_table, size_t time) const;
+
+    /**
+    * Returns true if a process's given number of accesses ends one of its
+    * windows.
+    */
+    bool is_window_end(size_t accesses) const;
+
+    /**
+    * Returns the budget a process should have from now on, given the budget
+    * it held and the number of faults it took over the window just ended.
+    */
+    size_t adjust(size_t budget, size_t window_faults) const;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The window, in accesses, and the fault-rate thresholds.
+    */
+    size_t window;
+    double low;
+    double high;
+
+    /**
+    * The most frames a budget can grow to.
+    */
+    size_t num_frames;
+};
@@ -0,0 +1,101 @@
+/**
+ * This file contains tests for the FrameBudget class.
+ */
+
+#include "frame_budget/frame_budget.h"
+#include "frame_allocator/frame_allocator.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(FrameBudget, ReleasesPagesOutsideTheWindow) {
+  FrameBudget budget(10, 0.1, 0.5, 4);
+  unique_ptr<FrameAllocator> allocator = FrameAllocator::create(FrameAllocator::Policy::STACK, 4);
+  PageTable frame_table(4);
+
+  // pages last touched at times 0, 3, 5 and 12
+  size_t touched[] = {0, 3, 5, 12};
+  for (size_t time : touched) {
+    size_t frame = allocator->allocate();
+    frame_table.load_page(frame, frame, time);
+  }
+
+  // at time 14, the window covers times 5 through 14
+  size_t frame;
+  while ((frame = budget.get_expired_frame(frame_table, 14)) != PageTable::NONE) {
+    frame_table.unload_page(frame);
+    allocator->free(frame);
+  }
+
+  ASSERT_EQ(2, allocator->get_free_count());
+  ASSERT_FALSE(frame_table.rows[0].present);
+  ASSERT_FALSE(frame_table.rows[1].present);
+  ASSERT_TRUE(frame_table.rows[2].present);
+  ASSERT_TRUE(frame_table.rows[3].present);
+
+  // a page touched exactly a window ago has just left
+  ASSERT_EQ(2, budget.get_expired_frame(frame_table, 15));
+}
+
+
+TEST(FrameBudget, NothingExpiresFromAnEmptyTable) {
+  FrameBudget budget(10, 0.1, 0.5, 4);
+  PageTable frame_table(4);
+
+  ASSERT_EQ(PageTable::NONE, budget.get_expired_frame(frame_table, 100));
+}
+
+
+TEST(FrameBudget, WindowEnds) {
+  FrameBudget budget(10, 0.1, 0.5, 4);
+
+  ASSERT_FALSE(budget.is_window_end(9));
+  ASSERT_TRUE(budget.is_window_end(10));
+  ASSERT_FALSE(budget.is_window_end(11));
+  ASSERT_TRUE(budget.is_window_end(20));
+}
+
+
+TEST(FrameBudget, AdjustsAtTheThresholds) {
+  FrameBudget budget(100, 0.1, 0.5, 64);
+
+  // rates of 0.1 to 0.5 leave the budget alone
+  ASSERT_EQ(16, budget.adjust(16, 10));
+  ASSERT_EQ(16, budget.adjust(16, 50));
+
+  // above the high threshold the budget grows by a quarter, up to the frames
+  ASSERT_EQ(20, budget.adjust(16, 51));
+  ASSERT_EQ(64, budget.adjust(60, 100));
+  ASSERT_EQ(2, budget.adjust(1, 100));
+
+  // below the low threshold it shrinks by a quarter, down to one frame
+  ASSERT_EQ(12, budget.adjust(16, 9));
+  ASSERT_EQ(1, budget.adjust(2, 0));
+  ASSERT_EQ(1, budget.adjust(1, 0));
+}
+
+
+TEST(FrameBudget, ShrinkingGivesFramesBack) {
+  FrameBudget budget(100, 0.1, 0.5, 8);
+  unique_ptr<FrameAllocator> allocator = FrameAllocator::create(FrameAllocator::Policy::STACK, 8);
+  PageTable page_table(8);
+  for (size_t page = 0; page < 8; page++) {
+    page_table.load_page(page, allocator->allocate(), page);
+  }
+
+  // a quiet window takes the budget from 8 down to 6, and the two least
+  // recently used pages go back to the allocator
+  size_t new_budget = budget.adjust(8, 0);
+  ASSERT_EQ(6, new_budget);
+  while (page_table.get_present_page_count() > new_budget) {
+    size_t page = page_table.get_least_recently_used_page();
+    allocator->free(page_table.rows[page].frame);
+    page_table.unload_page(page);
+  }
+
+  ASSERT_EQ(2, allocator->get_free_count());
+  ASSERT_FALSE(page_table.rows[0].present);
+  ASSERT_FALSE(page_table.rows[1].present);
+  ASSERT_TRUE(page_table.rows[2].present);
+}
@@ -8,6 +8,8 @@
 
 #include "flag_parser/flag_parser.h"
 #include "simulation/simulation.h"
+#include "binary_trace/binary_trace.h"
+#include "trace_sink/trace_sink.h"
 
 using namespace std;
 
@@ -25,6 +27,14 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (!flags.convert_output.empty()) {
+        return convert_trace(flags.filename, flags.convert_output) ? 1 : EXIT_SUCCESS;
+    }
+
+    if (flags.decode_events) {
+        return decode_event_log(flags.filename, std::cout) ? 1 : EXIT_SUCCESS;
+    }
+
     Simulation sim(flags);
 
     int error = 0;
@@ -35,7 +45,12 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    sim.run();
-    
+    error = sim.run();
+
+    if (error) {
+        std::cout << "ERROR READING FILE" << std::endl;
+        return 1;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,58 @@
+/**
+ * This file contains implementations for methods in the MappedFile class.
+ */
+
+#include "mapped_file/mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+shared_ptr<MappedFile> MappedFile::open(const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return nullptr;
+    }
+
+    // mmap refuses empty mappings, but an empty file is still a valid file
+    size_t num_bytes = info.st_size;
+    void* bytes = nullptr;
+    if (num_bytes > 0) {
+        bytes = mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (bytes == MAP_FAILED) {
+            close(fd);
+            return nullptr;
+        }
+        madvise(bytes, num_bytes, MADV_SEQUENTIAL);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+    return shared_ptr<MappedFile>(new MappedFile(static_cast<const char*>(bytes), num_bytes));
+}
+
+
+MappedFile::~MappedFile() {
+    if (this->bytes != nullptr) {
+        munmap(const_cast<char*>(this->bytes), this->num_bytes);
+    }
+}
+
+
+const char* MappedFile::data() const {
+    return this->bytes;
+}
+
+
+size_t MappedFile::size() const {
+    return this->num_bytes;
+}
@@ -0,0 +1,62 @@
+/**
+ * This file contains the definition of the MappedFile class.
+ */
+
+#pragma once
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+
+/**
+ * A read-only memory mapping of an entire file, unmapped on destruction.
+ */
+class MappedFile {
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Maps the file at the given path. Returns nullptr if the file could not be
+    * opened or mapped.
+    */
+    static std::shared_ptr<MappedFile> open(const std::string& path);
+
+    /**
+    * Destructor.
+    */
+    ~MappedFile();
+
+    /**
+    * Returns the first byte of the mapping (nullptr for an empty file).
+    */
+    const char* data() const;
+
+    /**
+    * Returns the size of the file, in bytes.
+    */
+    size_t size() const;
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Private constructor.
+    */
+    MappedFile(const char* bytes, size_t num_bytes) : bytes(bytes), num_bytes(num_bytes) {}
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator =(const MappedFile&) = delete;
+
+// CLASS INSTANCE VARIABLES
+private:
+
+    /**
+    * The mapped bytes.
+    */
+    const char* bytes;
+
+    /**
+    * The number of mapped bytes.
+    */
+    size_t num_bytes;
+};
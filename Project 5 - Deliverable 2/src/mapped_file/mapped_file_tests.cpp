@@ -0,0 +1,51 @@
+/**
+ * This file contains tests for the MappedFile class.
+ */
+
+#include "mapped_file/mapped_file.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+
+
+/**
+ * Writes the given contents to a fresh temporary file and returns its path.
+ */
+string write_temp_file(const string& contents) {
+  char path[] = "/tmp/mapped_file_testXXXXXX";
+  close(mkstemp(path));
+
+  ofstream out(path, ios::binary);
+  out << contents;
+  return path;
+}
+
+
+TEST(MappedFile, Contents) {
+  string path = write_temp_file(string("ALL YOUR BASE\0ARE BELONG", 24));
+  shared_ptr<MappedFile> file = MappedFile::open(path);
+  remove(path.c_str());
+
+  ASSERT_NE(nullptr, file);
+  ASSERT_EQ(24, file->size());
+  ASSERT_EQ(string("ALL YOUR BASE\0ARE BELONG", 24), string(file->data(), file->size()));
+}
+
+
+TEST(MappedFile, EmptyFile) {
+  string path = write_temp_file("");
+  shared_ptr<MappedFile> file = MappedFile::open(path);
+  remove(path.c_str());
+
+  ASSERT_NE(nullptr, file);
+  ASSERT_EQ(0, file->size());
+}
+
+
+TEST(MappedFile, MissingFile) {
+  ASSERT_EQ(nullptr, MappedFile::open("/nonexistent/mapped_file_test"));
+}
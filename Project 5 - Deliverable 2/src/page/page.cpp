@@ -5,33 +5,22 @@
  */
 
 #include "page/page.h"
+#include <cstring>
 
 using namespace std;
 
 // Ensure PAGE_SIZE is initialized.
 const size_t Page::PAGE_SIZE;
 
-Page* Page::read_from_input(std::istream& in) {
-    // Read at most PAGE_SIZE bytes into a buffer.
-    char bytes_buffer[PAGE_SIZE];
-    in.read(bytes_buffer, PAGE_SIZE);
-
-    // If nothing was read, return a null pointer.
-    if (in.gcount() == 0) {
-        return nullptr;
-    }
-
-    // Create a vector of characters for simplicity.
-    vector<char> bytes = vector<char>(bytes_buffer, bytes_buffer + in.gcount());
-
-    return new Page(bytes);
+Page Page::from_bytes(const char* bytes, size_t available) {
+    // view at most PAGE_SIZE bytes
+    return Page(bytes, available < PAGE_SIZE ? available : PAGE_SIZE);
 }
 
 
 size_t Page::size() const
 {
-    size_t size = bytes.size();
-    return size;
+    return this->num_bytes;
 }
 
 
@@ -46,8 +35,30 @@ bool Page::is_valid_offset(size_t offset) const
 }
 
 
-char Page::get_byte_at_offset(size_t offset)
+char Page::get_byte_at_offset(size_t offset) const
+{
+    return this->bytes[offset];
+}
+
+
+const char* Page::data() const
+{
+    return this->bytes;
+}
+
+
+uint64_t Page::hash() const
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < this->num_bytes; i++) {
+        hash = (hash ^ (unsigned char) this->bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+
+bool Page::has_same_contents(const Page& other) const
 {
-    char byte = this->bytes.at(offset);
-    return byte;
+    return this->num_bytes == other.num_bytes
+        && (this->num_bytes == 0 || memcmp(this->bytes, other.bytes, this->num_bytes) == 0);
 }
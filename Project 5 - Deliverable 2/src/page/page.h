@@ -4,13 +4,14 @@
 
 #pragma once
 #include "virtual_address/virtual_address.h"
+#include <cstdint>
 #include <cstdlib>
-#include <istream>
-#include <vector>
 
 
 /**
- * Represents a single page of a process.
+ * Represents a single page of a process, as a view into the process image. The
+ * bytes are owned by the process the page belongs to, which keeps its image
+ * mapped (or buffered) for as long as the page exists.
  */
 class Page {
 // PUBLIC CONSTANTS
@@ -25,15 +26,14 @@ public:
 public:
 
     /**
-    * Consumes from the given istream at most PAGE_SIZE bytes and returns a new
-    * Page instance containing those bytes. If the istream is empty, NULL is
-    * returned instead.
+    * Returns a page viewing the first PAGE_SIZE bytes of the given buffer, or
+    * all of them if there are fewer than that.
     */
-    static Page* read_from_input(std::istream& in);
+    static Page from_bytes(const char* bytes, size_t available);
 
     /**
     * Returns the number of bytes present in this page, which should always be a
-    * number in the range [0, PAGE_SIZE).
+    * number in the range [0, PAGE_SIZE].
     */
     size_t size() const;
 
@@ -45,10 +45,26 @@ public:
     bool is_valid_offset(size_t offset) const;
 
     /**
-    * Returns a reference to the byte at the given offset. Should only be called
-    * if is_valid_offset returns true for the offset.
+    * Returns the byte at the given offset. Should only be called if
+    * is_valid_offset returns true for the offset.
     */
-    char get_byte_at_offset(size_t offset);
+    char get_byte_at_offset(size_t offset) const;
+
+    /**
+    * Returns the first byte of this page.
+    */
+    const char* data() const;
+
+    /**
+    * Returns a hash of the bytes of this page (64-bit FNV-1a), so pages with
+    * the same contents always hash the same.
+    */
+    uint64_t hash() const;
+
+    /**
+    * Returns true if the given page holds exactly the same bytes as this one.
+    */
+    bool has_same_contents(const Page& other) const;
 
 // PRIVATE METHODS
 private:
@@ -56,13 +72,18 @@ private:
     /**
     * Private constructor.
     */
-    Page(std::vector<char> bytes) : bytes(bytes) {}
+    Page(const char* bytes, size_t num_bytes) : bytes(bytes), num_bytes(num_bytes) {}
 
 // CLASS INSTANCE VARIABLES
 private:
 
     /**
-    * The bytes this page contains.
+    * The first byte of this page within the process image.
+    */
+    const char* bytes;
+
+    /**
+    * The number of bytes this page contains.
     */
-    std::vector<char> bytes;
+    size_t num_bytes;
 };
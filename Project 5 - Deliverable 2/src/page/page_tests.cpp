@@ -6,111 +6,128 @@
 
 #include "page/page.h"
 #include "gtest/gtest.h"
-#include <sstream>
+#include <string>
 
 using namespace std;
 
 
-TEST(Page, ReadFromInput_EmptyStream) {
-  istringstream empty_stream;
+TEST(Page, FromBytes_EmptyBuffer) {
+  Page page = Page::from_bytes(nullptr, 0);
 
-  Page* page = Page::read_from_input(empty_stream);
-
-  // Reading from an empty stream should return null, to indicate that the
-  // input stream has been fully consumed.
-  ASSERT_EQ(nullptr, page);
+  // A page over an empty buffer has no valid offsets.
+  ASSERT_EQ(0, page.size());
+  ASSERT_FALSE(page.is_valid_offset(0));
 }
 
 
-TEST(Page, ReadFromInput_StreamContainsLessThanFullPage) {
+TEST(Page, FromBytes_BufferContainsLessThanFullPage) {
   string contents = "AY3SmKknrmqdulbnXYZRtXnuQ5";
-  istringstream input_stream(contents);
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  // Reading from a stream that contains less than a full page of bytes should
-  // consume the entire stream.
-  ASSERT_EQ(contents.length(), page->size());
+  // A page over less than a full page of bytes should view the entire buffer.
+  ASSERT_EQ(contents.length(), page.size());
 }
 
 
-TEST(Page, ReadFromInput_StreamContainsMoreThanFullPage) {
-  istringstream input_stream(
+TEST(Page, FromBytes_BufferContainsMoreThanFullPage) {
+  string contents =
       "AY3SmKknrmqdulbnXYZRtXnuQ571pA5HXAeB8qh0qR6n6yo303tdkAO9fZYWPLX3"
-      "1L_hUt1yI8nL4EkC0NMNm8pSKdVu5m7qDvfbXdHC");
+      "1L_hUt1yI8nL4EkC0NMNm8pSKdVu5m7qDvfbXdHC";
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  // Reading from a stream that contains more than a full page of bytes should
-  // consume only Page::PAGE_SIZE total bytes from the stream.
-  ASSERT_EQ(Page::PAGE_SIZE, page->size());
+  // A page over more than a full page of bytes should view only
+  // Page::PAGE_SIZE bytes, starting at the front of the buffer.
+  ASSERT_EQ(Page::PAGE_SIZE, page.size());
+  ASSERT_EQ(contents.data(), page.data());
 }
 
 
-TEST(Page, ReadFromInput_StreamContainsNullCharacters) {
-  stringstream input_stream;
-
-  // Populate the stream with some null characters.
-  input_stream << '\0' << '1' << '\0' << '2' << '\0';
+TEST(Page, FromBytes_BufferContainsNullCharacters) {
+  // Populate the buffer with some null characters.
+  string contents("\0" "1" "\0" "2" "\0", 5);
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  // The stream should include every character (byte) present in the stream.
-  ASSERT_EQ(5, page->size());
+  // The page should include every character (byte) present in the buffer.
+  ASSERT_EQ(5, page.size());
 }
 
 
-TEST(Page, ReadFromInput_StreamContainsWhitespaceCharacters) {
+TEST(Page, FromBytes_BufferContainsWhitespaceCharacters) {
   string contents = "im in ur base killing ur d00dz";
-  istringstream input_stream(contents);
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  // The page should have all characters from the stream, including whitespace.
-  ASSERT_EQ(contents.length(), page->size());
+  // The page should have all characters from the buffer, including whitespace.
+  ASSERT_EQ(contents.length(), page.size());
 }
 
 
 TEST(Page, IsValidOffset_ValidValue) {
   string contents = "im in ur base killing ur d00dz";
-  istringstream input_stream(contents);
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  ASSERT_TRUE(page->is_valid_offset(0));
-  ASSERT_TRUE(page->is_valid_offset(contents.length() - 1));
+  ASSERT_TRUE(page.is_valid_offset(0));
+  ASSERT_TRUE(page.is_valid_offset(contents.length() - 1));
 }
 
 
 TEST(Page, IsValidOffset_InvalidValue) {
   string contents = "im in ur base killing ur d00dz";
-  istringstream input_stream(contents);
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  ASSERT_FALSE(page->is_valid_offset(contents.length()));
+  ASSERT_FALSE(page.is_valid_offset(contents.length()));
 }
 
 
 TEST(Page, IsValidOffset_InvalidValueFullPage) {
-  istringstream input_stream(
-      "AY3SmKknrmqdulbnXYZRtXnuQ571pA5HXAeB8qh0qR6n6yo303tdkAO9fZYWPLX3");
+  string contents =
+      "AY3SmKknrmqdulbnXYZRtXnuQ571pA5HXAeB8qh0qR6n6yo303tdkAO9fZYWPLX3";
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(contents.data(), contents.size());
 
-  ASSERT_FALSE(page->is_valid_offset(Page::PAGE_SIZE));
+  ASSERT_FALSE(page.is_valid_offset(Page::PAGE_SIZE));
 }
 
 
 TEST(Page, GetByteAtOffset) {
-  stringstream input_stream;
-  input_stream << '\0' << '1' << '\n' << ' ';
+  string contents("\0" "1" "\n" " ", 4);
+
+  Page page = Page::from_bytes(contents.data(), contents.size());
+
+  ASSERT_EQ(4, page.size());
+  EXPECT_EQ('\0', page.get_byte_at_offset(0));
+  EXPECT_EQ('1', page.get_byte_at_offset(1));
+  EXPECT_EQ('\n', page.get_byte_at_offset(2));
+  EXPECT_EQ(' ', page.get_byte_at_offset(3));
+}
+
+
+TEST(Page, Hash_SameContents) {
+  string first = "AY3SmKknrmqdulbnXYZRtXnuQ5";
+  string second = "xx" + first;
+
+  Page page = Page::from_bytes(first.data(), first.size());
+  Page copy = Page::from_bytes(second.data() + 2, first.size());
+
+  ASSERT_EQ(page.hash(), copy.hash());
+  ASSERT_TRUE(page.has_same_contents(copy));
+}
+
+
+TEST(Page, Hash_DifferentContents) {
+  string first = "AY3SmKknrmqdulbnXYZRtXnuQ5";
+  string second = "AY3SmKknrmqdulbnXYZRtXnuQ6";
 
-  Page* page = Page::read_from_input(input_stream);
+  Page page = Page::from_bytes(first.data(), first.size());
+  Page other = Page::from_bytes(second.data(), second.size());
+  Page shorter = Page::from_bytes(first.data(), first.size() - 1);
 
-  ASSERT_EQ(4, page->size());
-  EXPECT_EQ('\0', page->get_byte_at_offset(0));
-  EXPECT_EQ('1', page->get_byte_at_offset(1));
-  EXPECT_EQ('\n', page->get_byte_at_offset(2));
-  EXPECT_EQ(' ', page->get_byte_at_offset(3));
+  ASSERT_NE(page.hash(), other.hash());
+  ASSERT_FALSE(page.has_same_contents(other));
+  ASSERT_FALSE(page.has_same_contents(shorter));
 }
@@ -5,48 +5,417 @@
  */
 
 #include "page_table/page_table.h"
+#include <algorithm>
 
 using namespace std;
 
+// Ensure NONE is initialized.
+const size_t PageTable::NONE;
+
 
 size_t PageTable::get_present_page_count() const {
-    int count = 0;
-    for (int i = 0; i < this->rows.size(); i++) {
-        if (this->rows.at(i).present) {
-            count++;
+    return this->present_count;
+}
+
+
+size_t PageTable::get_oldest_page() const {
+    // the head of the FIFO list was loaded first
+    if (this->fifo_list.head == NONE) {
+        return 0;
+    }
+    return this->fifo_list.head;
+}
+
+
+size_t PageTable::get_least_recently_used_page() const {
+    // the head of the LRU list was accessed longest ago
+    if (this->lru_list.head == NONE) {
+        return 0;
+    }
+    return this->lru_list.head;
+}
+
+
+size_t PageTable::get_oldest_clean_page() const {
+    return find_clean_page(this->fifo_list, &Row::fifo_link);
+}
+
+
+size_t PageTable::get_least_recently_used_clean_page() const {
+    return find_clean_page(this->lru_list, &Row::lru_link);
+}
+
+
+void PageTable::load_page(size_t page, size_t frame, size_t time) {
+    Row& row = this->rows[page];
+
+    // set up the things - frame of the page, present, times
+    row.frame = frame;
+    row.present = true;
+    row.loaded_at = time;
+    row.last_accessed_at = time;
+    row.referenced = true;
+    row.dirty = false;
+    row.prefetched = false;
+    row.huge = false;
+    row.untouched = false;
+
+    // newly loaded pages are both the newest and the most recently used
+    push_back(this->fifo_list, &Row::fifo_link, page);
+    push_back(this->lru_list, &Row::lru_link, page);
+    this->present_count++;
+
+    // reuse the slot of a page that was unloaded, if there is one
+    if (this->free_clock_slots.empty()) {
+        row.clock_slot = this->clock_slots.size();
+        this->clock_slots.push_back(page);
+    } else {
+        row.clock_slot = this->free_clock_slots.back();
+        this->free_clock_slots.pop_back();
+        this->clock_slots[row.clock_slot] = page;
+    }
+
+    // ghosts come back as frequently used pages; anything else is new
+    if (this->adaptive_policy != AdaptivePolicy::NONE) {
+        if (row.queue == RECENT_GHOST) {
+            this->recent_ghost_hits++;
+            move_to_queue(page, FREQUENT);
+        } else if (row.queue == FREQUENT_GHOST) {
+            this->frequent_ghost_hits++;
+            move_to_queue(page, FREQUENT);
+        } else {
+            move_to_queue(page, RECENT);
         }
     }
-    return count;
 }
 
 
-size_t PageTable::get_oldest_page() const {
-    size_t time = -1;
-    size_t oldest_page = 0;
-
-    // loop through the rows and compare their load times to find the oldest page
-    for (int i = 0; i < this->rows.size(); i++) {
-        if (this->rows.at(i).present) {
-            if (this->rows.at(i).loaded_at < time) {
-                time = this->rows.at(i).loaded_at;
-                oldest_page = i;
+void PageTable::unload_page(size_t page) {
+    Row& row = this->rows[page];
+
+    remove(this->fifo_list, &Row::fifo_link, page);
+    remove(this->lru_list, &Row::lru_link, page);
+
+    this->clock_slots[row.clock_slot] = NONE;
+    this->free_clock_slots.push_back(row.clock_slot);
+    row.clock_slot = NONE;
+
+    if (!row.referenced && !row.dirty) {
+        this->clean_unreferenced_count--;
+    }
+
+    row.present = false;
+    this->present_count--;
+
+    // remember evicted pages on the ghost lists
+    if (this->adaptive_policy == AdaptivePolicy::ARC) {
+        if (row.queue == RECENT) {
+            move_to_queue(page, RECENT_GHOST);
+        } else if (row.queue == FREQUENT) {
+            move_to_queue(page, FREQUENT_GHOST);
+        }
+    } else if (this->adaptive_policy == AdaptivePolicy::TWO_QUEUE) {
+        if (row.queue == RECENT) {
+            move_to_queue(page, RECENT_GHOST);
+
+            // A1out holds up to half as many ghosts as there are frames
+            if (this->queues[RECENT_GHOST].size > max<size_t>(1, this->capacity / 2)) {
+                move_to_queue(this->queues[RECENT_GHOST].head, OUT);
             }
+        } else {
+            move_to_queue(page, OUT);
         }
     }
-    return oldest_page;
 }
 
 
-size_t PageTable::get_least_recently_used_page() const {
-    size_t time = -1;
-    size_t least_recently_used = 0;
+void PageTable::touch_page(size_t page, size_t time) {
+    Row& row = this->rows[page];
+    row.last_accessed_at = time;
 
-    // loop through the rows and compare their access times to find the least recently used page
-    for (int i = 0; i < this->rows.size(); i++) {
-        if ((this->rows.at(i).last_accessed_at < time) && (this->rows.at(i).present)) {
-            time = this->rows.at(i).last_accessed_at;
-            least_recently_used = i;
+    if (!row.referenced) {
+        row.referenced = true;
+        if (!row.dirty) {
+            this->clean_unreferenced_count--;
         }
     }
-    return least_recently_used;
+
+    // move the page to the most recently used end of the LRU list
+    if (this->lru_list.tail != page) {
+        remove(this->lru_list, &Row::lru_link, page);
+        push_back(this->lru_list, &Row::lru_link, page);
+    }
+
+    // ARC promotes any hit to its frequency queue; 2Q only reorders Am
+    if (this->adaptive_policy == AdaptivePolicy::ARC
+            || (this->adaptive_policy == AdaptivePolicy::TWO_QUEUE && row.queue == FREQUENT)) {
+        move_to_queue(page, FREQUENT);
+    }
+}
+
+
+void PageTable::mark_dirty(size_t page) {
+    Row& row = this->rows[page];
+
+    if (!row.dirty) {
+        row.dirty = true;
+        if (!row.referenced) {
+            this->clean_unreferenced_count--;
+        }
+    }
+}
+
+
+size_t PageTable::get_clock_victim() {
+    if (this->present_count == 0) {
+        return 0;
+    }
+
+    while (true) {
+        size_t page = advance_hand();
+        if (page == NONE) {
+            continue;
+        }
+
+        if (!this->rows[page].referenced) {
+            return page;
+        }
+        clear_reference(page);
+    }
+}
+
+
+size_t PageTable::get_second_chance_victim() {
+    if (this->present_count == 0) {
+        return 0;
+    }
+
+    while (true) {
+        size_t page = this->fifo_list.head;
+        this->hand_sweeps++;
+
+        if (!this->rows[page].referenced) {
+            return page;
+        }
+
+        // give the page a second chance at the back of the queue
+        clear_reference(page);
+        remove(this->fifo_list, &Row::fifo_link, page);
+        push_back(this->fifo_list, &Row::fifo_link, page);
+    }
+}
+
+
+size_t PageTable::get_enhanced_clock_victim() {
+    if (this->present_count == 0) {
+        return 0;
+    }
+
+    while (true) {
+        size_t page = advance_hand();
+        if (page == NONE) {
+            continue;
+        }
+
+        Row& row = this->rows[page];
+        if (row.referenced) {
+            clear_reference(page);
+            continue;
+        }
+
+        // an unreferenced dirty page only goes if there are no clean ones
+        if (!row.dirty || this->clean_unreferenced_count == 0) {
+            return page;
+        }
+    }
+}
+
+
+void PageTable::set_next_use(size_t page, size_t next_use) {
+    this->rows[page].next_use = next_use;
+    this->next_use_heap.emplace_back(next_use, page);
+    push_heap(this->next_use_heap.begin(), this->next_use_heap.end());
+
+    // rebuild the heap from the present pages once stale entries dominate it
+    if (this->next_use_heap.size() > 2 * this->present_count + 64) {
+        this->next_use_heap.clear();
+        for (size_t present_page : this->clock_slots) {
+            if (present_page != NONE) {
+                this->next_use_heap.emplace_back(this->rows[present_page].next_use, present_page);
+            }
+        }
+        make_heap(this->next_use_heap.begin(), this->next_use_heap.end());
+    }
+}
+
+
+size_t PageTable::get_optimal_victim() {
+    while (!this->next_use_heap.empty()) {
+        const pair<size_t, size_t>& top = this->next_use_heap.front();
+        const Row& row = this->rows[top.second];
+
+        if (row.present && row.next_use == top.first) {
+            return top.second;
+        }
+
+        // the page was unloaded or used again since this entry was pushed
+        pop_heap(this->next_use_heap.begin(), this->next_use_heap.end());
+        this->next_use_heap.pop_back();
+    }
+    return get_oldest_page();
+}
+
+
+void PageTable::set_adaptive_policy(AdaptivePolicy policy, size_t capacity) {
+    this->adaptive_policy = policy;
+    this->capacity = capacity;
+}
+
+
+size_t PageTable::get_arc_victim(size_t page) {
+    if (this->present_count == 0) {
+        return 0;
+    }
+
+    List& t1 = this->queues[RECENT];
+    List& t2 = this->queues[FREQUENT];
+    List& b1 = this->queues[RECENT_GHOST];
+    List& b2 = this->queues[FREQUENT_GHOST];
+    unsigned char queue = this->rows[page].queue;
+
+    if (queue == RECENT_GHOST) {
+        // a recency ghost hit: T1 was evicted from too eagerly, so grow it
+        this->arc_target = min(this->capacity, this->arc_target + max<size_t>(b2.size / b1.size, 1));
+    } else if (queue == FREQUENT_GHOST) {
+        // a frequency ghost hit: shrink T1 in favor of T2
+        size_t delta = max<size_t>(b1.size / b2.size, 1);
+        this->arc_target = this->arc_target > delta ? this->arc_target - delta : 0;
+    } else if (t1.size + b1.size >= this->capacity) {
+        // the recency side of the directory is full
+        if (t1.size < this->capacity) {
+            move_to_queue(b1.head, OUT);
+        } else {
+            // B1 is empty, so the oldest page leaves without becoming a ghost
+            size_t victim = t1.head;
+            move_to_queue(victim, OUT);
+            return victim;
+        }
+    } else if (t1.size + t2.size + b1.size + b2.size >= 2 * this->capacity) {
+        move_to_queue(b2.head, OUT);
+    }
+
+    // evict from T1 if it is over its target, and from T2 otherwise
+    if (t1.size > 0 && (t1.size > this->arc_target
+            || (queue == FREQUENT_GHOST && t1.size == this->arc_target) || t2.size == 0)) {
+        return t1.head;
+    }
+    return t2.head;
+}
+
+
+size_t PageTable::get_two_queue_victim() {
+    if (this->present_count == 0) {
+        return 0;
+    }
+
+    // A1in may hold up to a quarter of the frames
+    List& a1in = this->queues[RECENT];
+    List& am = this->queues[FREQUENT];
+    if (a1in.size > max<size_t>(1, this->capacity / 4) || am.size == 0) {
+        return a1in.head;
+    }
+    return am.head;
+}
+
+
+size_t PageTable::get_arc_target() const {
+    return this->arc_target;
+}
+
+
+void PageTable::move_to_queue(size_t page, Queue queue) {
+    Row& row = this->rows[page];
+
+    if (row.queue != OUT) {
+        remove(this->queues[row.queue], &Row::queue_link, page);
+    }
+    if (queue != OUT) {
+        push_back(this->queues[queue], &Row::queue_link, page);
+    }
+    row.queue = queue;
+}
+
+
+size_t PageTable::find_clean_page(const List& list, Link Row::* link) const {
+    if (list.head == NONE) {
+        return 0;
+    }
+
+    // only look at the colder half, so a hot clean page is not given up for
+    // a cold dirty one
+    const RadixTable<Row>& rows = this->rows;
+    size_t page = list.head;
+    for (size_t i = 0; i < max<size_t>(1, list.size / 2) && page != NONE; i++) {
+        if (!rows[page].dirty) {
+            return page;
+        }
+        page = (rows[page].*link).next;
+    }
+    return list.head;
+}
+
+
+size_t PageTable::advance_hand() {
+    size_t page = this->clock_slots[this->clock_hand];
+    this->clock_hand = (this->clock_hand + 1) % this->clock_slots.size();
+    this->hand_sweeps++;
+    return page;
+}
+
+
+void PageTable::clear_reference(size_t page) {
+    Row& row = this->rows[page];
+
+    if (row.referenced) {
+        row.referenced = false;
+        if (!row.dirty) {
+            this->clean_unreferenced_count++;
+        }
+    }
+}
+
+
+void PageTable::push_back(List& list, Link Row::* link, size_t page) {
+    Link& node = this->rows[page].*link;
+    node.prev = list.tail;
+    node.next = NONE;
+
+    if (list.tail == NONE) {
+        list.head = page;
+    } else {
+        (this->rows[list.tail].*link).next = page;
+    }
+    list.tail = page;
+    list.size++;
+}
+
+
+void PageTable::remove(List& list, Link Row::* link, size_t page) {
+    Link& node = this->rows[page].*link;
+
+    if (node.prev == NONE) {
+        list.head = node.next;
+    } else {
+        (this->rows[node.prev].*link).next = node.next;
+    }
+
+    if (node.next == NONE) {
+        list.tail = node.prev;
+    } else {
+        (this->rows[node.next].*link).prev = node.prev;
+    }
+
+    node.prev = NONE;
+    node.next = NONE;
+    list.size--;
 }
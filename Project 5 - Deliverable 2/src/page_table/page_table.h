@@ -3,21 +3,49 @@
  */
 
 #pragma once
+#include "radix_table/radix_table.h"
 #include <cstdlib>
+#include <utility>
 #include <vector>
 
 
 /**
  * Represents the page table for a single process.
+ *
+ * Besides the rows themselves, the table keeps intrusive FIFO and LRU lists
+ * threaded through the present rows, along with a running count of present
+ * pages, so that victim selection and residency queries never need to scan the
+ * whole table. Present pages also sit in a circular array of clock slots swept
+ * by a clock hand. If an adaptive policy (ARC or 2Q) is selected, present and
+ * recently evicted ("ghost") pages are also kept on that policy's queues. Pages
+ * should therefore only be brought in and out of memory via load_page() and
+ * unload_page(), and accesses recorded via touch_page().
  */
 class PageTable {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * Sentinel page index used to terminate the intrusive lists.
+    */
+    static const size_t NONE = -1;
+
+    /**
+    * The adaptive replacement policies whose queues the table can maintain.
+    */
+    enum class AdaptivePolicy {
+        NONE,
+        ARC,
+        TWO_QUEUE
+    };
+
 // PUBLIC API METHODS
 public:
 
     /**
     * Constructor.
     */
-    PageTable(size_t num_pages) : rows(std::vector<Row>(num_pages)) {}
+    PageTable(size_t num_pages) : rows(num_pages) {}
 
     /**
     * Returns the number of pages that are currently present in memory.
@@ -35,9 +63,113 @@ public:
     */
     size_t get_least_recently_used_page() const;
 
+    /**
+    * Returns the oldest clean page among the older half of the present pages,
+    * or the oldest page if those are all dirty.
+    */
+    size_t get_oldest_clean_page() const;
+
+    /**
+    * Returns the least recently used clean page among the less recently used
+    * half of the present pages, or the least recently used page if those are
+    * all dirty.
+    */
+    size_t get_least_recently_used_clean_page() const;
+
+    /**
+    * Marks the given page as present in the given frame, loaded and accessed at
+    * the given time.
+    */
+    void load_page(size_t page, size_t frame, size_t time);
+
+    /**
+    * Marks the given (present) page as no longer present in main memory.
+    */
+    void unload_page(size_t page);
+
+    /**
+    * Records an access to the given (present) page at the given time, setting
+    * its reference bit.
+    */
+    void touch_page(size_t page, size_t time);
+
+    /**
+    * Records a write to the given (present) page, setting its dirty bit.
+    */
+    void mark_dirty(size_t page);
+
+    /**
+    * Sweeps the clock hand until it reaches a page whose reference bit is
+    * clear, clearing the bits of the referenced pages it passes, and returns
+    * that page (CLOCK).
+    */
+    size_t get_clock_victim();
+
+    /**
+    * Takes pages off the head of the FIFO list until one has a clear reference
+    * bit, moving referenced pages to the tail with their bits cleared, and
+    * returns that page (second chance).
+    */
+    size_t get_second_chance_victim();
+
+    /**
+    * Like get_clock_victim(), but skips unreferenced dirty pages as long as an
+    * unreferenced clean page is present, so that clean pages are evicted
+    * first (enhanced CLOCK).
+    */
+    size_t get_enhanced_clock_victim();
+
+    /**
+    * Records the position in the trace at which the given (present) page will
+    * next be accessed, or NONE if it never will be.
+    */
+    void set_next_use(size_t page, size_t next_use);
+
+    /**
+    * Returns the present page whose next use is farthest in the future (OPT),
+    * in O(log n) amortized time. Only meaningful if set_next_use() has been
+    * called for every present page.
+    */
+    size_t get_optimal_victim();
+
+    /**
+    * Starts maintaining the queues and ghost lists of the given adaptive policy
+    * for a process holding at most capacity pages. Must be called before any
+    * pages are loaded.
+    */
+    void set_adaptive_policy(AdaptivePolicy policy, size_t capacity);
+
+    /**
+    * Picks the page to evict to make room for the given page under ARC,
+    * adapting the target size of the recency queue if the page is a ghost and
+    * trimming the ghost lists as needed. The victim becomes a ghost when it is
+    * unloaded, unless it must leave the directory entirely.
+    */
+    size_t get_arc_victim(size_t page);
+
+    /**
+    * Picks the page to evict under 2Q: the oldest page of the A1in FIFO queue
+    * if that queue is over its share of memory, or the least recently used
+    * page of the Am queue otherwise.
+    */
+    size_t get_two_queue_victim();
+
+    /**
+    * Returns the target size of ARC's recency queue (p in the ARC paper).
+    */
+    size_t get_arc_target() const;
+
 // CLASS INSTANCE VARIABLES
 public:
 
+    /**
+    * The previous and next pages of a row within one of the intrusive lists.
+    */
+    struct Link {
+        size_t prev = NONE;
+        size_t next = NONE;
+    };
+
     /**
     * Represents a single row in the page table.
     */
@@ -62,10 +194,215 @@ public:
         * completely infeasible for a real OS to track, but we're not a real OS! =)
         */
         size_t last_accessed_at = -1;
+
+        /**
+        * Set whenever the page is accessed; cleared as the clock hand passes.
+        */
+        bool referenced = false;
+
+        /**
+        * Set when the page is written to while in memory.
+        */
+        bool dirty = false;
+
+        /**
+        * Set once the page has been written to. Its contents then no longer
+        * match the process image, so it may never share a frame again.
+        */
+        bool modified = false;
+
+        /**
+        * Set when the page is prefetched; cleared by its first access.
+        */
+        bool prefetched = false;
+
+        /**
+        * Set while the page is mapped as part of a huge page.
+        */
+        bool huge = false;
+
+        /**
+        * Set when the page is brought in by a huge page fault on another page;
+        * cleared by its first access.
+        */
+        bool untouched = false;
+
+        /**
+        * The clock slot holding this page, if present in memory.
+        */
+        size_t clock_slot = NONE;
+
+        /**
+        * The position in the trace of the next access to this page, for OPT.
+        */
+        size_t next_use = NONE;
+
+        /**
+        * Position of this row in the load-order (FIFO) list.
+        */
+        Link fifo_link;
+
+        /**
+        * Position of this row in the access-order (LRU) list.
+        */
+        Link lru_link;
+
+        /**
+        * The adaptive policy queue (or ghost list) this page is on, if any.
+        */
+        unsigned char queue = OUT;
+
+        /**
+        * Position of this row in that queue.
+        */
+        Link queue_link;
   };
 
     /**
-    * One row for each page in the process. The page number is used as the index.
+    * One row for each page in the process. The page number is used as the
+    * index. The rows are stored in a multi-level radix tree whose nodes are
+    * only allocated once a page under them is touched, so a table for a huge,
+    * sparsely used address space stays small.
+    */
+    RadixTable<Row> rows;
+
+    /**
+    * The number of slots (or FIFO entries, for second chance) the replacement
+    * policies have inspected while looking for victims.
+    */
+    size_t hand_sweeps = 0;
+
+    /**
+    * The number of pages loaded while on the recency ghost list (ARC's B1,
+    * 2Q's A1out).
+    */
+    size_t recent_ghost_hits = 0;
+
+    /**
+    * The number of pages loaded while on ARC's frequency ghost list (B2).
+    */
+    size_t frequent_ghost_hits = 0;
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * The two ends of an intrusive list of rows.
+    */
+    struct List {
+        size_t head = NONE;
+        size_t tail = NONE;
+        size_t size = 0;
+    };
+
+    /**
+    * The adaptive policy queues. RECENT and FREQUENT hold present pages (ARC's
+    * T1 and T2, 2Q's A1in and Am), and the ghost lists hold evicted ones (ARC's
+    * B1 and B2, 2Q's A1out).
+    */
+    enum Queue {
+        OUT,
+        RECENT,
+        FREQUENT,
+        RECENT_GHOST,
+        FREQUENT_GHOST,
+        NUM_QUEUES
+    };
+
+    /**
+    * Appends the given page to the tail of the list, using the given link.
+    */
+    void push_back(List& list, Link Row::* link, size_t page);
+
+    /**
+    * Unlinks the given page from the list, using the given link.
+    */
+    void remove(List& list, Link Row::* link, size_t page);
+
+    /**
+    * Returns the first clean page among the first half of the list, or its head
+    * if those are all dirty, using the given link.
+    */
+    size_t find_clean_page(const List& list, Link Row::* link) const;
+
+    /**
+    * Returns the page in the slot under the clock hand (NONE for an empty slot)
+    * and moves the hand on to the next slot.
+    */
+    size_t advance_hand();
+
+    /**
+    * Clears the reference bit of the given page.
+    */
+    void clear_reference(size_t page);
+
+    /**
+    * Moves the given page to the most recently used end of the given adaptive
+    * policy queue, or off every queue for OUT.
+    */
+    void move_to_queue(size_t page, Queue queue);
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * Present pages, from the oldest load to the newest.
+    */
+    List fifo_list;
+
+    /**
+    * Present pages, from the least recent access to the most recent.
+    */
+    List lru_list;
+
+    /**
+    * The number of pages currently present in memory.
+    */
+    size_t present_count = 0;
+
+    /**
+    * The page in each clock slot, or NONE for a slot freed by an unload.
+    */
+    std::vector<size_t> clock_slots;
+
+    /**
+    * The clock slots freed by unloads, to be refilled by later loads.
+    */
+    std::vector<size_t> free_clock_slots;
+
+    /**
+    * The slot the clock hand points at.
+    */
+    size_t clock_hand = 0;
+
+    /**
+    * The number of present pages whose reference and dirty bits are both clear.
+    */
+    size_t clean_unreferenced_count = 0;
+
+    /**
+    * A max-heap of (next use, page) pairs for OPT. Entries go stale when a
+    * page is accessed again or unloaded, and are discarded lazily.
+    */
+    std::vector<std::pair<size_t, size_t>> next_use_heap;
+
+    /**
+    * The adaptive policy whose queues are maintained.
+    */
+    AdaptivePolicy adaptive_policy = AdaptivePolicy::NONE;
+
+    /**
+    * The most pages the process may hold, which bounds the ghost lists.
+    */
+    size_t capacity = 0;
+
+    /**
+    * The adaptive policy queues, indexed by Queue.
+    */
+    List queues[NUM_QUEUES];
+
+    /**
+    * The target size of ARC's recency queue.
     */
-    std::vector<Row> rows;
+    size_t arc_target = 0;
 };
@@ -5,6 +5,7 @@
  */
 
 #include "page_table/page_table.h"
+#include "address_layout/address_layout.h"
 #include "gtest/gtest.h"
 
 using namespace std;
@@ -23,46 +24,435 @@ TEST(PageTable, Constructor) {
 }
 
 
+TEST(PageTable, Constructor_Layout48) {
+  PageTable page_table(Layout48::NUM_PAGES);
+
+  ASSERT_EQ(Layout48::NUM_PAGES, page_table.rows.size());
+
+  page_table.load_page(0, 0, 0);
+  page_table.load_page(Layout48::get_page(0x7FFFFFFFF000), 1, 1);
+  page_table.load_page(Layout48::NUM_PAGES - 1, 2, 2);
+
+  ASSERT_EQ(3, page_table.get_present_page_count());
+  ASSERT_EQ(0, page_table.get_oldest_page());
+  ASSERT_EQ(1, page_table.rows[Layout48::get_page(0x7FFFFFFFF000)].frame);
+  ASSERT_EQ(3, page_table.rows.get_leaf_count());
+}
+
+
 TEST(PageTable, GetPresentPageCount) {
   PageTable page_table(100);
 
-  page_table.rows[10].present = true;
-  page_table.rows[42].present = true;
-  page_table.rows[99].present = true;
+  page_table.load_page(10, 0, 0);
+  page_table.load_page(42, 1, 1);
+  page_table.load_page(99, 2, 2);
 
   ASSERT_EQ(3, page_table.get_present_page_count());
+  ASSERT_TRUE(page_table.rows[42].present);
+}
+
+
+TEST(PageTable, GetPresentPageCount_AfterUnload) {
+  PageTable page_table(100);
+
+  page_table.load_page(10, 0, 0);
+  page_table.load_page(42, 1, 1);
+  page_table.unload_page(10);
+
+  ASSERT_EQ(1, page_table.get_present_page_count());
+  ASSERT_FALSE(page_table.rows[10].present);
+}
+
+
+TEST(PageTable, LoadPage) {
+  PageTable page_table(100);
+
+  page_table.load_page(7, 3, 25);
+
+  ASSERT_TRUE(page_table.rows[7].present);
+  ASSERT_EQ(3, page_table.rows[7].frame);
+  ASSERT_EQ(25, page_table.rows[7].loaded_at);
+  ASSERT_EQ(25, page_table.rows[7].last_accessed_at);
 }
 
 
 TEST(PageTable, GetOldestPage) {
   PageTable page_table(100);
 
-  for (size_t i = 0; i < 50; i++) {
-    page_table.rows[i].loaded_at = i;
+  for (size_t i = 2; i < 5; i++) {
+    page_table.load_page(i, i, i);
   }
 
+  // Page 2 was loaded first, so it is the oldest.
+  ASSERT_EQ(2, page_table.get_oldest_page());
+}
+
+
+TEST(PageTable, GetOldestPage_IgnoresAccesses) {
+  PageTable page_table(100);
+
   for (size_t i = 2; i < 5; i++) {
-    page_table.rows[i].present = true;
+    page_table.load_page(i, i, i);
   }
+  page_table.touch_page(2, 10);
 
-  // Should only include present pages, so page 2 is oldest of those present.
   ASSERT_EQ(2, page_table.get_oldest_page());
 }
 
 
+TEST(PageTable, GetOldestPage_AfterUnload) {
+  PageTable page_table(100);
+
+  for (size_t i = 2; i < 5; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.unload_page(2);
+  page_table.load_page(2, 2, 10);
+
+  // Should only include present pages, so page 3 is now the oldest.
+  ASSERT_EQ(3, page_table.get_oldest_page());
+}
+
 
 TEST(PageTable, GetLeastRecentlyUsedPage) {
   PageTable page_table(100);
 
-  for (size_t i = 5; i < 50; i++) {
-    page_table.rows[i].last_accessed_at = 100 - i;
+  for (size_t i = 10; i < 15; i++) {
+    page_table.load_page(i, i, i);
   }
 
-  for (size_t i = 10; i < 15; i++) {
-    page_table.rows[i].present = true;
+  for (size_t i = 14; i >= 10; i--) {
+    page_table.touch_page(i, 100 - i);
   }
 
-  // Should only include present pages, so page 14 is least recently used of
-  // those present.
+  // Page 14 was touched longest ago of those present.
   ASSERT_EQ(14, page_table.get_least_recently_used_page());
+  ASSERT_EQ(86, page_table.rows[14].last_accessed_at);
+}
+
+
+TEST(PageTable, GetLeastRecentlyUsedPage_AfterUnload) {
+  PageTable page_table(100);
+
+  for (size_t i = 10; i < 15; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.touch_page(10, 20);
+  page_table.unload_page(11);
+
+  // Page 11 is no longer present, and page 10 was just used.
+  ASSERT_EQ(12, page_table.get_least_recently_used_page());
+}
+
+
+TEST(PageTable, LoadPage_SetsReferenceBit) {
+  PageTable page_table(100);
+
+  page_table.load_page(3, 0, 0);
+
+  ASSERT_TRUE(page_table.rows[3].referenced);
+  ASSERT_FALSE(page_table.rows[3].dirty);
+}
+
+
+TEST(PageTable, GetClockVictim) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+
+  // Every page was just loaded, so the hand clears them all and comes back
+  // around to the first.
+  ASSERT_EQ(0, page_table.get_clock_victim());
+  ASSERT_EQ(5, page_table.hand_sweeps);
+  ASSERT_FALSE(page_table.rows[3].referenced);
+}
+
+
+TEST(PageTable, GetClockVictim_SkipsReferencedPages) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.unload_page(page_table.get_clock_victim());
+
+  // The new page takes the victim's slot, behind the hand.
+  page_table.load_page(10, 0, 10);
+  page_table.touch_page(1, 11);
+
+  ASSERT_EQ(2, page_table.get_clock_victim());
+}
+
+
+TEST(PageTable, GetSecondChanceVictim) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 3; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.unload_page(page_table.get_second_chance_victim());
+  page_table.load_page(5, 0, 5);
+  page_table.touch_page(1, 6);
+
+  // Page 1 was referenced again, so it goes to the back; page 2 is next.
+  ASSERT_EQ(2, page_table.get_second_chance_victim());
+
+  page_table.unload_page(2);
+  ASSERT_EQ(5, page_table.get_oldest_page());
+}
+
+
+TEST(PageTable, GetEnhancedClockVictim_PrefersCleanPages) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.mark_dirty(0);
+  page_table.mark_dirty(1);
+
+  // Pages 0 and 1 are dirty, so the first clean page goes instead.
+  ASSERT_EQ(2, page_table.get_enhanced_clock_victim());
+}
+
+
+TEST(PageTable, GetEnhancedClockVictim_AllDirty) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+    page_table.mark_dirty(i);
+  }
+
+  // With no clean page to be found, it behaves like CLOCK.
+  ASSERT_EQ(0, page_table.get_enhanced_clock_victim());
+}
+
+
+TEST(PageTable, GetOldestCleanPage) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 6; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.mark_dirty(0);
+  page_table.mark_dirty(1);
+
+  // Page 2 is the oldest clean page, and still in the older half.
+  ASSERT_EQ(2, page_table.get_oldest_clean_page());
+
+  // Once the older half is all dirty, the oldest page goes after all.
+  page_table.mark_dirty(2);
+  ASSERT_EQ(0, page_table.get_oldest_clean_page());
+}
+
+
+TEST(PageTable, GetLeastRecentlyUsedCleanPage) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.mark_dirty(1);
+  page_table.touch_page(0, 4);
+
+  // The LRU order is now 1, 2, 3, 0, and page 1 is dirty.
+  ASSERT_EQ(2, page_table.get_least_recently_used_clean_page());
+
+  // A page written back to disk is clean again when it is reloaded, making
+  // the order 2, 3, 0, 1.
+  page_table.unload_page(1);
+  page_table.load_page(1, 1, 5);
+  page_table.mark_dirty(2);
+  ASSERT_EQ(3, page_table.get_least_recently_used_clean_page());
+}
+
+
+TEST(PageTable, GetOptimalVictim) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.set_next_use(0, 50);
+  page_table.set_next_use(1, 20);
+  page_table.set_next_use(2, 90);
+  page_table.set_next_use(3, 10);
+
+  ASSERT_EQ(2, page_table.get_optimal_victim());
+}
+
+
+TEST(PageTable, GetOptimalVictim_NeverUsedAgain) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 3; i++) {
+    page_table.load_page(i, i, i);
+    page_table.set_next_use(i, 100 + i);
+  }
+  page_table.set_next_use(1, PageTable::NONE);
+
+  ASSERT_EQ(1, page_table.get_optimal_victim());
+}
+
+
+TEST(PageTable, GetOptimalVictim_SkipsStaleEntries) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 3; i++) {
+    page_table.load_page(i, i, i);
+    page_table.set_next_use(i, 10 * (i + 1));
+  }
+
+  // Page 2 is accessed again, with its next use now sooner than the others.
+  page_table.set_next_use(2, 5);
+  ASSERT_EQ(1, page_table.get_optimal_victim());
+
+  // Page 1 is evicted; its entry must not be returned again.
+  page_table.unload_page(1);
+  ASSERT_EQ(0, page_table.get_optimal_victim());
+}
+
+
+TEST(PageTable, GetOptimalVictim_ManyUpdates) {
+  PageTable page_table(100);
+
+  for (size_t i = 0; i < 5; i++) {
+    page_table.load_page(i, i, i);
+  }
+
+  // Enough updates to force the heap to be rebuilt a few times.
+  for (size_t t = 0; t < 1000; t++) {
+    page_table.set_next_use(t % 5, t + (t % 5 == 3 ? 10000 : 1));
+  }
+
+  ASSERT_EQ(3, page_table.get_optimal_victim());
+}
+
+
+TEST(PageTable, GetArcVictim_PrefersPagesSeenOnce) {
+  PageTable page_table(100);
+  page_table.set_adaptive_policy(PageTable::AdaptivePolicy::ARC, 4);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+
+  // Pages 0 and 1 are used again, so a scan through new pages evicts 2 and 3.
+  page_table.touch_page(0, 4);
+  page_table.touch_page(1, 5);
+
+  ASSERT_EQ(2, page_table.get_arc_victim(10));
+  page_table.unload_page(2);
+  page_table.load_page(10, 2, 6);
+
+  ASSERT_EQ(3, page_table.get_arc_victim(11));
+}
+
+
+TEST(PageTable, GetArcVictim_RecentGhostHitGrowsTarget) {
+  PageTable page_table(100);
+  page_table.set_adaptive_policy(PageTable::AdaptivePolicy::ARC, 4);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+  page_table.touch_page(1, 4);
+  page_table.touch_page(2, 5);
+  page_table.touch_page(3, 6);
+
+  size_t victim = page_table.get_arc_victim(10);
+  ASSERT_EQ(0, victim);
+  page_table.unload_page(victim);
+  page_table.load_page(10, 0, 7);
+  ASSERT_EQ(0, page_table.get_arc_target());
+
+  // Page 0 comes back from the B1 ghost list.
+  victim = page_table.get_arc_victim(0);
+  ASSERT_EQ(1, page_table.get_arc_target());
+  page_table.unload_page(victim);
+  page_table.load_page(0, page_table.rows[victim].frame, 8);
+
+  ASSERT_EQ(1, page_table.recent_ghost_hits);
+  ASSERT_EQ(0, page_table.frequent_ghost_hits);
+}
+
+
+TEST(PageTable, GetArcVictim_FrequentGhostHitShrinksTarget) {
+  PageTable page_table(100);
+  page_table.set_adaptive_policy(PageTable::AdaptivePolicy::ARC, 2);
+
+  page_table.load_page(0, 0, 0);
+  page_table.load_page(1, 1, 1);
+  page_table.touch_page(0, 2);
+  page_table.touch_page(1, 3);
+
+  // Both pages are in T2, so page 0 goes to the B2 ghost list.
+  ASSERT_EQ(0, page_table.get_arc_victim(5));
+  page_table.unload_page(0);
+  page_table.load_page(5, 0, 4);
+
+  // Page 0 comes back from B2; the target cannot drop below zero.
+  size_t victim = page_table.get_arc_victim(0);
+  ASSERT_EQ(0, page_table.get_arc_target());
+  page_table.unload_page(victim);
+  page_table.load_page(0, 0, 5);
+
+  ASSERT_EQ(0, page_table.recent_ghost_hits);
+  ASSERT_EQ(1, page_table.frequent_ghost_hits);
+}
+
+
+TEST(PageTable, GetTwoQueueVictim_EvictsFromA1inFirst) {
+  PageTable page_table(100);
+  page_table.set_adaptive_policy(PageTable::AdaptivePolicy::TWO_QUEUE, 4);
+
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+  }
+
+  // Hits in A1in do not reorder it.
+  page_table.touch_page(0, 4);
+  ASSERT_EQ(0, page_table.get_two_queue_victim());
+
+  page_table.unload_page(0);
+  page_table.load_page(0, 0, 5);
+  ASSERT_EQ(1, page_table.recent_ghost_hits);
+
+  // Page 0 is now in Am, and A1in is still over its share.
+  ASSERT_EQ(1, page_table.get_two_queue_victim());
+}
+
+
+TEST(PageTable, GetTwoQueueVictim_EvictsFromAmOnceA1inIsSmall) {
+  PageTable page_table(100);
+  page_table.set_adaptive_policy(PageTable::AdaptivePolicy::TWO_QUEUE, 4);
+
+  // Cycle pages 0-3 through A1out and back into Am.
+  for (size_t i = 0; i < 4; i++) {
+    page_table.load_page(i, i, i);
+    page_table.unload_page(i);
+    page_table.load_page(i, i, i);
+  }
+  page_table.load_page(4, 4, 4);
+  page_table.touch_page(0, 5);
+
+  ASSERT_EQ(1, page_table.get_two_queue_victim());
+}
+
+
+TEST(PageTable, TwoQueue_BoundsGhostList) {
+  PageTable page_table(100);
+  page_table.set_adaptive_policy(PageTable::AdaptivePolicy::TWO_QUEUE, 4);
+
+  // A1out holds at most two ghosts, so page 0 is forgotten.
+  for (size_t i = 0; i < 3; i++) {
+    page_table.load_page(i, i, i);
+    page_table.unload_page(i);
+  }
+  page_table.load_page(0, 0, 3);
+
+  ASSERT_EQ(0, page_table.recent_ghost_hits);
 }
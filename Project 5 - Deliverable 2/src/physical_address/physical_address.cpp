@@ -9,8 +9,10 @@
 using namespace std;
 
 string PhysicalAddress::to_string() const {
-    // convert page and offset to binary strings
-    string frame_binary = bitset<FRAME_BITS>((int)this->frame).to_string();
+    // convert page and offset to binary strings, widening the frame if there
+    // are more frames than FRAME_BITS can number
+    string frame_binary = bitset<64>((size_t)this->frame).to_string();
+    frame_binary = frame_binary.substr(min(frame_binary.find('1'), 64 - FRAME_BITS));
     string offset_binary = bitset<OFFSET_BITS>((int)this->offset).to_string();
 
     // return the full address as a binary string
@@ -18,22 +18,28 @@ class PhysicalAddress {
 // PUBLIC CONSTANTS
 public:
 
+    /**
+    * The layout of a physical address, whose "pages" are frames the same size
+    * as the pages of a virtual address.
+    */
+    typedef AddressLayout<10, VirtualAddress::OFFSET_BITS> Layout;
+
     /**
     * The number of bits in the physical address that are used to represent the
     * frame in main memory.
     */
-    static const size_t FRAME_BITS = 10;
+    static const size_t FRAME_BITS = Layout::PAGE_BITS;
 
     /**
     * The number of bits in the physical address that are used to represent the
     * offset into the corresponding frame.
     */
-    static const size_t OFFSET_BITS = VirtualAddress::OFFSET_BITS;
+    static const size_t OFFSET_BITS = Layout::OFFSET_BITS;
 
     /**
     * The total number of bits in a physical address.
     */
-    static const size_t ADDRESS_BITS = FRAME_BITS + OFFSET_BITS;
+    static const size_t ADDRESS_BITS = Layout::ADDRESS_BITS;
 
 // PUBLIC API METHODS
 public:
@@ -41,6 +41,13 @@ TEST(PhysicalAddress, ToString) {
 }
 
 
+TEST(PhysicalAddress, ToStringWideFrame) {
+  PhysicalAddress address(bitset<32>("101100101001").to_ulong(), OFFSET);
+
+  ASSERT_EQ("101100101001111010", address.to_string());
+}
+
+
 TEST(PhysicalAddress, OutputOperator) {
   PhysicalAddress address(FRAME, OFFSET);
   stringstream expected_output, output;
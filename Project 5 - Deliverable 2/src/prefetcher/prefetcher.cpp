@@ -0,0 +1,107 @@
+/**
+ * This file contains implementations for methods in the Prefetcher class and
+ * its detectors.
+ */
+
+#include "prefetcher/prefetcher.h"
+#include <algorithm>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t ReadaheadPrefetcher::INITIAL_WINDOW;
+
+
+unique_ptr<Prefetcher> Prefetcher::create(Policy policy, size_t depth) {
+    switch (policy) {
+        case Policy::NONE:
+            return nullptr;
+
+        case Policy::NEXT_N:
+            return unique_ptr<Prefetcher>(new NextNPrefetcher(depth));
+
+        case Policy::STRIDE:
+            return unique_ptr<Prefetcher>(new StridePrefetcher(depth));
+
+        case Policy::READAHEAD:
+            return unique_ptr<Prefetcher>(new ReadaheadPrefetcher(depth));
+    }
+    return nullptr;
+}
+
+
+void NextNPrefetcher::on_fault(size_t page, vector<size_t>& pages) {
+    for (size_t i = 1; i <= this->depth; i++) {
+        pages.push_back(page + i);
+    }
+}
+
+
+void StridePrefetcher::on_fault(size_t page, vector<size_t>& pages) {
+    if (this->has_last_fault) {
+        long stride = (long) page - (long) this->last_fault;
+        this->confirmed = (stride != 0 && stride == this->stride);
+        this->stride = stride;
+    }
+    this->last_fault = page;
+    this->has_last_fault = true;
+
+    if (this->confirmed) {
+        for (size_t i = 1; i <= this->depth; i++) {
+            push_stride(page, i, pages);
+        }
+    }
+}
+
+
+void StridePrefetcher::on_prefetch_hit(size_t page, vector<size_t>& pages) {
+    // the stream moved on without faulting, so follow it
+    if (this->confirmed) {
+        this->last_fault = page;
+        push_stride(page, this->depth, pages);
+    }
+}
+
+
+void StridePrefetcher::push_stride(size_t page, long count, vector<size_t>& pages) const {
+    long target = (long) page + count * this->stride;
+    if (target >= 0) {
+        pages.push_back(target);
+    }
+}
+
+
+void ReadaheadPrefetcher::on_fault(size_t page, vector<size_t>& pages) {
+    // a sequential fault means the window was too small to keep ahead
+    bool sequential = this->has_last_fault && page == this->last_fault + 1;
+    size_t initial = min(INITIAL_WINDOW, this->depth);
+    size_t size = sequential ? min(max(this->window * 2, initial), this->depth) : initial;
+
+    this->last_fault = page;
+    this->has_last_fault = true;
+    read_window(page + 1, size, pages);
+}
+
+
+void ReadaheadPrefetcher::on_prefetch_hit(size_t page, vector<size_t>& pages) {
+    // reaching the current window reads the next one in ahead of time
+    if (this->window > 0 && page == this->marker) {
+        read_window(this->next_start, min(this->window * 2, this->depth), pages);
+    }
+}
+
+
+size_t ReadaheadPrefetcher::get_window() const {
+    return this->window;
+}
+
+
+void ReadaheadPrefetcher::read_window(size_t start, size_t size, vector<size_t>& pages) {
+    for (size_t i = 0; i < size; i++) {
+        pages.push_back(start + i);
+    }
+
+    this->window = size;
+    this->marker = start;
+    this->next_start = start + size;
+}
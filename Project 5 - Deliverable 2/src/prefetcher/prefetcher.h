@@ -0,0 +1,185 @@
+/**
+ * This file contains the definition of the Prefetcher class and the detectors
+ * that implement it.
+ */
+
+#pragma once
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Decides which pages of a process to bring into memory ahead of time, based
+ * on the pages it faults on and the prefetched pages it goes on to use. Each
+ * process has its own prefetcher, so a detector only sees one address space.
+ *
+ * Prefetchers only suggest pages; the simulation skips those that are invalid
+ * or already present, and loads the rest within the process's frame budget.
+ */
+class Prefetcher {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The detectors a prefetcher can be created with.
+    */
+    enum class Policy {
+        NONE,
+        NEXT_N,
+        STRIDE,
+        READAHEAD
+    };
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Returns a new prefetcher using the given detector, which suggests at most
+    * depth pages at a time, or nullptr for NONE.
+    */
+    static std::unique_ptr<Prefetcher> create(Policy policy, size_t depth);
+
+    /**
+    * Destructor.
+    */
+    virtual ~Prefetcher() {}
+
+    /**
+    * Appends the pages to prefetch after a fault on the given page.
+    */
+    virtual void on_fault(size_t page, std::vector<size_t>& pages) = 0;
+
+    /**
+    * Appends the pages to prefetch after the first access to the given page
+    * since it was prefetched. By default, none.
+    */
+    virtual void on_prefetch_hit(size_t /* page */, std::vector<size_t>& /* pages */) {}
+};
+
+
+/**
+ * Prefetches the depth pages after every faulting page.
+ */
+class NextNPrefetcher : public Prefetcher {
+public:
+
+    /**
+    * Constructor.
+    */
+    NextNPrefetcher(size_t depth) : depth(depth) {}
+
+    void on_fault(size_t page, std::vector<size_t>& pages) override;
+
+private:
+
+    /**
+    * The number of pages prefetched after each fault.
+    */
+    size_t depth;
+};
+
+
+/**
+ * Detects a constant stride between consecutive faults, and once the same
+ * stride is seen twice in a row prefetches depth pages along it. Each use of a
+ * prefetched page then extends the stream by one more page, keeping depth
+ * pages ahead.
+ */
+class StridePrefetcher : public Prefetcher {
+public:
+
+    /**
+    * Constructor.
+    */
+    StridePrefetcher(size_t depth) : depth(depth) {}
+
+    void on_fault(size_t page, std::vector<size_t>& pages) override;
+
+    void on_prefetch_hit(size_t page, std::vector<size_t>& pages) override;
+
+private:
+
+    /**
+    * Appends the page count strides past the given one, if there is one.
+    */
+    void push_stride(size_t page, long count, std::vector<size_t>& pages) const;
+
+    /**
+    * The number of pages kept prefetched ahead along the stride.
+    */
+    size_t depth;
+
+    /**
+    * The previous faulting page, if there has been one.
+    */
+    size_t last_fault = 0;
+    bool has_last_fault = false;
+
+    /**
+    * The distance between the previous two faults, and whether the current
+    * stream follows it.
+    */
+    long stride = 0;
+    bool confirmed = false;
+};
+
+
+/**
+ * A readahead window in the style of Linux's: a fault starts a small window of
+ * pages after the faulting one, and using the first page of a window reads the
+ * next window in ahead of time, twice as large, up to depth pages. Sequential
+ * faults grow the window as well, while a fault anywhere else shrinks it back.
+ */
+class ReadaheadPrefetcher : public Prefetcher {
+public:
+
+    /**
+    * The size of the first window, if depth allows.
+    */
+    static const size_t INITIAL_WINDOW = 4;
+
+    /**
+    * Constructor.
+    */
+    ReadaheadPrefetcher(size_t depth) : depth(depth) {}
+
+    void on_fault(size_t page, std::vector<size_t>& pages) override;
+
+    void on_prefetch_hit(size_t page, std::vector<size_t>& pages) override;
+
+    /**
+    * Returns the size of the current window.
+    */
+    size_t get_window() const;
+
+private:
+
+    /**
+    * Appends the window of the given size starting at the given page, and
+    * marks its first page as the one that triggers the next window.
+    */
+    void read_window(size_t start, size_t size, std::vector<size_t>& pages);
+
+    /**
+    * The largest window.
+    */
+    size_t depth;
+
+    /**
+    * The size of the current window, or 0 before the first fault.
+    */
+    size_t window = 0;
+
+    /**
+    * The first page of the current window, and the page after its last.
+    */
+    size_t marker = 0;
+    size_t next_start = 0;
+
+    /**
+    * The previous faulting page, if there has been one.
+    */
+    size_t last_fault = 0;
+    bool has_last_fault = false;
+};
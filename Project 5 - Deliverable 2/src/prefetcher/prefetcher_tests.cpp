@@ -0,0 +1,126 @@
+/**
+ * This file contains tests for the Prefetcher class and its detectors.
+ */
+
+#include "prefetcher/prefetcher.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(Prefetcher, Create) {
+  ASSERT_EQ(nullptr, Prefetcher::create(Prefetcher::Policy::NONE, 4));
+  ASSERT_NE(nullptr, dynamic_cast<NextNPrefetcher*>(Prefetcher::create(Prefetcher::Policy::NEXT_N, 4).get()));
+  ASSERT_NE(nullptr, dynamic_cast<StridePrefetcher*>(Prefetcher::create(Prefetcher::Policy::STRIDE, 4).get()));
+  ASSERT_NE(nullptr, dynamic_cast<ReadaheadPrefetcher*>(Prefetcher::create(Prefetcher::Policy::READAHEAD, 4).get()));
+}
+
+
+TEST(NextNPrefetcher, OnFault) {
+  NextNPrefetcher prefetcher(3);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(10, pages);
+  ASSERT_EQ(vector<size_t>({11, 12, 13}), pages);
+
+  // prefetched pages being used does not prefetch any more
+  pages.clear();
+  prefetcher.on_prefetch_hit(11, pages);
+  ASSERT_TRUE(pages.empty());
+}
+
+
+TEST(StridePrefetcher, NeedsConfirmedStride) {
+  StridePrefetcher prefetcher(2);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(10, pages);
+  prefetcher.on_fault(13, pages);
+  ASSERT_TRUE(pages.empty());
+
+  // the same stride twice in a row starts a stream
+  prefetcher.on_fault(16, pages);
+  ASSERT_EQ(vector<size_t>({19, 22}), pages);
+
+  // a different stride ends it
+  pages.clear();
+  prefetcher.on_fault(17, pages);
+  ASSERT_TRUE(pages.empty());
+}
+
+
+TEST(StridePrefetcher, FollowsStreamOnHits) {
+  StridePrefetcher prefetcher(2);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(20, pages);
+  prefetcher.on_fault(18, pages);
+  prefetcher.on_fault(16, pages);
+  ASSERT_EQ(vector<size_t>({14, 12}), pages);
+
+  pages.clear();
+  prefetcher.on_prefetch_hit(14, pages);
+  ASSERT_EQ(vector<size_t>({10}), pages);
+}
+
+
+TEST(StridePrefetcher, StopsAtPageZero) {
+  StridePrefetcher prefetcher(4);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(6, pages);
+  prefetcher.on_fault(4, pages);
+  prefetcher.on_fault(2, pages);
+  ASSERT_EQ(vector<size_t>({0}), pages);
+}
+
+
+TEST(ReadaheadPrefetcher, GrowsOnSequentialHits) {
+  ReadaheadPrefetcher prefetcher(16);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(100, pages);
+  ASSERT_EQ(vector<size_t>({101, 102, 103, 104}), pages);
+
+  // only the first page of the window reads the next one in
+  pages.clear();
+  prefetcher.on_prefetch_hit(102, pages);
+  ASSERT_TRUE(pages.empty());
+
+  prefetcher.on_prefetch_hit(101, pages);
+  ASSERT_EQ(8, pages.size());
+  ASSERT_EQ(105, pages.front());
+  ASSERT_EQ(112, pages.back());
+
+  pages.clear();
+  prefetcher.on_prefetch_hit(105, pages);
+  ASSERT_EQ(16, prefetcher.get_window());
+
+  // the window never grows beyond the depth
+  pages.clear();
+  prefetcher.on_prefetch_hit(113, pages);
+  ASSERT_EQ(16, pages.size());
+  ASSERT_EQ(129, pages.front());
+}
+
+
+TEST(ReadaheadPrefetcher, RandomFaultResetsWindow) {
+  ReadaheadPrefetcher prefetcher(16);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(100, pages);
+  prefetcher.on_fault(101, pages);
+  ASSERT_EQ(8, prefetcher.get_window());
+
+  prefetcher.on_fault(500, pages);
+  ASSERT_EQ(ReadaheadPrefetcher::INITIAL_WINDOW, prefetcher.get_window());
+}
+
+
+TEST(ReadaheadPrefetcher, SmallDepth) {
+  ReadaheadPrefetcher prefetcher(2);
+  vector<size_t> pages;
+
+  prefetcher.on_fault(0, pages);
+  ASSERT_EQ(vector<size_t>({1, 2}), pages);
+}
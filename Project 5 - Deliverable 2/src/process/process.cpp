@@ -5,21 +5,39 @@
  */
 
 #include "process/process.h"
+#include "mapped_file/mapped_file.h"
+#include <iterator>
 
 using namespace std;
 
 
 Process* Process::read_from_input(std::istream& in) {
-    size_t num_bytes = 0;
-    std::vector<Page *> pages;
+    // read the whole image into one buffer
+    shared_ptr<string> buffer = make_shared<string>(
+        istreambuf_iterator<char>(in), istreambuf_iterator<char>());
 
-    while(!in.eof()) {
-        Page* curr_page = Page::read_from_input(in);
-        pages.push_back(curr_page);
-        num_bytes += in.gcount();
+    return new Process(buffer, buffer->data(), buffer->size());
+}
+
+
+Process* Process::read_from_file(const std::string& path) {
+    shared_ptr<MappedFile> mapping = MappedFile::open(path);
+    if (!mapping) {
+        return nullptr;
     }
 
-    return new Process(num_bytes, pages);
+    return new Process(mapping, mapping->data(), mapping->size());
+}
+
+
+vector<Page> Process::split_pages(const char* bytes, size_t num_bytes) {
+    vector<Page> pages;
+    pages.reserve((num_bytes + Page::PAGE_SIZE - 1) / Page::PAGE_SIZE);
+
+    for (size_t start = 0; start < num_bytes; start += Page::PAGE_SIZE) {
+        pages.push_back(Page::from_bytes(bytes + start, num_bytes - start));
+    }
+    return pages;
 }
 
 
@@ -43,14 +61,7 @@ bool Process::is_valid_page(size_t index) const
 
 size_t Process::get_rss() const
 {
-    size_t rss = 0;
-    for (int i = 0; i < this->page_table.rows.size(); i++) {
-        if (this->page_table.rows.at(i).present) {
-            rss++;
-        }
-    }
-
-    return rss;
+    return this->page_table.get_present_page_count();
 }
 
 
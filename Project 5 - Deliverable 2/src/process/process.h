@@ -5,6 +5,9 @@
 #pragma once
 #include "page/page.h"
 #include "page_table/page_table.h"
+#include "prefetcher/prefetcher.h"
+#include <memory>
+#include <string>
 #include <vector>
 #include <istream>
 
@@ -17,10 +20,18 @@ class Process {
 public:
 
     /**
-    * Instantiates a new Process by reading from the given istream.
+    * Instantiates a new Process by reading from the given istream. The whole
+    * image is read into a single buffer that the pages view.
     */
     static Process* read_from_input(std::istream& in);
 
+    /**
+    * Instantiates a new Process whose image is the file at the given path,
+    * memory-mapped rather than copied. Returns nullptr if the file could not
+    * be mapped.
+    */
+    static Process* read_from_file(const std::string& path);
+
     /**
     * Returns the total size of this process, in bytes.
     */
@@ -47,12 +58,18 @@ public:
 private:
 
     /**
-    * Private constructor.
+    * Private constructor. The image keeps the given bytes alive.
     */
-    Process(size_t num_bytes, std::vector<Page*> pages):
+    Process(std::shared_ptr<const void> image, const char* bytes, size_t num_bytes):
         num_bytes(num_bytes),
-        pages(pages),
-        page_table(PageTable(pages.size())) {}
+        pages(split_pages(bytes, num_bytes)),
+        page_table(PageTable(pages.size())),
+        image(image) {}
+
+    /**
+    * Returns views of each consecutive PAGE_SIZE bytes of the given image.
+    */
+    static std::vector<Page> split_pages(const char* bytes, size_t num_bytes);
 
 // CLASS INSTANCE VARIABLES
 public:
@@ -63,9 +80,10 @@ public:
     const size_t num_bytes;
 
     /**
-    * The pages that constitute this process' process image.
+    * The pages that constitute this process' process image, stored
+    * contiguously.
     */
-    const std::vector<Page*> pages;
+    const std::vector<Page> pages;
 
     /**
     * The page table for this process.
@@ -81,4 +99,105 @@ public:
     * The number of page faults this process experienced.
     */
     size_t page_faults = 0;
+
+    /**
+    * The number of this process's memory accesses that were writes.
+    */
+    size_t memory_writes = 0;
+
+    /**
+    * The number of dirty pages of this process written back to disk when they
+    * were evicted.
+    */
+    size_t writebacks = 0;
+
+    /**
+    * The number of frames the process may currently hold, under the
+    * page-fault-frequency allocator.
+    */
+    size_t frame_budget = 0;
+
+    /**
+    * The value of page_faults when the current page-fault-frequency window
+    * started.
+    */
+    size_t window_start_faults = 0;
+
+    /**
+    * The address space identifier tagging this process's TLB entries.
+    */
+    size_t asid = 0;
+
+    /**
+    * Picks pages of this process to load ahead of time, if prefetching.
+    */
+    std::unique_ptr<Prefetcher> prefetcher;
+
+    /**
+    * The number of pages prefetched for this process, and how many of them
+    * were used before being evicted, or evicted without being used.
+    */
+    size_t prefetches = 0;
+    size_t useful_prefetches = 0;
+    size_t wasted_prefetches = 0;
+
+    /**
+    * The number of this process's faults served by sharing a frame that
+    * already held identical contents, and the number of times a write gave
+    * one of its pages a private copy of a shared frame.
+    */
+    size_t merged_faults = 0;
+    size_t cow_breaks = 0;
+
+    /**
+    * For each aligned run of pages, whether it has been promoted to a huge
+    * page, so that it faults back in as one.
+    */
+    std::vector<bool> huge_regions;
+
+    /**
+    * The number of this process's page faults that brought in a whole huge
+    * page, and the number of its runs promoted to huge pages, demoted back
+    * to base pages, or that could not fault back in as huge pages.
+    */
+    size_t huge_faults = 0;
+    size_t promotions = 0;
+    size_t demotions = 0;
+    size_t huge_fallbacks = 0;
+
+    /**
+    * With a swap device, when this process can next run (or finished, once
+    * the trace is done), and the total time it spent waiting for page-ins,
+    * in nanoseconds.
+    */
+    double ready_at = 0.0;
+    double blocked_time = 0.0;
+
+    /**
+    * The number of this process's faults served by decompressing the page
+    * from the compressed pool instead of reading it in.
+    */
+    size_t pool_hits = 0;
+
+    /**
+    * The number of this process's prefetches served from the compressed
+    * pool.
+    */
+    size_t pooled_prefetches = 0;
+
+    /**
+    * The values of memory_accesses, page_faults and merged_faults when the
+    * current --interval window started.
+    */
+    size_t interval_start_accesses = 0;
+    size_t interval_start_faults = 0;
+    size_t interval_start_merged = 0;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * Owns the bytes of the process image (a mapping or a buffer).
+    */
+    std::shared_ptr<const void> image;
 };
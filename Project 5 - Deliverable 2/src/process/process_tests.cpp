@@ -7,7 +7,11 @@
 #include "process/process.h"
 #include "page/page.h"
 #include "gtest/gtest.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <sstream>
+#include <unistd.h>
 
 using namespace std;
 
@@ -93,8 +97,7 @@ TEST(Process, NonLastPageSizes) {
   ASSERT_FALSE(process->pages.empty()) << "Process has no pages";
 
   for (size_t i = 0; i < process->pages.size() - 1; i++) {
-    ASSERT_NE(nullptr, process->pages[i]);
-    EXPECT_EQ(Page::PAGE_SIZE, process->pages[i]->size());
+    EXPECT_EQ(Page::PAGE_SIZE, process->pages[i].size());
   }
 }
 
@@ -104,9 +107,8 @@ TEST(Process, LastPageSize) {
   ASSERT_NE(nullptr, process);
 
   ASSERT_FALSE(process->pages.empty()) << "Process has no pages";
-  ASSERT_NE(nullptr, process->pages.back());
 
-  EXPECT_EQ(18, process->pages.back()->size());
+  EXPECT_EQ(18, process->pages.back().size());
 }
 
 
@@ -118,22 +120,77 @@ TEST(Process, PageContent) {
 
   for (size_t i = 0; i < 31; i++) {
     ASSERT_TRUE(process->is_valid_page(i));
-    ASSERT_NE(nullptr, process->pages[i]);
-    ASSERT_TRUE(process->pages[i]->is_valid_offset(i));
+    ASSERT_TRUE(process->pages[i].is_valid_offset(i));
 
-    expected_bytes << process->pages[i]->get_byte_at_offset(i);
+    expected_bytes << process->pages[i].get_byte_at_offset(i);
   }
 
   ASSERT_EQ(expected_bytes.str(), "ALL YOUR BASE ARE BELONG TO US!");
 }
 
 
+TEST(Process, PagesAreContiguous) {
+  Process* process = read_process();
+  ASSERT_NE(nullptr, process);
+
+  // Each page views the image right after the previous page.
+  for (size_t i = 1; i < process->pages.size(); i++) {
+    ASSERT_EQ(process->pages[i - 1].data() + Page::PAGE_SIZE, process->pages[i].data());
+  }
+}
+
+
+TEST(Process, EmptyImage) {
+  istringstream input_stream("");
+  Process* process = Process::read_from_input(input_stream);
+  ASSERT_NE(nullptr, process);
+
+  ASSERT_EQ(0, process->size());
+  ASSERT_TRUE(process->pages.empty());
+  ASSERT_FALSE(process->is_valid_page(0));
+}
+
+
+TEST(Process, ExactMultipleOfPageSize) {
+  istringstream input_stream(PROCESS_IMAGE.substr(0, 3 * Page::PAGE_SIZE));
+  Process* process = Process::read_from_input(input_stream);
+  ASSERT_NE(nullptr, process);
+
+  ASSERT_EQ(3, process->pages.size());
+  ASSERT_EQ(Page::PAGE_SIZE, process->pages.back().size());
+}
+
+
+TEST(Process, ReadFromFile) {
+  char path[] = "/tmp/process_testXXXXXX";
+  close(mkstemp(path));
+  {
+    ofstream out(path, ios::binary);
+    out << PROCESS_IMAGE;
+  }
+
+  Process* process = Process::read_from_file(path);
+  remove(path);
+  ASSERT_NE(nullptr, process);
+
+  // The image stays mapped even after its file is removed.
+  ASSERT_EQ(2002, process->size());
+  ASSERT_EQ(32, process->pages.size());
+  ASSERT_EQ('F', process->pages[31].get_byte_at_offset(0));
+}
+
+
+TEST(Process, ReadFromFile_MissingFile) {
+  ASSERT_EQ(nullptr, Process::read_from_file("/nonexistent/process_test"));
+}
+
+
 TEST(Process, GetRss) {
   Process* process = read_process();
   ASSERT_NE(nullptr, process);
 
   for (size_t i = 3; i < 7; i++) {
-    process->page_table.rows[i].present = true;
+    process->page_table.load_page(i, i, i);
   }
 
   ASSERT_EQ(4, process->get_rss());
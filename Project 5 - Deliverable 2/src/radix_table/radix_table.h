@@ -0,0 +1,207 @@
+/**
+ * This file contains the definition of the RadixTable template, a sparse array
+ * laid out like a multi-level page table.
+ */
+
+#pragma once
+#include <cstdlib>
+#include <memory>
+
+
+/**
+ * A fixed-size array of default-constructed items, stored as a radix tree: the
+ * items live in leaves of 2^LeafBits items, under levels of inner nodes that
+ * each split on InnerBits more bits of the index. Inner nodes and leaves are
+ * only allocated once an item under them is written, so memory scales with the
+ * part of the index space actually touched rather than its size, much as in a
+ * multi-level page table.
+ *
+ * Items never written read as default-constructed ones. Tables no bigger than
+ * a leaf are a single leaf, with no inner levels to walk.
+ */
+template <typename T, size_t LeafBits = 9, size_t InnerBits = 9>
+class RadixTable {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The number of items in a leaf, and of children of an inner node.
+    */
+    static constexpr size_t LEAF_SIZE = size_t(1) << LeafBits;
+    static constexpr size_t FANOUT = size_t(1) << InnerBits;
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. Allocates nothing until an item is written.
+    */
+    explicit RadixTable(size_t size) : num_items(size) {
+        // add inner levels until they cover every index
+        size_t covered = LEAF_SIZE;
+        while (covered < size) {
+            this->levels++;
+            covered = covered << InnerBits;
+            if (covered == 0 || this->levels * InnerBits + LeafBits >= 64) {
+                break;
+            }
+        }
+    }
+
+    /**
+    * Returns the number of items in the table.
+    */
+    size_t size() const {
+        return this->num_items;
+    }
+
+    /**
+    * Returns the item at the given index, allocating the leaf holding it (and
+    * the inner nodes above) if this is the first write under them.
+    */
+    T& operator[](size_t index) {
+        // accesses cluster, so remember the last leaf rather than walk to it
+        if ((index >> LeafBits) != this->cached_leaf || this->cached_items == nullptr) {
+            this->cached_items = this->find_leaf(index);
+            this->cached_leaf = index >> LeafBits;
+        }
+        return this->cached_items[index & (LEAF_SIZE - 1)];
+    }
+
+    /**
+    * Returns the item at the given index, without allocating anything.
+    */
+    const T& operator[](size_t index) const {
+        static const T unwritten{};
+        const Node* node = &this->root;
+
+        for (size_t level = this->levels; level > 0; level--) {
+            if (!node->children) {
+                return unwritten;
+            }
+
+            node = node->children[(index >> shift(level)) & (FANOUT - 1)].get();
+            if (node == nullptr) {
+                return unwritten;
+            }
+        }
+
+        if (!node->items) {
+            return unwritten;
+        }
+        return node->items[index & (LEAF_SIZE - 1)];
+    }
+
+    /**
+    * Returns the number of levels of inner nodes above the leaves.
+    */
+    size_t get_level_count() const {
+        return this->levels;
+    }
+
+    /**
+    * Returns the number of nodes (inner nodes and leaves) allocated below the
+    * root.
+    */
+    size_t get_node_count() const {
+        return this->node_count;
+    }
+
+    /**
+    * Returns the number of leaves allocated.
+    */
+    size_t get_leaf_count() const {
+        return this->leaf_count;
+    }
+
+    /**
+    * Returns the number of bytes the allocated nodes and leaves take up.
+    */
+    size_t get_memory_usage() const {
+        // the root and every allocated inner node have a child array
+        return sizeof(*this)
+            + this->node_count * sizeof(Node)
+            + this->leaf_count * LEAF_SIZE * sizeof(T)
+            + (this->node_count == 0 ? 0 : (this->node_count - this->leaf_count + 1) * FANOUT * sizeof(std::unique_ptr<Node>));
+    }
+
+// PRIVATE TYPES
+private:
+
+    /**
+    * A node of the tree: an inner node with children, or a leaf with items.
+    */
+    struct Node {
+        std::unique_ptr<std::unique_ptr<Node>[]> children;
+        std::unique_ptr<T[]> items;
+    };
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Returns the items of the leaf holding the given index, allocating it (and
+    * the inner nodes above) if this is the first write under it.
+    */
+    T* find_leaf(size_t index) {
+        Node* node = &this->root;
+
+        for (size_t level = this->levels; level > 0; level--) {
+            if (!node->children) {
+                node->children.reset(new std::unique_ptr<Node>[FANOUT]);
+            }
+
+            std::unique_ptr<Node>& child = node->children[(index >> shift(level)) & (FANOUT - 1)];
+            if (!child) {
+                child.reset(new Node());
+                this->node_count++;
+            }
+            node = child.get();
+        }
+
+        if (!node->items) {
+            node->items.reset(new T[LEAF_SIZE]());
+            this->leaf_count++;
+        }
+        return node->items.get();
+    }
+
+    /**
+    * Returns how far to shift an index to find its child at the given level,
+    * where level 1 is the one just above the leaves.
+    */
+    static size_t shift(size_t level) {
+        return LeafBits + (level - 1) * InnerBits;
+    }
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The number of items in the table.
+    */
+    size_t num_items;
+
+    /**
+    * The number of levels of inner nodes above the leaves.
+    */
+    size_t levels = 0;
+
+    /**
+    * The root of the tree, which is the only leaf if there are no inner levels.
+    */
+    Node root;
+
+    /**
+    * The number of inner nodes and leaves allocated, not counting the root.
+    */
+    size_t node_count = 0;
+    size_t leaf_count = 0;
+
+    /**
+    * The leaf most recently found by the non-const operator[], by the index
+    * bits above the leaf, and its items.
+    */
+    size_t cached_leaf = 0;
+    T* cached_items = nullptr;
+};
@@ -0,0 +1,104 @@
+/**
+ * This file contains tests for the RadixTable template.
+ */
+
+#include "radix_table/radix_table.h"
+#include "address_layout/address_layout.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(RadixTable, Constructor) {
+  RadixTable<int> table(100);
+
+  ASSERT_EQ(100, table.size());
+  ASSERT_EQ(0, table.get_level_count());
+  ASSERT_EQ(0, table.get_leaf_count());
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(0, table[i]);
+  }
+}
+
+
+TEST(RadixTable, SingleLeaf) {
+  RadixTable<int> table(512);
+
+  table[0] = 1;
+  table[511] = 2;
+
+  ASSERT_EQ(0, table.get_level_count());
+  ASSERT_EQ(0, table.get_node_count());
+  ASSERT_EQ(1, table.get_leaf_count());
+  ASSERT_EQ(1, table[0]);
+  ASSERT_EQ(2, table[511]);
+}
+
+
+TEST(RadixTable, LevelCount) {
+  ASSERT_EQ(1, RadixTable<int>(513).get_level_count());
+  ASSERT_EQ(1, RadixTable<int>(Layout32::NUM_PAGES / 4).get_level_count());
+  ASSERT_EQ(2, RadixTable<int>(Layout32::NUM_PAGES).get_level_count());
+  ASSERT_EQ(3, RadixTable<int>(Layout48::NUM_PAGES).get_level_count());
+}
+
+
+TEST(RadixTable, AllocatesLazily) {
+  RadixTable<int> table(Layout32::NUM_PAGES);
+
+  // two items in the same leaf
+  table[0] = 1;
+  table[1] = 2;
+  ASSERT_EQ(1, table.get_leaf_count());
+  ASSERT_EQ(2, table.get_node_count());
+
+  // a different leaf under the same top-level node
+  table[512] = 3;
+  ASSERT_EQ(2, table.get_leaf_count());
+  ASSERT_EQ(3, table.get_node_count());
+
+  // a leaf under a different top-level node
+  table[Layout32::NUM_PAGES - 1] = 4;
+  ASSERT_EQ(3, table.get_leaf_count());
+  ASSERT_EQ(5, table.get_node_count());
+
+  ASSERT_EQ(1, table[0]);
+  ASSERT_EQ(2, table[1]);
+  ASSERT_EQ(3, table[512]);
+  ASSERT_EQ(4, table[Layout32::NUM_PAGES - 1]);
+}
+
+
+TEST(RadixTable, ConstReadDoesNotAllocate) {
+  RadixTable<int> table(Layout32::NUM_PAGES);
+  const RadixTable<int>& const_table = table;
+
+  ASSERT_EQ(0, const_table[12345]);
+  ASSERT_EQ(0, table.get_node_count());
+
+  table[12345] = 7;
+  ASSERT_EQ(7, const_table[12345]);
+  ASSERT_EQ(0, const_table[12346]);
+  ASSERT_EQ(0, const_table[1 << 19]);
+  ASSERT_EQ(2, table.get_node_count());
+}
+
+
+TEST(RadixTable, MemoryScalesWithTouchedItems) {
+  RadixTable<size_t> table(Layout48::NUM_PAGES);
+  size_t empty = table.get_memory_usage();
+
+  for (size_t i = 0; i < 8; i++) {
+    table[i << 30] = i;
+  }
+
+  // eight separate paths of three nodes, instead of 2^36 items
+  ASSERT_EQ(8, table.get_leaf_count());
+  ASSERT_EQ(24, table.get_node_count());
+  ASSERT_LT(table.get_memory_usage() - empty, size_t(1) << 20);
+
+  for (size_t i = 0; i < 8; i++) {
+    ASSERT_EQ(i, table[i << 30]);
+  }
+}
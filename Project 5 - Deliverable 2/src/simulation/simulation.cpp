@@ -6,254 +6,2439 @@
  */
 
 #include "simulation/simulation.h"
+#include <queue>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 
-Simulation::Simulation(FlagOptions& flags)
+Simulation::Simulation(FlagOptions& flags) : frame_table(0)
 {
     this->flags = flags;
-    this->frames.reserve(this->NUM_FRAMES);
-    
 }
 
-void Simulation::run() {
+int Simulation::run() {
+    int error = 0;
+    if (this->flags.mrc) {
+        error = this->run_mrc();
+    } else {
+        error = this->simulate();
+    }
 
-    // populate free frames list
-    for (int i = 0; i < NUM_FRAMES; i++) {
-        this->free_frames.push_back(i);
+    // delete the memory for every process, which releases its image
+    std::map<int, Process*>::iterator it = processes.begin();
+    for (it; it != processes.end(); it++) { // iterate through the processes
+        delete(it->second);
+    }
+
+    return error;
+}
+
+int Simulation::simulate() {
+
+    // workers can only keep to their own frames if every process fits
+    bool parallel = false;
+    if (this->flags.threads > 1 && !this->flags.compare) {
+        parallel = this->processes.size() * this->flags.max_frames <= this->flags.num_frames;
+        if (!parallel) {
+            std::cerr << "Not enough frames to give every process its own; simulating serially." << std::endl;
+        }
     }
 
+    // OPT has to know the future, --compare runs the trace once per strategy,
+    // --dedup once more without merging, and with a swap device the accesses of
+    // other processes run ahead of a blocked one, so read the whole trace in first
+    if (this->flags.compare || this->flags.strategy == ReplacementStrategy::OPT || this->flags.dedup
+            || this->flags.swap) {
+        std::vector<VirtualAddress> trace;
+        if (this->read_trace(trace)) {
+            return 1;
+        }
+
+        if (this->flags.compare) {
+            this->compare_strategies(trace);
+            return 0;
+        }
+
+        this->next_uses = compute_next_uses(trace);
+
+        // run once without merging, to see what merging saves
+        if (this->flags.dedup) {
+            this->flags.dedup = false;
+            this->reset();
+            for (const VirtualAddress& address : trace) {
+                this->simulate_access(address);
+            }
+            this->baseline_page_faults = this->page_faults;
+            this->flags.dedup = true;
+        }
 
-    // iterate through the vector of processes
-    for(int i = 0; i < virtual_addresses.size(); i++) {
-        if (this->flags.verbose) {
-            std::cout << virtual_addresses[i] << std::endl;
+        this->reset();
+        if (this->flags.interval > 0 && this->open_intervals()) {
+            return 1;
+        }
+        if (this->open_trace_sink()) {
+            return 1;
         }
+        if (parallel) {
+            this->simulate_parallel(&trace);
+        } else if (this->flags.swap) {
+            this->simulate_with_swap(trace);
+        } else {
+            for (const VirtualAddress& address : trace) {
+                this->simulate_access(address);
+            }
+        }
+        return this->finish_simulation();
+    }
 
+    // populate free frames list
+    this->reset();
+    if (this->flags.interval > 0 && this->open_intervals()) {
+        return 1;
+    }
+    if (this->open_trace_sink()) {
+        return 1;
+    }
 
-        // get virtual address and perform a memory access
-        char return_val = perform_memory_access(virtual_addresses[i]);
-        if (this->flags.verbose) {
-            std::cout << "\t-> RSS: " << this->processes[virtual_addresses[i].process_id]->get_rss() << std::endl;
+    if (parallel) {
+        this->simulate_parallel(nullptr);
+    } else {
+        // iterate through the trace a chunk at a time
+        std::vector<VirtualAddress> chunk;
+        while (this->next_addresses(chunk)) {
+            for (const VirtualAddress& address : chunk) {
+                this->simulate_access(address);
+            }
         }
+    }
+    return this->finish_simulation();
+}
 
-        // increment time
-        this->time++;
+int Simulation::finish_simulation() {
+    if (this->interval_writer) {
+        this->close_intervals();
+    }
+    this->trace_sink.reset();
+    this->event_log_file.close();
+    if (this->read_error) {
+        return 1;
     }
 
     // print summary
     this->print_summary();
+    if (this->caches) {
+        this->print_cache_summary();
+    }
+    if (this->flags.verbose) {
+        this->print_allocator_summary();
+    }
+    if (this->flags.allocation != FrameAllocation::FIXED) {
+        this->print_allocation_history();
+    }
+    if (this->tlb) {
+        this->print_tlb_summary();
+    }
+    if (this->flags.prefetch != Prefetcher::Policy::NONE) {
+        this->print_prefetch_summary();
+    }
+    if (this->get_memory_writes() > 0) {
+        this->print_io_summary();
+    }
+    if (this->flags.dedup) {
+        this->print_dedup_summary();
+    }
+    if (this->flags.huge_page_order > 0) {
+        this->print_huge_page_summary();
+    }
+    if (this->compressed_pool) {
+        this->print_zswap_summary();
+    }
+    if (this->flags.swap) {
+        this->print_swap_summary();
+    }
+    return 0;
+}
 
-    // delete the memory for every page and every process
-    std::map<int, Process*>::iterator it = processes.begin();
-    for (it; it != processes.end(); it++) { // iterate through the processes
-        for (int i = 0; i < it->second->pages.size(); i++) {   // iterate through pages within process and delete stuff
-            delete(it->second->pages[i]);
+void Simulation::simulate_access(const VirtualAddress& address) {
+    if (this->trace_sink) {
+        this->trace_sink->access(address);
+    }
+    Process* process = this->processes[address.process_id];
+
+    // consult the TLB before the page table
+    bool tlb_hit = false;
+    size_t tlb_frame;
+    if (this->tlb) {
+        if (this->last_process != nullptr && this->last_process != process) {
+            this->context_switches++;
+            if (this->flags.tlb_flush) {
+                this->tlb->flush();
+            }
         }
+        this->last_process = process;
 
-        delete(it->second);
+        // a huge page's entry is found by the huge page number
+        size_t huge_size = this->get_huge_page_size();
+        bool huge = process->is_valid_page(address.page)
+            && process->page_table.rows[address.page].present
+            && process->page_table.rows[address.page].huge;
+        if (huge) {
+            tlb_hit = this->tlb->lookup(process->asid, address.page / huge_size, tlb_frame, true);
+            tlb_frame += address.page % huge_size;
+        } else {
+            tlb_hit = this->tlb->lookup(process->asid, address.page, tlb_frame);
+        }
+        if (this->trace_sink) {
+            this->trace_sink->event(tlb_hit ? TraceSink::Event::TLB_HIT : TraceSink::Event::TLB_MISS);
+        }
+    }
+
+    // get virtual address and perform a memory access
+    char return_val = perform_memory_access(address);
+    if (this->trace_sink) {
+        this->trace_sink->rss(process->get_rss());
+    }
+
+    // evictions shoot down stale translations, so a hit is always right
+    const PageTable::Row& row = process->page_table.rows[address.page];
+    if (tlb_hit) {
+        assert(tlb_frame == row.frame);
+    } else if (this->tlb && row.huge) {
+        size_t huge_size = this->get_huge_page_size();
+        this->tlb->insert(process->asid, address.page / huge_size, row.frame - address.page % huge_size, true);
+    } else if (this->tlb) {
+        this->tlb->insert(process->asid, address.page, row.frame);
+    }
+
+    // a write leaves the page dirty until it is evicted
+    if (address.write) {
+        process->memory_writes++;
+        if (this->flags.dedup) {
+            this->break_sharing(process, address.page);
+        }
+        process->page_table.mark_dirty(address.page);
+        this->frame_table.mark_dirty(process->page_table.rows[address.page].frame);
+    }
+
+    // tell OPT when this page will be needed next
+    if (this->flags.strategy == ReplacementStrategy::OPT) {
+        if (this->flags.scope == ReplacementScope::GLOBAL) {
+            size_t frame = process->page_table.rows[address.page].frame;
+            this->frame_table.set_next_use(frame, this->next_uses[this->time]);
+        } else {
+            process->page_table.set_next_use(address.page, this->next_uses[this->time]);
+        }
+    }
+
+    // let the dynamic allocators take frames back
+    if (this->flags.allocation == FrameAllocation::WORKING_SET) {
+        this->trim_working_sets();
+    } else if (this->flags.allocation == FrameAllocation::PFF) {
+        this->adjust_frame_budget(process);
+    }
+
+    if (this->flags.allocation != FrameAllocation::FIXED && (this->time + 1) % this->flags.window == 0) {
+        for (auto entry : this->processes) {
+            this->allocation_history.push_back(entry.second->get_rss());
+        }
+    }
+
+    if (this->interval_writer && (this->time + 1) % this->flags.interval == 0) {
+        this->write_interval(this->time + 1);
+    }
+
+    // increment time
+    this->time++;
+}
+
+int Simulation::simulate_parallel(const std::vector<VirtualAddress>* trace) {
+    // deal the processes out to the workers, each with its own frames
+    size_t num_workers = std::min<size_t>(this->flags.threads, this->processes.size());
+    std::map<int, size_t> worker_of;
+    size_t shard = 0;
+    this->first_frames.clear();
+    for (auto entry : this->processes) {
+        worker_of[entry.first] = shard % num_workers;
+        this->first_frames[entry.first] = this->frame_allocator->allocate_contiguous(this->flags.max_frames);
+        shard++;
+    }
+
+    std::vector<std::unique_ptr<ChunkQueue>> queues;
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_workers; i++) {
+        queues.emplace_back(new ChunkQueue());
+        workers.emplace_back(&Simulation::run_shard, this, queues.back().get());
+    }
+
+    // split the trace up by worker, keeping each access's position in it
+    std::vector<TraceChunk> pending(num_workers);
+    size_t position = 0;
+    auto dispatch = [&](const VirtualAddress& address) {
+        auto found = worker_of.find(address.process_id);
+        if (found == worker_of.end()) {
+            std::cerr << "No process with PID " << address.process_id << std::endl;
+            this->read_error = true;
+            return false;
+        }
+
+        TraceChunk& chunk = pending[found->second];
+        chunk.push_back(address, position++);
+        if (chunk.size() == AddressStream::CHUNK_SIZE) {
+            queues[found->second]->push(chunk);
+        }
+        return true;
+    };
+
+    if (trace != nullptr) {
+        for (size_t i = 0; i < trace->size() && dispatch((*trace)[i]); i++) {}
+    } else {
+        std::vector<VirtualAddress> chunk;
+        while (!this->read_error && this->next_addresses(chunk)) {
+            for (size_t i = 0; i < chunk.size() && dispatch(chunk[i]); i++) {}
+        }
+    }
+
+    for (size_t i = 0; i < num_workers; i++) {
+        if (pending[i].size() > 0) {
+            queues[i]->push(pending[i]);
+        }
+        queues[i]->close();
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // gather up what the workers did
+    this->time = position;
+    this->page_faults = 0;
+    this->writebacks = 0;
+    this->prefetches = 0;
+    for (auto entry : this->processes) {
+        this->page_faults += entry.second->page_faults;
+        this->writebacks += entry.second->writebacks;
+        this->prefetches += entry.second->prefetches;
+    }
+
+    // hand back the frames the processes never got to
+    for (auto entry : this->processes) {
+        size_t used = entry.second->page_table.get_present_page_count();
+        this->frame_allocator->free_contiguous(this->first_frames.at(entry.first) + used, this->flags.max_frames - used);
+    }
+    return this->read_error ? 1 : 0;
+}
+
+void Simulation::run_shard(ChunkQueue* queue) {
+    TraceChunk chunk;
+    while (queue->pop(chunk)) {
+        for (size_t i = 0; i < chunk.size(); i++) {
+            this->simulate_shard_access(chunk.addresses[i], chunk.positions[i]);
+        }
+    }
+}
+
+void Simulation::simulate_shard_access(const VirtualAddress& address, size_t position) {
+    Process* process = this->processes.at(address.process_id);
+    PageTable& page_table = process->page_table;
+
+    if (!process->is_valid_page(address.page)) {
+        std::cout << "SEGFAULT - INVALID PAGE" << std::endl;
+        exit(-1);
+    }
+    process->memory_accesses++;
+
+    if (page_table.rows[address.page].present) {
+        page_table.touch_page(address.page, position);
+    } else {
+        process->page_faults++;
+
+        // the process's frames are handed out in order until it has them all
+        size_t frame;
+        if (page_table.get_present_page_count() < this->flags.max_frames) {
+            frame = this->first_frames.at(address.process_id) + page_table.get_present_page_count();
+        } else {
+            size_t victim = this->select_victim(page_table, address.page);
+            frame = page_table.rows[victim].frame;
+            if (page_table.rows[victim].dirty) {
+                process->writebacks++;
+            }
+            page_table.unload_page(victim);
+        }
+
+        page_table.load_page(address.page, frame, position);
+        this->frames[frame].set_page(process, address.page);
+    }
+
+    if (!process->pages[address.page].is_valid_offset(address.offset)) {
+        std::cout << "SEGFAULT - INVALID OFFSET" << std::endl;
+        exit(-1);
+    }
+
+    if (address.write) {
+        process->memory_writes++;
+        page_table.mark_dirty(address.page);
+    }
+
+    if (this->flags.strategy == ReplacementStrategy::OPT) {
+        page_table.set_next_use(address.page, this->next_uses[position]);
+    }
+}
+
+void Simulation::simulate_with_swap(const std::vector<VirtualAddress>& trace) {
+    size_t huge_size = this->get_huge_page_size();
+
+    // the positions of each process's accesses in the trace
+    std::map<int, std::vector<size_t>> accesses;
+    std::map<int, size_t> next_access;
+    for (size_t i = 0; i < trace.size(); i++) {
+        accesses[trace[i].process_id].push_back(i);
+    }
+
+    // runnable processes by the position of their next access, and waiting
+    // ones by when their page-in completes
+    typedef std::pair<size_t, int> Runnable;
+    typedef std::pair<double, int> Waiting;
+    std::priority_queue<Runnable, std::vector<Runnable>, std::greater<Runnable>> runnable;
+    std::priority_queue<Waiting, std::vector<Waiting>, std::greater<Waiting>> waiting;
+    for (auto& entry : accesses) {
+        runnable.emplace(entry.second.front(), entry.first);
+        next_access[entry.first] = 0;
+    }
+
+    double now = 0.0;
+    while (!runnable.empty() || !waiting.empty()) {
+        while (!waiting.empty() && waiting.top().first <= now) {
+            int pid = waiting.top().second;
+            waiting.pop();
+            runnable.emplace(accesses[pid][next_access[pid]], pid);
+        }
+
+        // with every process waiting, the CPU idles until a page-in is done
+        if (runnable.empty()) {
+            now = waiting.top().first;
+            continue;
+        }
+
+        int pid = runnable.top().second;
+        runnable.pop();
+        Process* process = this->processes[pid];
+
+        size_t page_faults = process->page_faults;
+        size_t huge_faults = process->huge_faults;
+        size_t pool_hits = process->pool_hits;
+        // writebacks and prefetches may be for any process
+        size_t writebacks = this->writebacks;
+        size_t prefetches = this->prefetches;
+        size_t pooled_prefetches = this->pooled_prefetches;
+
+        this->simulate_access(trace[accesses[pid][next_access[pid]]]);
+        now += this->flags.memory_latency;
+        this->cpu_busy_time += this->flags.memory_latency;
+
+        // dirty victims are written out before the pages replacing them are
+        // read in
+        for (size_t i = writebacks; i < this->writebacks; i++) {
+            this->swap_device->submit(now, Page::PAGE_SIZE, true);
+        }
+
+        // decompressing a page from the pool keeps the CPU busy instead
+        size_t pool_loads = process->pool_hits - pool_hits + this->pooled_prefetches - pooled_prefetches;
+        now += pool_loads * this->flags.zswap_latency;
+        this->cpu_busy_time += pool_loads * this->flags.zswap_latency;
+
+        double ready_at = now;
+        if (process->page_faults != page_faults && process->pool_hits == pool_hits) {
+            size_t pages = process->huge_faults != huge_faults ? huge_size : 1;
+            ready_at = this->swap_device->submit(now, pages * Page::PAGE_SIZE, false);
+            process->blocked_time += ready_at - now;
+        }
+        size_t prefetch_reads = (this->prefetches - prefetches) - (this->pooled_prefetches - pooled_prefetches);
+        for (size_t i = 0; i < prefetch_reads; i++) {
+            this->swap_device->submit(now, Page::PAGE_SIZE, false);
+        }
+        process->ready_at = ready_at;
+
+        if (++next_access[pid] < accesses[pid].size()) {
+            if (ready_at > now) {
+                waiting.emplace(ready_at, pid);
+            } else {
+                runnable.emplace(accesses[pid][next_access[pid]], pid);
+            }
+        }
+        this->makespan = std::max(this->makespan, ready_at);
+    }
+}
+
+void Simulation::compare_strategies(const std::vector<VirtualAddress>& trace) {
+    const ReplacementStrategy strategies[] = {
+        ReplacementStrategy::FIFO,
+        ReplacementStrategy::LRU,
+        ReplacementStrategy::CLOCK,
+        ReplacementStrategy::SECOND_CHANCE,
+        ReplacementStrategy::ENHANCED_CLOCK,
+        ReplacementStrategy::OPT,
+        ReplacementStrategy::ARC,
+        ReplacementStrategy::TWO_QUEUE
+    };
+
+    this->next_uses = compute_next_uses(trace);
+    this->flags.verbose = false;
+
+    // traces with writes are also compared by the I/O they cost
+    bool has_writes = false;
+    for (size_t i = 0; i < trace.size() && !has_writes; i++) {
+        has_writes = trace[i].write;
+    }
+
+    if (!this->flags.csv) {
+        std::cout << boost::format("%-16s %12s %12s") % "Strategy" % "FAULTS" % "FAULT RATE";
+        if (has_writes) {
+            std::cout << boost::format(" %12s %14s") % "WRITEBACKS" % "I/O COST (ms)";
+        }
+        if (this->flags.swap) {
+            std::cout << boost::format(" %14s") % "MAKESPAN (ms)";
+        }
+        std::cout << "\n";
+    } else {
+        std::cout << (has_writes ? "strategy,faults,fault_rate,writebacks,io_cost_ms" : "strategy,faults,fault_rate");
+        std::cout << (this->flags.swap ? ",makespan_ms\n" : "\n");
+    }
+
+    for (ReplacementStrategy strategy : strategies) {
+        this->flags.strategy = strategy;
+        // the adaptive queues are sized for a fixed number of frames per process
+        bool fixed = this->flags.scope == ReplacementScope::LOCAL && this->flags.allocation == FrameAllocation::FIXED;
+        if (!fixed && this->get_adaptive_policy() != PageTable::AdaptivePolicy::NONE) {
+            continue;
+        }
+        if (this->flags.prefetch != Prefetcher::Policy::NONE && !this->supports_prefetch()) {
+            continue;
+        }
+        if (this->flags.swap && strategy == ReplacementStrategy::OPT) {
+            continue;
+        }
+
+        this->reset();
+        if (this->flags.swap) {
+            this->simulate_with_swap(trace);
+        } else {
+            for (const VirtualAddress& address : trace) {
+                this->simulate_access(address);
+            }
+        }
+
+        double fault_rate = trace.empty() ? 0.0 : 100.0 * this->page_faults / trace.size();
+        if (!this->flags.csv) {
+            std::cout << boost::format("%-16s %12lu %12.2f") % to_string(strategy) % this->page_faults % fault_rate;
+        } else {
+            std::cout << boost::format("%s,%lu,%.2f") % to_string(strategy) % this->page_faults % fault_rate;
+        }
+
+        if (has_writes) {
+            size_t page_ins = this->page_faults;
+            size_t writebacks = 0;
+            size_t pool_hits = 0;
+            for (auto entry : this->processes) {
+                page_ins += entry.second->prefetches;
+                writebacks += entry.second->writebacks;
+                pool_hits += entry.second->pool_hits + entry.second->pooled_prefetches;
+            }
+            double io_cost = this->get_io_cost(page_ins - pool_hits, writebacks, pool_hits);
+
+            if (!this->flags.csv) {
+                std::cout << boost::format(" %12lu %14.2f") % writebacks % io_cost;
+            } else {
+                std::cout << boost::format(",%lu,%.2f") % writebacks % io_cost;
+            }
+        }
+        if (this->flags.swap) {
+            std::cout << boost::format(this->flags.csv ? ",%.2f" : " %14.2f") % (this->makespan / 1e6);
+        }
+        std::cout << "\n";
+    }
+}
+
+void Simulation::reset() {
+    if (this->frame_allocator) {
+        this->frame_allocator->reset();
+    } else {
+        this->frame_allocator = FrameAllocator::create(this->flags.frame_allocator, this->flags.num_frames);
+    }
+    this->frames.assign(this->flags.num_frames, Frame());
+    this->frame_table = PageTable(this->flags.num_frames);
+
+    for (auto entry : this->processes) {
+        Process* process = entry.second;
+        process->page_table = PageTable(process->page_table.rows.size());
+        process->page_table.set_adaptive_policy(this->get_adaptive_policy(), this->flags.max_frames);
+        process->memory_accesses = 0;
+        process->page_faults = 0;
+        process->memory_writes = 0;
+        process->writebacks = 0;
+        process->prefetcher = Prefetcher::create(this->flags.prefetch, this->flags.prefetch_depth);
+        process->prefetches = 0;
+        process->useful_prefetches = 0;
+        process->wasted_prefetches = 0;
+        process->merged_faults = 0;
+        process->cow_breaks = 0;
+        process->huge_regions.assign(this->flags.huge_page_order > 0
+            ? (process->pages.size() + this->get_huge_page_size() - 1) / this->get_huge_page_size() : 0, false);
+        process->huge_faults = 0;
+        process->promotions = 0;
+        process->demotions = 0;
+        process->huge_fallbacks = 0;
+        process->ready_at = 0.0;
+        process->blocked_time = 0.0;
+        process->pool_hits = 0;
+        process->pooled_prefetches = 0;
+        process->interval_start_accesses = 0;
+        process->interval_start_faults = 0;
+        process->interval_start_merged = 0;
+        process->frame_budget = this->flags.max_frames;
+        process->window_start_faults = 0;
+    }
+    this->allocation_history.clear();
+
+    this->budget.reset();
+    if (this->flags.allocation != FrameAllocation::FIXED) {
+        this->budget.reset(new FrameBudget(this->flags.window, this->flags.pff_low, this->flags.pff_high,
+            this->flags.num_frames));
+    }
+
+    this->content_frames.clear();
+    this->frames_saved = 0;
+    this->peak_frames_saved = 0;
+
+    this->tlb.reset();
+    if (this->flags.tlb_entries > 0) {
+        this->tlb.reset(new Tlb(this->flags.tlb_entries, this->flags.tlb_ways, this->flags.tlb_policy));
+    }
+    this->last_process = nullptr;
+    this->context_switches = 0;
+
+    std::vector<CacheHierarchy::Level> cache_levels;
+    for (const CacheHierarchy::Level& level : this->flags.cache_levels) {
+        if (level.size > 0) {
+            cache_levels.push_back(level);
+        }
+    }
+    this->caches.reset();
+    if (!cache_levels.empty()) {
+        this->caches.reset(new CacheHierarchy(cache_levels, this->flags.cache_line, this->flags.cache_policy,
+            this->flags.memory_latency));
+    }
+
+    this->swap_device.reset();
+    if (this->flags.swap) {
+        // MB/s are bytes per microsecond, so a thousandth of a byte per ns
+        this->swap_device.reset(new SwapDevice(this->flags.page_in_latency, this->flags.writeback_latency,
+            this->flags.queue_depth, this->flags.swap_bandwidth / 1000.0));
+    }
+    this->makespan = 0.0;
+    this->cpu_busy_time = 0.0;
+
+    this->compressed_pool.reset();
+    if (this->flags.zswap_frames > 0) {
+        this->compressed_pool.reset(new CompressedPool(this->flags.zswap_frames * Page::PAGE_SIZE));
+    }
+
+    this->page_faults = 0;
+    this->writebacks = 0;
+    this->prefetches = 0;
+    this->pooled_prefetches = 0;
+    this->time = 0;
+}
+
+int Simulation::read_trace(std::vector<VirtualAddress>& trace) {
+    std::vector<VirtualAddress> chunk;
+    while (this->next_addresses(chunk)) {
+        for (const VirtualAddress& address : chunk) {
+            trace.push_back(address);
+        }
     }
 
+    return this->read_error ? 1 : 0;
+}
+
+std::vector<size_t> Simulation::compute_next_uses(const std::vector<VirtualAddress>& trace) {
+    std::vector<size_t> next_uses(trace.size());
+
+    // walking backwards, the last position seen for a page is its next use
+    std::unordered_map<uint64_t, size_t> last_seen;
+    for (size_t i = trace.size(); i-- > 0;) {
+        uint64_t key = ((uint64_t) (uint32_t) trace[i].process_id << 32) | trace[i].page;
+        auto found = last_seen.find(key);
+
+        if (found == last_seen.end()) {
+            next_uses[i] = PageTable::NONE;
+            last_seen.emplace(key, i);
+        } else {
+            next_uses[i] = found->second;
+            found->second = i;
+        }
+    }
+    return next_uses;
 }
 
 char Simulation::perform_memory_access(const VirtualAddress& virtual_address) {
     // find the process using the pid
     Process* temp_process = this->processes[virtual_address.process_id];
 
-    // check for a page seg fault - is the page valid
-    if (temp_process->is_valid_page(virtual_address.page)) {
+    // check for a page seg fault - is the page valid
+    if (temp_process->is_valid_page(virtual_address.page)) {
+
+        // no page seg fault...
+        // check for page fault - is the page in the table
+        if (temp_process->page_table.rows[virtual_address.page].present) { // is this right?
+            // page is present...
+            if (this->trace_sink) {
+                this->trace_sink->event(TraceSink::Event::IN_MEMORY);
+            }
+
+            // increment memory accesses counter
+            temp_process->memory_accesses++;
+
+            // convert virtual address to a physical address
+            int frame = temp_process->page_table.rows[virtual_address.page].frame;
+            int offset = virtual_address.offset;
+            PhysicalAddress physical_address = PhysicalAddress(frame, offset);
+            if (this->trace_sink) {
+                this->trace_sink->physical_address(physical_address);
+            }
+            if (this->caches) {
+                this->access_caches(temp_process, physical_address);
+            }
+
+            // check if offset is valid
+            if (temp_process->pages[virtual_address.page].is_valid_offset(offset)) {
+                // set the access time and return the byte at the offset
+                temp_process->page_table.touch_page(virtual_address.page, this->time);
+                this->frame_table.touch_page(frame, this->time);
+
+                // the first use of a prefetched page may call for more
+                PageTable::Row& row = temp_process->page_table.rows[virtual_address.page];
+                row.untouched = false;
+                if (row.prefetched) {
+                    row.prefetched = false;
+                    temp_process->useful_prefetches++;
+
+                    this->prefetch_candidates.clear();
+                    temp_process->prefetcher->on_prefetch_hit(virtual_address.page, this->prefetch_candidates);
+                    this->prefetch_pages(temp_process, this->prefetch_candidates, false);
+                    assert(temp_process->page_table.rows[virtual_address.page].present);
+                }
+                return temp_process->pages[virtual_address.page].get_byte_at_offset(offset);
+            } else {
+                // return seg fault - invalid offset
+                if (this->trace_sink) {
+                    this->trace_sink->flush();
+                }
+                std::cout << "SEGFAULT - INVALID OFFSET" << std::endl;
+                exit(-1);
+            }
+            
+        } else {
+            // page is not present...
+            if (this->trace_sink) {
+                this->trace_sink->event(TraceSink::Event::PAGE_FAULT);
+            }
+
+            // increment memory accesses counter
+            temp_process->memory_accesses++;
+
+            // a page kept in the compressed pool only has to be decompressed
+            bool pool_dirty = false;
+            bool pooled = this->compressed_pool
+                && this->load_from_pool(temp_process, virtual_address.page, pool_dirty);
+
+            // bring in the pages the prefetcher expects next, before the
+            // faulting page so that it is the most recently loaded
+            if (temp_process->prefetcher) {
+                this->prefetch_candidates.clear();
+                temp_process->prefetcher->on_fault(virtual_address.page, this->prefetch_candidates);
+                this->prefetch_pages(temp_process, this->prefetch_candidates);
+            }
+
+            // handle the page fault, which only counts if the page had to be
+            // read in rather than found in a shared frame
+            if (handle_page_fault(temp_process, virtual_address.page)) {
+                temp_process->merged_faults++;
+                if (this->trace_sink) {
+                    this->trace_sink->event(TraceSink::Event::SHARED_FRAME);
+                }
+            } else {
+                temp_process->page_faults++;
+                this->page_faults++;
+            }
+
+            // the pool held the only up-to-date copy of a dirty page
+            if (pooled) {
+                temp_process->pool_hits++;
+                if (pool_dirty) {
+                    temp_process->page_table.mark_dirty(virtual_address.page);
+                    this->frame_table.mark_dirty(temp_process->page_table.rows[virtual_address.page].frame);
+                }
+            }
+
+            // convert virtual address to a physical address
+            int frame = temp_process->page_table.rows[virtual_address.page].frame;
+            int offset = virtual_address.offset;
+            PhysicalAddress physical_address = PhysicalAddress(frame, offset);
+            if (this->trace_sink) {
+                this->trace_sink->physical_address(physical_address);
+            }
+            if (this->caches) {
+                this->access_caches(temp_process, physical_address);
+            }
+
+            // check if offset is valid
+            if (temp_process->pages[virtual_address.page].is_valid_offset(offset)) {
+                // loading the page already recorded this access, so return the byte
+                return temp_process->pages[virtual_address.page].get_byte_at_offset(offset);
+            } else {
+                // return seg fault - invalid offset
+                if (this->trace_sink) {
+                    this->trace_sink->flush();
+                }
+                std::cout << "SEGFAULT - INVALID OFFSET" << std::endl;
+                exit(-1);
+            }
+
+        }
+        
+
+    } else {
+        // return page seg fault
+        if (this->trace_sink) {
+            this->trace_sink->flush();
+        }
+        std::cout << "SEGFAULT - INVALID PAGE" << std::endl;
+        exit(-1);
+    }
+}
+
+bool Simulation::handle_page_fault(Process* process, size_t page) {
+    size_t frame_to_use;
+
+    // a page read in any other way (a prefetch, say) makes its copy in the
+    // pool stale
+    if (this->compressed_pool) {
+        this->compressed_pool->discard(((uint64_t) process->asid << 32) | page);
+    }
+
+    // with room in the budget, an identical page can be shared right away
+    bool room = this->flags.scope == ReplacementScope::GLOBAL
+        || process->page_table.get_present_page_count() < this->get_frame_budget(process);
+    if (this->flags.dedup && room && this->map_shared_frame(process, page)) {
+        return true;
+    }
+
+    // a run that was a huge page before faults back in whole
+    if (this->flags.huge_page_order > 0 && this->fault_huge_page(process, page)) {
+        return false;
+    }
+
+    if (this->flags.scope == ReplacementScope::GLOBAL) {
+        // any free frame will do, or else any page in memory may have to go
+        frame_to_use = this->frame_allocator->allocate();
+        if (frame_to_use == FrameAllocator::NONE) {
+            frame_to_use = this->select_victim(this->frame_table, page);
+            this->evict_frame(frame_to_use);
+        }
+
+    // compare the page count in the page table to the process's budget
+    } else if (process->page_table.get_present_page_count() < this->get_frame_budget(process)
+            && this->frame_allocator->get_free_count() > 0) {
+        // take the next free frame available
+        frame_to_use = this->frame_allocator->allocate();
+    } else if (process->page_table.get_present_page_count() == 0) {
+        // memory is full of other processes' pages, so take the stalest one
+        frame_to_use = this->frame_table.get_least_recently_used_page();
+        this->evict_frame(frame_to_use);
+    } else {
+        // check flags for the strategy to pick the page to replace
+        size_t page_to_change = this->select_victim(process->page_table, page);
+
+        // reuse the old page's frame for the new page
+        frame_to_use = process->page_table.rows[page_to_change].frame;
+        this->evict_frame(frame_to_use);
+    }
+
+    // otherwise the page may still be shared now that there is room for it
+    if (this->flags.dedup && !room && this->map_shared_frame(process, page)) {
+        this->frame_allocator->free(frame_to_use);
+        return true;
+    }
+
+    // set up the page table row and set_page() for the given frame
+    process->page_table.load_page(page, frame_to_use, this->time);
+    this->frame_table.load_page(frame_to_use, frame_to_use, this->time);
+    this->frames[frame_to_use].set_page(process, page);
+
+    if (this->flags.dedup) {
+        this->index_contents(process, page, frame_to_use);
+    }
+    if (this->flags.huge_page_order > 0) {
+        this->promote(process, page);
+    }
+    return false;
+}
+
+size_t Simulation::get_huge_page_size() const {
+    return size_t(1) << this->flags.huge_page_order;
+}
+
+bool Simulation::fault_huge_page(Process* process, size_t page) {
+    size_t size = this->get_huge_page_size();
+    size_t first = page - page % size;
+    if (!process->huge_regions[first / size] || !process->is_valid_page(first + size - 1)) {
+        return false;
+    }
+    for (size_t i = first; i < first + size; i++) {
+        if (process->page_table.rows[i].present) {
+            return false;
+        }
+    }
+
+    // make room for the whole run within the process's budget
+    if (this->flags.scope == ReplacementScope::LOCAL) {
+        size_t budget = this->get_frame_budget(process);
+        if (budget < size) {
+            return false;
+        }
+        while (process->page_table.get_present_page_count() + size > budget) {
+            size_t frame = process->page_table.rows[this->select_victim(process->page_table, page)].frame;
+            this->evict_frame(frame);
+            this->frame_allocator->free(frame);
+        }
+    }
+
+    size_t block = this->frame_allocator->allocate_contiguous(size, size);
+    if (block == FrameAllocator::NONE) {
+        process->huge_fallbacks++;
+        process->huge_regions[first / size] = false;
+        return false;
+    }
+
+    // load the rest of the run first, so the faulting page is the most recent
+    for (size_t i = 1; i <= size; i++) {
+        size_t loaded = first + (page - first + i) % size;
+        size_t frame = block + (loaded - first);
+
+        process->page_table.load_page(loaded, frame, this->time);
+        this->frame_table.load_page(frame, frame, this->time);
+        this->frames[frame].set_page(process, loaded);
+        process->page_table.rows[loaded].huge = true;
+        process->page_table.rows[loaded].untouched = loaded != page;
+    }
+
+    process->huge_faults++;
+    if (this->trace_sink) {
+        this->trace_sink->event(TraceSink::Event::HUGE_PAGE_FAULT);
+    }
+    return true;
+}
+
+void Simulation::promote(Process* process, size_t page) {
+    size_t size = this->get_huge_page_size();
+    size_t first = page - page % size;
+    if (!process->is_valid_page(first + size - 1)) {
+        return;
+    }
+    for (size_t i = first; i < first + size; i++) {
+        if (!process->page_table.rows[i].present) {
+            return;
+        }
+    }
+
+    size_t block = this->frame_allocator->allocate_contiguous(size, size);
+    if (block == FrameAllocator::NONE) {
+        return;
+    }
+
+    // copy each page to its place in the contiguous frames
+    for (size_t i = 0; i < size; i++) {
+        PageTable::Row& row = process->page_table.rows[first + i];
+        size_t old_frame = row.frame;
+        size_t frame = block + i;
+
+        this->frame_table.load_page(frame, frame, this->time);
+        this->frame_table.set_next_use(frame, this->frame_table.rows[old_frame].next_use);
+        if (row.dirty) {
+            this->frame_table.mark_dirty(frame);
+        }
+        this->frame_table.unload_page(old_frame);
+        this->frames[old_frame].mappings.clear();
+        this->frames[frame].set_page(process, first + i);
+        this->frame_allocator->free(old_frame);
+        if (this->caches) {
+            this->caches->invalidate((uint64_t) old_frame * Page::PAGE_SIZE, Page::PAGE_SIZE);
+        }
+
+        row.frame = frame;
+        row.huge = true;
+        if (this->tlb) {
+            this->tlb->invalidate(process->asid, first + i);
+        }
+    }
+
+    process->huge_regions[first / size] = true;
+    process->promotions++;
+    if (this->trace_sink) {
+        this->trace_sink->event(TraceSink::Event::PROMOTED);
+    }
+}
+
+void Simulation::split_huge_page(Process* process, size_t page) {
+    size_t size = this->get_huge_page_size();
+    size_t first = page - page % size;
+    for (size_t i = first; i < first + size; i++) {
+        process->page_table.rows[i].huge = false;
+    }
+
+    if (this->tlb) {
+        this->tlb->invalidate(process->asid, first / size, true);
+    }
+}
+
+bool Simulation::map_shared_frame(Process* process, size_t page) {
+    if (process->page_table.rows[page].modified) {
+        return false;
+    }
+
+    // hashes can collide, so make sure the contents really are the same
+    const Page& contents = process->pages[page];
+    auto found = this->content_frames.find(contents.hash());
+    if (found == this->content_frames.end()
+            || !this->frames[found->second].contents->has_same_contents(contents)) {
+        return false;
+    }
+
+    size_t frame = found->second;
+    process->page_table.load_page(page, frame, this->time);
+    this->frame_table.touch_page(frame, this->time);
+    this->frames[frame].add_mapping(process, page);
+
+    this->frames_saved++;
+    this->peak_frames_saved = std::max(this->peak_frames_saved, this->frames_saved);
+    return true;
+}
+
+void Simulation::index_contents(Process* process, size_t page, size_t frame) {
+    if (!process->page_table.rows[page].modified) {
+        this->content_frames.emplace(process->pages[page].hash(), frame);
+    }
+}
+
+void Simulation::forget_contents(size_t frame) {
+    const Page* contents = this->frames[frame].contents;
+    if (contents == nullptr) {
+        return;
+    }
+
+    auto found = this->content_frames.find(contents->hash());
+    if (found != this->content_frames.end() && found->second == frame) {
+        this->content_frames.erase(found);
+    }
+}
+
+void Simulation::break_sharing(Process* process, size_t page) {
+    PageTable::Row& row = process->page_table.rows[page];
+    if (row.modified) {
+        return;
+    }
+    row.modified = true;
+
+    // the only copy is about to change, so nothing may share it any more
+    size_t frame = row.frame;
+    if (this->frames[frame].get_reference_count() == 1) {
+        this->forget_contents(frame);
+        return;
+    }
+
+    // otherwise the writer gets a copy of its own and the rest keep sharing
+    if (this->trace_sink) {
+        this->trace_sink->event(TraceSink::Event::COPY_ON_WRITE);
+    }
+    this->frames[frame].remove_mapping(process, page);
+    this->frames_saved--;
+    process->page_table.unload_page(page);
+    if (this->tlb) {
+        this->tlb->invalidate(process->asid, page);
+    }
+
+    process->cow_breaks++;
+    this->handle_page_fault(process, page);
+}
+
+void Simulation::prefetch_pages(Process* process, const std::vector<size_t>& pages, bool evict) {
+    size_t budget = this->flags.scope == ReplacementScope::GLOBAL
+        ? this->flags.num_frames : this->get_frame_budget(process);
+
+    // without evicting, only the free frames the process has room for
+    size_t room = budget;
+    if (!evict) {
+        room = this->frame_allocator->get_free_count();
+        if (this->flags.scope == ReplacementScope::LOCAL) {
+            size_t present = process->page_table.get_present_page_count();
+            room = std::min(room, budget > present ? budget - present : 0);
+        }
+    }
+
+    size_t loaded = 0;
+    for (size_t page : pages) {
+        if (loaded + 1 >= budget || loaded >= room) {
+            break;
+        }
+        if (!process->is_valid_page(page) || process->page_table.rows[page].present) {
+            continue;
+        }
+
+        if (this->trace_sink) {
+            this->trace_sink->prefetched(page);
+        }
+
+        // the pool may hold the only up-to-date copy of the page
+        bool pool_dirty = false;
+        bool pooled = this->compressed_pool && this->load_from_pool(process, page, pool_dirty);
+
+        this->handle_page_fault(process, page);
+        process->page_table.rows[page].prefetched = true;
+        process->prefetches++;
+        this->prefetches++;
+        loaded++;
+
+        if (pooled) {
+            process->pooled_prefetches++;
+            this->pooled_prefetches++;
+            if (pool_dirty) {
+                process->page_table.mark_dirty(page);
+                this->frame_table.mark_dirty(process->page_table.rows[page].frame);
+            }
+        }
+    }
+}
+
+void Simulation::access_caches(Process* process, const PhysicalAddress& address) {
+    uint64_t location = ((uint64_t) address.frame << PhysicalAddress::OFFSET_BITS) | address.offset;
+    size_t level = this->caches->access(process->asid, location);
+
+    if (this->trace_sink) {
+        if (level < this->caches->get_level_count()) {
+            this->trace_sink->cache_hit(this->caches->get_name(level));
+        } else {
+            this->trace_sink->event(TraceSink::Event::CACHE_MISS);
+        }
+    }
+}
+
+bool Simulation::load_from_pool(Process* process, size_t page, bool& dirty) {
+    std::string bytes;
+    if (!this->compressed_pool->load(((uint64_t) process->asid << 32) | page, bytes, dirty)) {
+        return false;
+    }
+
+    // decompression has to give back exactly the page that went in
+    const Page& contents = process->pages[page];
+    assert(bytes.size() == contents.size() && bytes.compare(0, bytes.size(), contents.data(), contents.size()) == 0);
+
+    if (this->trace_sink) {
+        this->trace_sink->event(TraceSink::Event::FROM_POOL);
+    }
+    return true;
+}
+
+bool Simulation::store_in_pool(Process* process, size_t page) {
+    std::vector<std::pair<uint64_t, bool>> evicted;
+    const Page& contents = process->pages[page];
+    bool stored = this->compressed_pool->store(((uint64_t) process->asid << 32) | page,
+        contents.data(), contents.size(), process->page_table.rows[page].dirty, evicted);
+
+    for (auto& entry : evicted) {
+        if (!entry.second) {
+            continue;
+        }
+        for (auto& other : this->processes) {
+            if (other.second->asid == entry.first >> 32) {
+                other.second->writebacks++;
+                this->writebacks++;
+            }
+        }
+    }
+    return stored;
+}
+
+void Simulation::evict_frame(size_t frame) {
+    Frame& victim = this->frames[frame];
+    if (this->flags.dedup) {
+        this->forget_contents(frame);
+        this->frames_saved -= victim.get_reference_count() - 1;
+    }
+
+    // a huge page goes out whole, unless frames are short, in which case it
+    // is broken up and only the one page goes
+    if (this->flags.huge_page_order > 0 && !victim.mappings.empty()
+            && victim.process->page_table.rows[victim.page_number].huge) {
+        Process* process = victim.process;
+        size_t page = victim.page_number;
+        this->split_huge_page(process, page);
+
+        if (this->frame_allocator->get_free_count() == 0) {
+            process->demotions++;
+            if (this->trace_sink) {
+                this->trace_sink->event(TraceSink::Event::DEMOTED);
+            }
+        } else {
+            size_t size = this->get_huge_page_size();
+            for (size_t i = page - page % size; i < page - page % size + size; i++) {
+                size_t other = process->page_table.rows[i].frame;
+                if (i != page) {
+                    this->evict_frame(other);
+                    this->frame_allocator->free(other);
+                }
+            }
+        }
+    }
+
+    // the frame knows which processes and pages it holds
+    for (auto& mapping : victim.mappings) {
+        Process* process = mapping.first;
+        size_t page = mapping.second;
+
+        // a page the pool keeps is only written back if it is pushed out
+        bool pooled = this->compressed_pool && this->store_in_pool(process, page);
+        if (process->page_table.rows[page].dirty && !pooled) {
+            process->writebacks++;
+            this->writebacks++;
+        }
+        if (process->page_table.rows[page].prefetched) {
+            process->wasted_prefetches++;
+        }
+        process->page_table.unload_page(page);
+
+        if (this->tlb) {
+            this->tlb->invalidate(process->asid, page);
+        }
+    }
+    victim.mappings.clear();
+    this->frame_table.unload_page(frame);
+
+    // the frame's next page is read in over whatever the caches held of it
+    if (this->caches) {
+        this->caches->invalidate((uint64_t) frame * Page::PAGE_SIZE, Page::PAGE_SIZE);
+    }
+}
+
+void Simulation::release_frame(size_t frame) {
+    this->evict_frame(frame);
+    this->frame_allocator->free(frame);
+}
+
+size_t Simulation::get_frame_budget(Process* process) const {
+    switch (this->flags.allocation) {
+        case FrameAllocation::FIXED:
+            return this->flags.max_frames;
+
+        case FrameAllocation::WORKING_SET:
+            // the working set is trimmed as it goes, so never hold it back
+            return this->flags.num_frames;
+
+        case FrameAllocation::PFF:
+            return process->frame_budget;
+    }
+    return this->flags.max_frames;
+}
+
+void Simulation::trim_working_sets() {
+    size_t frame;
+    while ((frame = this->budget->get_expired_frame(this->frame_table, this->time)) != PageTable::NONE) {
+        this->release_frame(frame);
+    }
+}
+
+void Simulation::adjust_frame_budget(Process* process) {
+    if (!this->budget->is_window_end(process->memory_accesses)) {
+        return;
+    }
+
+    process->frame_budget = this->budget->adjust(process->frame_budget,
+        process->page_faults - process->window_start_faults);
+    process->window_start_faults = process->page_faults;
+
+    // give back whatever the process holds beyond its new budget
+    while (process->page_table.get_present_page_count() > process->frame_budget) {
+        size_t page = this->select_victim(process->page_table, PageTable::NONE);
+        this->release_frame(process->page_table.rows[page].frame);
+    }
+}
+
+int Simulation::open_trace_sink() {
+    if (!this->flags.event_log.empty()) {
+        this->event_log_file.open(this->flags.event_log, std::ios::binary);
+        if (!this->event_log_file) {
+            std::cerr << "Unable to open file: " << this->flags.event_log << std::endl;
+            return 1;
+        }
+        this->trace_sink.reset(new TraceSink(this->event_log_file, true));
+    } else if (this->flags.verbose) {
+        this->trace_sink.reset(new TraceSink(std::cout));
+    }
+    return 0;
+}
+
+int Simulation::open_intervals() {
+    std::ostream* out = &std::cout;
+    if (!this->flags.interval_output.empty()) {
+        this->interval_file.open(this->flags.interval_output);
+        if (!this->interval_file) {
+            std::cerr << "Unable to open file: " << this->flags.interval_output << std::endl;
+            return 1;
+        }
+        out = &this->interval_file;
+    }
+
+    this->interval_writer.reset(new BufferedWriter(*out));
+    this->intervals_written = 0;
+    if (this->flags.interval_format == IntervalFormat::CSV) {
+        this->interval_writer->write(std::string("window,time,pid,accesses,faults,hits,rss,fault_rate\n"));
+    }
+    return 0;
+}
+
+void Simulation::write_interval(size_t end) {
+    boost::format row_fmt(this->flags.interval_format == IntervalFormat::CSV
+        ? "%lu,%lu,%d,%lu,%lu,%lu,%lu,%.2f\n"
+        : "{\"window\":%lu,\"time\":%lu,\"pid\":%d,\"accesses\":%lu,\"faults\":%lu,"
+          "\"hits\":%lu,\"rss\":%lu,\"fault_rate\":%.2f}\n");
+
+    for (auto entry : this->processes) {
+        Process* process = entry.second;
+        size_t accesses = process->memory_accesses - process->interval_start_accesses;
+        size_t faults = process->page_faults - process->interval_start_faults;
+        size_t merged = process->merged_faults - process->interval_start_merged;
+
+        // the page table keeps count of its present pages as they come and go
+        this->interval_writer->write((row_fmt
+            % this->intervals_written
+            % end
+            % entry.first
+            % accesses
+            % faults
+            % (accesses - faults - merged)
+            % process->get_rss()
+            % (accesses == 0 ? 0.0 : 100.0 * faults / accesses)).str());
+
+        process->interval_start_accesses = process->memory_accesses;
+        process->interval_start_faults = process->page_faults;
+        process->interval_start_merged = process->merged_faults;
+    }
+    this->intervals_written++;
+}
+
+void Simulation::close_intervals() {
+    if (this->time % this->flags.interval != 0) {
+        this->write_interval(this->time);
+    }
+
+    this->interval_writer.reset();
+    if (this->interval_file.is_open()) {
+        this->interval_file.close();
+    }
+}
+
+void Simulation::print_allocation_history() {
+    if (!this->flags.csv) {
+        std::cout << boost::format("\n%-10s") % "Time";
+        for (auto entry : this->processes) {
+            std::cout << boost::format("PID %-6d ") % entry.first;
+        }
+        std::cout << "\n";
+    } else {
+        std::cout << "time";
+        for (auto entry : this->processes) {
+            std::cout << "," << entry.first;
+        }
+        std::cout << "\n";
+    }
+
+    size_t num_processes = this->processes.size();
+    for (size_t i = 0; i < this->allocation_history.size(); i += num_processes) {
+        size_t time = (i / num_processes + 1) * this->flags.window;
+
+        if (!this->flags.csv) {
+            std::cout << boost::format("%-10lu") % time;
+            for (size_t j = 0; j < num_processes; j++) {
+                std::cout << boost::format("%-10lu ") % this->allocation_history[i + j];
+            }
+        } else {
+            std::cout << time;
+            for (size_t j = 0; j < num_processes; j++) {
+                std::cout << "," << this->allocation_history[i + j];
+            }
+        }
+        std::cout << "\n";
+    }
+}
+
+size_t Simulation::select_victim(PageTable& page_table, size_t page) {
+    switch (flags.strategy) {
+        case ReplacementStrategy::FIFO:
+            if (flags.prefer_clean) {
+                return page_table.get_oldest_clean_page();
+            }
+            return page_table.get_oldest_page();
+
+        case ReplacementStrategy::LRU:
+            if (flags.prefer_clean) {
+                return page_table.get_least_recently_used_clean_page();
+            }
+            return page_table.get_least_recently_used_page();
+
+        case ReplacementStrategy::CLOCK:
+            if (flags.prefer_clean) {
+                return page_table.get_enhanced_clock_victim();
+            }
+            return page_table.get_clock_victim();
+
+        case ReplacementStrategy::SECOND_CHANCE:
+            return page_table.get_second_chance_victim();
+
+        case ReplacementStrategy::ENHANCED_CLOCK:
+            return page_table.get_enhanced_clock_victim();
+
+        case ReplacementStrategy::OPT:
+            return page_table.get_optimal_victim();
+
+        case ReplacementStrategy::ARC:
+            return page_table.get_arc_victim(page);
+
+        case ReplacementStrategy::TWO_QUEUE:
+            return page_table.get_two_queue_victim();
+    }
+    return page_table.get_oldest_page();
+}
+
+bool Simulation::uses_clock_hand() const {
+    return flags.strategy == ReplacementStrategy::CLOCK
+        || flags.strategy == ReplacementStrategy::SECOND_CHANCE
+        || flags.strategy == ReplacementStrategy::ENHANCED_CLOCK;
+}
+
+PageTable::AdaptivePolicy Simulation::get_adaptive_policy() const {
+    switch (flags.strategy) {
+        case ReplacementStrategy::ARC:
+            return PageTable::AdaptivePolicy::ARC;
+
+        case ReplacementStrategy::TWO_QUEUE:
+            return PageTable::AdaptivePolicy::TWO_QUEUE;
+
+        default:
+            return PageTable::AdaptivePolicy::NONE;
+    }
+}
+
+void Simulation::print_summary() {
+    // total up the work the clock hands did, if there are any, and how often
+    // the adaptive policies' ghost lists paid off
+    size_t hand_sweeps = 0;
+    size_t recent_ghost_hits = 0;
+    size_t frequent_ghost_hits = 0;
+    for (auto entry : this->processes) {
+        hand_sweeps += entry.second->page_table.hand_sweeps;
+        recent_ghost_hits += entry.second->page_table.recent_ghost_hits;
+        frequent_ghost_hits += entry.second->page_table.frequent_ghost_hits;
+    }
+    hand_sweeps += this->frame_table.hand_sweeps;
+    PageTable::AdaptivePolicy adaptive_policy = this->get_adaptive_policy();
+
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "ACCESSES: %-6lu "
+            "FAULTS: %-6lu "
+            "FAULT RATE: %-8.2f "
+            "RSS: %-6lu\n");
+
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->memory_accesses
+                % entry.second->page_faults
+                % entry.second->get_fault_percent()
+                % entry.second->get_rss();
+        }
+
+        // Print statistics.
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n");
+
+        std::cout << summary_fmt
+            % "Total memory accesses:"
+            % this->memory_accesses
+            % "Total page faults:"
+            % this->page_faults
+            % "Free frames remaining:"
+            % this->frame_allocator->get_free_count();
+
+        if (this->uses_clock_hand()) {
+            std::cout << boost::format("%-25s %12lu\n") % "Clock hand sweeps:" % hand_sweeps;
+        }
+
+        if (adaptive_policy == PageTable::AdaptivePolicy::ARC) {
+            std::cout << boost::format("%-25s %12lu\n%-25s %12lu\n")
+                % "Ghost hits (B1):" % recent_ghost_hits
+                % "Ghost hits (B2):" % frequent_ghost_hits;
+        } else if (adaptive_policy == PageTable::AdaptivePolicy::TWO_QUEUE) {
+            std::cout << boost::format("%-25s %12lu\n") % "Ghost hits (A1out):" % recent_ghost_hits;
+        }
+    }
+
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%lu,"
+            "%lu,"
+            "%.2f,"
+            "%lu\n");
+
+        for (auto entry : processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->memory_accesses
+                % entry.second->page_faults
+                % entry.second->get_fault_percent()
+                % entry.second->get_rss();
+        }
+
+        // Print statistics.
+        boost::format summary_fmt(
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n");
+
+        std::cout << summary_fmt
+            % this->memory_accesses
+            % this->page_faults
+            % this->frame_allocator->get_free_count();
+
+        if (this->uses_clock_hand()) {
+            std::cout << boost::format("%lu,,,,\n") % hand_sweeps;
+        }
+
+        if (adaptive_policy == PageTable::AdaptivePolicy::ARC) {
+            std::cout << boost::format("%lu,,,,\n%lu,,,,\n") % recent_ghost_hits % frequent_ghost_hits;
+        } else if (adaptive_policy == PageTable::AdaptivePolicy::TWO_QUEUE) {
+            std::cout << boost::format("%lu,,,,\n") % recent_ghost_hits;
+        }
+    }
+}
+
+void Simulation::print_cache_summary() {
+    const CacheHierarchy& caches = *this->caches;
+    size_t levels = caches.get_level_count();
+    size_t invalidations = 0;
+    for (size_t level = 0; level < levels; level++) {
+        invalidations += caches.get_cache(level).invalidations;
+    }
+    auto hit_rate = [](size_t hits, size_t misses) {
+        return hits + misses == 0 ? 0.0 : 100.0 * hits / (hits + misses);
+    };
+
+    if (!this->flags.csv) {
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            size_t asid = entry.second->asid;
+            std::cout << boost::format("Process %3d:  ") % entry.first;
+            for (size_t level = 0; level < levels; level++) {
+                std::cout << boost::format("%s HIT RATE: %-8.2f ")
+                    % caches.get_name(level)
+                    % hit_rate(caches.get_hits(level, asid), caches.get_misses(level, asid));
+            }
+            std::cout << boost::format("AMAT (ns): %-8.2f\n") % caches.get_amat(asid);
+        }
+
+        std::cout << "\n";
+        for (size_t level = 0; level < levels; level++) {
+            const Cache& cache = caches.get_cache(level);
+            std::string name = caches.get_name(level);
+            std::cout << boost::format("%-25s %12lu\n%-25s %12lu\n%-25s %12.2f\n")
+                % (name + " hits:")
+                % cache.hits
+                % (name + " misses:")
+                % cache.misses
+                % (name + " hit rate:")
+                % hit_rate(cache.hits, cache.misses);
+        }
+        std::cout << boost::format("%-25s %12lu\n%-25s %12.2f\n")
+            % "Lines invalidated:"
+            % invalidations
+            % "Mean access time (ns):"
+            % caches.get_amat();
+    }
+
+    if (this->flags.csv) {
+        // one column per level, after the PID and before the AMAT
+        std::string padding(levels + 1, ',');
+
+        for (auto entry : this->processes) {
+            size_t asid = entry.second->asid;
+            std::cout << entry.first;
+            for (size_t level = 0; level < levels; level++) {
+                std::cout << boost::format(",%.2f")
+                    % hit_rate(caches.get_hits(level, asid), caches.get_misses(level, asid));
+            }
+            std::cout << boost::format(",%.2f\n") % caches.get_amat(asid);
+        }
+
+        for (size_t level = 0; level < levels; level++) {
+            const Cache& cache = caches.get_cache(level);
+            std::cout << boost::format("%lu%s\n%lu%s\n%.2f%s\n")
+                % cache.hits % padding
+                % cache.misses % padding
+                % hit_rate(cache.hits, cache.misses) % padding;
+        }
+        std::cout << boost::format("%lu%s\n%.2f%s\n")
+            % invalidations % padding
+            % caches.get_amat() % padding;
+    }
+}
+
+double Simulation::get_effective_access_time(double hit_rate) const {
+    return this->flags.tlb_latency + this->flags.memory_latency
+        + (1.0 - hit_rate) * this->flags.memory_latency;
+}
+
+void Simulation::print_tlb_summary() {
+    auto hit_rate = [](size_t hits, size_t misses) {
+        return hits + misses == 0 ? 0.0 : (double) hits / (hits + misses);
+    };
+
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "TLB HITS: %-6lu "
+            "TLB MISSES: %-6lu "
+            "HIT RATE: %-8.2f "
+            "EAT: %-8.2f\n");
+
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            size_t hits = this->tlb->get_hits(entry.second->asid);
+            size_t misses = this->tlb->get_misses(entry.second->asid);
+            double rate = hit_rate(hits, misses);
+
+            std::cout << process_fmt
+                % entry.first
+                % hits
+                % misses
+                % (100.0 * rate)
+                % this->get_effective_access_time(rate);
+        }
+
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12.2f\n");
+
+        double rate = hit_rate(this->tlb->hits, this->tlb->misses);
+        std::cout << summary_fmt
+            % "Total TLB hits:"
+            % this->tlb->hits
+            % "Total TLB misses:"
+            % this->tlb->misses
+            % "Context switches:"
+            % this->context_switches
+            % "TLB flushes:"
+            % this->tlb->flushes
+            % "TLB shootdowns:"
+            % this->tlb->shootdowns
+            % "Effective access (ns):"
+            % this->get_effective_access_time(rate);
+    }
+
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%lu,"
+            "%lu,"
+            "%.2f,"
+            "%.2f\n");
+
+        for (auto entry : this->processes) {
+            size_t hits = this->tlb->get_hits(entry.second->asid);
+            size_t misses = this->tlb->get_misses(entry.second->asid);
+            double rate = hit_rate(hits, misses);
+
+            std::cout << process_fmt
+                % entry.first
+                % hits
+                % misses
+                % (100.0 * rate)
+                % this->get_effective_access_time(rate);
+        }
+
+        boost::format summary_fmt(
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%.2f,,,,\n");
+
+        std::cout << summary_fmt
+            % this->tlb->hits
+            % this->tlb->misses
+            % this->context_switches
+            % this->tlb->flushes
+            % this->tlb->shootdowns
+            % this->get_effective_access_time(hit_rate(this->tlb->hits, this->tlb->misses));
+    }
+}
+
+void Simulation::print_io_summary() {
+    // prefetched pages have to be read in just the same
+    size_t page_ins = this->page_faults;
+    size_t writebacks = 0;
+    size_t pool_hits = 0;
+    for (auto entry : this->processes) {
+        page_ins += entry.second->prefetches;
+        writebacks += entry.second->writebacks;
+        pool_hits += entry.second->pool_hits + entry.second->pooled_prefetches;
+    }
+    page_ins -= pool_hits;
+
+    // pages the compressed pool served were not read in
+    auto process_cost = [this](Process* process) {
+        size_t pool_loads = process->pool_hits + process->pooled_prefetches;
+        return this->get_io_cost(process->page_faults + process->prefetches - pool_loads,
+            process->writebacks, pool_loads);
+    };
+
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "WRITES: %-6lu "
+            "WRITEBACKS: %-6lu "
+            "I/O COST (ms): %-8.2f\n");
+
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->memory_writes
+                % entry.second->writebacks
+                % process_cost(entry.second);
+        }
+
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12.2f\n");
+
+        std::cout << summary_fmt
+            % "Total memory writes:"
+            % this->get_memory_writes()
+            % "Dirty writebacks:"
+            % writebacks
+            % "Total I/O cost (ms):"
+            % this->get_io_cost(page_ins, writebacks, pool_hits);
+    }
+
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%lu,"
+            "%lu,"
+            "%.2f\n");
+
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->memory_writes
+                % entry.second->writebacks
+                % process_cost(entry.second);
+        }
+
+        boost::format summary_fmt(
+            "%lu,,,\n"
+            "%lu,,,\n"
+            "%.2f,,,\n");
+
+        std::cout << summary_fmt
+            % this->get_memory_writes()
+            % writebacks
+            % this->get_io_cost(page_ins, writebacks, pool_hits);
+    }
+}
+
+void Simulation::print_allocator_summary() {
+    if (!this->flags.csv) {
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n");
+
+        std::cout << summary_fmt
+            % "Frame allocations:"
+            % this->frame_allocator->get_allocations()
+            % "Frame frees:"
+            % this->frame_allocator->get_frees()
+            % "Failed allocations:"
+            % this->frame_allocator->get_failed_allocations();
+    }
+
+    if (this->flags.csv) {
+        boost::format summary_fmt(
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n");
+
+        std::cout << summary_fmt
+            % this->frame_allocator->get_allocations()
+            % this->frame_allocator->get_frees()
+            % this->frame_allocator->get_failed_allocations();
+    }
+}
+
+void Simulation::print_prefetch_summary() {
+    size_t prefetches = 0;
+    size_t useful = 0;
+    size_t wasted = 0;
+    for (auto entry : this->processes) {
+        prefetches += entry.second->prefetches;
+        useful += entry.second->useful_prefetches;
+        wasted += entry.second->wasted_prefetches;
+    }
+
+    auto accuracy = [](size_t useful, size_t prefetches) {
+        return prefetches == 0 ? 0.0 : 100.0 * useful / prefetches;
+    };
+
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "PREFETCHES: %-6lu "
+            "USEFUL: %-6lu "
+            "WASTED: %-6lu "
+            "ACCURACY: %-8.2f\n");
+
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->prefetches
+                % entry.second->useful_prefetches
+                % entry.second->wasted_prefetches
+                % accuracy(entry.second->useful_prefetches, entry.second->prefetches);
+        }
+
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12.2f\n");
+
+        std::cout << summary_fmt
+            % "Total prefetches:"
+            % prefetches
+            % "Useful prefetches:"
+            % useful
+            % "Wasted prefetches:"
+            % wasted
+            % "Prefetch accuracy:"
+            % accuracy(useful, prefetches);
+    }
+
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%lu,"
+            "%lu,"
+            "%lu,"
+            "%.2f\n");
+
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->prefetches
+                % entry.second->useful_prefetches
+                % entry.second->wasted_prefetches
+                % accuracy(entry.second->useful_prefetches, entry.second->prefetches);
+        }
+
+        boost::format summary_fmt(
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%.2f,,,,\n");
+
+        std::cout << summary_fmt
+            % prefetches
+            % useful
+            % wasted
+            % accuracy(useful, prefetches);
+    }
+}
+
+void Simulation::print_dedup_summary() {
+    size_t merged = 0;
+    size_t cow_breaks = 0;
+    for (auto entry : this->processes) {
+        merged += entry.second->merged_faults;
+        cow_breaks += entry.second->cow_breaks;
+    }
+
+    double accesses = std::max<size_t>(this->memory_accesses, 1);
+    double fault_rate = 100.0 * this->page_faults / accesses;
+    double baseline_rate = 100.0 * this->baseline_page_faults / accesses;
+
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "MERGED: %-6lu "
+            "COW BREAKS: %-6lu\n");
+
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->merged_faults
+                % entry.second->cow_breaks;
+        }
+
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12.2f\n"
+            "%-25s %12.2f\n");
+
+        std::cout << summary_fmt
+            % "Merged faults:"
+            % merged
+            % "Copy-on-write breaks:"
+            % cow_breaks
+            % "Frames saved (end):"
+            % this->frames_saved
+            % "Frames saved (peak):"
+            % this->peak_frames_saved
+            % "Faults without merging:"
+            % this->baseline_page_faults
+            % "Fault rate w/o merging:"
+            % baseline_rate
+            % "Fault rate change:"
+            % (fault_rate - baseline_rate);
+    }
+
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%lu,"
+            "%lu\n");
+
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % entry.second->merged_faults
+                % entry.second->cow_breaks;
+        }
+
+        boost::format summary_fmt(
+            "%lu,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%.2f,,\n"
+            "%.2f,,\n");
+
+        std::cout << summary_fmt
+            % merged
+            % cow_breaks
+            % this->frames_saved
+            % this->peak_frames_saved
+            % this->baseline_page_faults
+            % baseline_rate
+            % (fault_rate - baseline_rate);
+    }
+}
 
-        // no page seg fault...
-        // check for page fault - is the page in the table
-        if (temp_process->page_table.rows[virtual_address.page].present) { // is this right?
-            // page is present...
-            if (this->flags.verbose) {
-                std::cout << "\t-> IN MEMORY" << std::endl;
-            }
+void Simulation::print_huge_page_summary() {
+    size_t huge_size = this->get_huge_page_size();
+    size_t huge_faults = 0;
+    size_t promotions = 0;
+    size_t demotions = 0;
+    size_t fallbacks = 0;
 
-            // increment memory accesses counter
-            temp_process->memory_accesses++;
+    // count the mappings left in memory, and the bytes of their frames that
+    // hold nothing of the process image (or, in a huge page, nothing used)
+    size_t base_pages = 0;
+    size_t huge_pages = 0;
+    size_t base_fragmentation = 0;
+    size_t huge_fragmentation = 0;
+    for (auto entry : this->processes) {
+        Process* process = entry.second;
+        huge_faults += process->huge_faults;
+        promotions += process->promotions;
+        demotions += process->demotions;
+        fallbacks += process->huge_fallbacks;
 
-            // convert virtual address to a physical address
-            int frame = temp_process->page_table.rows[virtual_address.page].frame;
-            int offset = virtual_address.offset;
-            PhysicalAddress physical_address = PhysicalAddress(frame, offset);
-            if (this->flags.verbose) {
-                std::cout << "\t-> physical address " << physical_address << std::endl;
+        for (size_t page = 0; page < process->pages.size(); page++) {
+            const PageTable::Row& row = process->page_table.rows[page];
+            if (!row.present) {
+                continue;
             }
-
-            // check if offset is valid
-            if (temp_process->pages.at(virtual_address.page)->is_valid_offset(offset)) {
-                // set the access time and return the byte at the offset
-                temp_process->page_table.rows[virtual_address.page].last_accessed_at = this->time;
-                return temp_process->pages.at(virtual_address.page)->get_byte_at_offset(offset);
+            size_t unused = row.untouched ? Page::PAGE_SIZE : Page::PAGE_SIZE - process->pages[page].size();
+            if (row.huge) {
+                huge_pages += page % huge_size == 0;
+                huge_fragmentation += unused;
             } else {
-                // return seg fault - invalid offset
-                std::cout << "SEGFAULT - INVALID OFFSET" << std::endl;
-                exit(-1);
-            }
-            
-        } else {
-            // page is not present...
-            if (this->flags.verbose) {
-                std::cout << "\t-> PAGE FAULT" << std::endl;
+                base_pages++;
+                base_fragmentation += unused;
             }
+        }
+    }
 
-            // increment memory accesses counter and page faults counter
-            temp_process->memory_accesses++;
-            temp_process->page_faults++;
-            this->page_faults++;
-            
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "BASE FAULTS: %-6lu "
+            "HUGE FAULTS: %-6lu "
+            "PROMOTIONS: %-6lu "
+            "DEMOTIONS: %-6lu\n");
 
-            // handle the page fault
-            handle_page_fault(temp_process, virtual_address.page);
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % (entry.second->page_faults - entry.second->huge_faults)
+                % entry.second->huge_faults
+                % entry.second->promotions
+                % entry.second->demotions;
+        }
 
-            // convert virtual address to a physical address
-            int frame = temp_process->page_table.rows[virtual_address.page].frame;
-            int offset = virtual_address.offset;
-            PhysicalAddress physical_address = PhysicalAddress(frame, offset);
-            if (this->flags.verbose) {
-                std::cout << "\t-> physical address " << physical_address << std::endl;
-            }
+        boost::format summary_fmt(
+            "\n%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n");
 
-            // check if offset is valid
-            if (temp_process->pages.at(virtual_address.page)->is_valid_offset(offset)) {
-                // set the access time and return the byte at the offset
-                temp_process->page_table.rows[virtual_address.page].last_accessed_at = this->time;
-                return temp_process->pages.at(virtual_address.page)->get_byte_at_offset(offset);
-            } else {
-                // return seg fault - invalid offset
-                std::cout << "SEGFAULT - INVALID OFFSET" << std::endl;
-                exit(-1);
-            }
+        std::cout << summary_fmt
+            % "Base page faults:"
+            % (this->page_faults - huge_faults)
+            % "Huge page faults:"
+            % huge_faults
+            % "Promotions:"
+            % promotions
+            % "Demotions:"
+            % demotions
+            % "Huge fault fallbacks:"
+            % fallbacks
+            % "Base pages mapped:"
+            % base_pages
+            % "Huge pages mapped:"
+            % huge_pages
+            % "Base fragmentation (B):"
+            % base_fragmentation
+            % "Huge fragmentation (B):"
+            % huge_fragmentation;
 
+        if (this->tlb) {
+            std::cout << boost::format(
+                    "%-25s %12lu\n"
+                    "%-25s %12lu\n"
+                    "%-25s %12lu\n"
+                    "%-25s %12lu\n")
+                % "TLB hits (base pages):"
+                % (this->tlb->hits - this->tlb->huge_hits)
+                % "TLB hits (huge pages):"
+                % this->tlb->huge_hits
+                % "TLB reach, base (B):"
+                % (this->tlb->get_entry_count(false) * Page::PAGE_SIZE)
+                % "TLB reach, huge (B):"
+                % (this->tlb->get_entry_count(true) * huge_size * Page::PAGE_SIZE);
         }
-        
-
-    } else {
-        // return page seg fault
-        std::cout << "SEGFAULT - INVALID PAGE" << std::endl;
-        exit(-1);
     }
-}
 
-void Simulation::handle_page_fault(Process* process, size_t page) {
-    // compare the page count in the page table to the max frames
-    if (process->page_table.get_present_page_count() < flags.max_frames) {
-        // find the first free frame available and update all of the page's data accordingly
-        size_t frame_to_use = this->free_frames.front();
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%lu,"
+            "%lu,"
+            "%lu,"
+            "%lu\n");
+
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % (entry.second->page_faults - entry.second->huge_faults)
+                % entry.second->huge_faults
+                % entry.second->promotions
+                % entry.second->demotions;
+        }
+
+        boost::format summary_fmt(
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n"
+            "%lu,,,,\n");
 
-        // set up the things - frame of the page, present, times
-        process->page_table.rows[page].frame = frame_to_use;
-        process->page_table.rows[page].present = true;
-        process->page_table.rows[page].last_accessed_at = this->time;
-        process->page_table.rows[page].loaded_at = this->time;
+        std::cout << summary_fmt
+            % (this->page_faults - huge_faults)
+            % huge_faults
+            % promotions
+            % demotions
+            % fallbacks
+            % base_pages
+            % huge_pages
+            % base_fragmentation
+            % huge_fragmentation;
 
-        // set_page() for the given frame
-        this->frames[frame_to_use].set_page(process, page);
+        if (this->tlb) {
+            std::cout << boost::format("%lu,,,,\n%lu,,,,\n%lu,,,,\n%lu,,,,\n")
+                % (this->tlb->hits - this->tlb->huge_hits)
+                % this->tlb->huge_hits
+                % (this->tlb->get_entry_count(false) * Page::PAGE_SIZE)
+                % (this->tlb->get_entry_count(true) * huge_size * Page::PAGE_SIZE);
+        }
+    }
+}
 
-        // pop the free frame used from the front of the list
-        this->free_frames.pop_front();
-    } else {
-        // check flags for FIFO or LRU
-        size_t page_to_change = process->page_table.get_oldest_page();
-        if (flags.strategy == ReplacementStrategy::FIFO) {
-            // get the oldest page
-            page_to_change = process->page_table.get_oldest_page();
+void Simulation::print_swap_summary() {
+    auto percent = [this](double time) {
+        return this->makespan == 0.0 ? 0.0 : 100.0 * time / this->makespan;
+    };
+    double reads = this->swap_device->reads;
+    double read_wait = reads == 0 ? 0.0 : this->swap_device->get_read_wait() / reads;
 
-            // reset the old page information using the new page's information
-            //process->page_table.rows[page] = process->page_table.rows[page];  // could be wrong?
-            process->page_table.rows[page_to_change].present = false;
-            frames[process->page_table.rows[page_to_change].frame].contents = process->pages[page];
+    if (!this->flags.csv) {
+        boost::format process_fmt(
+            "Process %3d:  "
+            "FINISHED (ms): %-10.2f "
+            "BLOCKED (ms): %-10.2f\n");
 
-            // set present, times, and frame
-            process->page_table.rows[page].present = true;
-            process->page_table.rows[page].last_accessed_at = this->time;
-            process->page_table.rows[page].loaded_at = this->time;
-            process->page_table.rows[page].frame = process->page_table.rows[page_to_change].frame;
+        std::cout << "\n";
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % (entry.second->ready_at / 1e6)
+                % (entry.second->blocked_time / 1e6);
+        }
 
-        } else if (flags.strategy == ReplacementStrategy::LRU) {
-            // get the least recently used page
-            page_to_change = process->page_table.get_least_recently_used_page();
+        boost::format summary_fmt(
+            "\n%-25s %12.2f\n"
+            "%-25s %12.2f\n"
+            "%-25s %12.2f\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12.2f\n"
+            "%-25s %12.2f\n");
 
-            // reset the old page information using the new page's information
-            // process->page_table.rows[page] = process->page_table.rows[page_to_change];   // fun fact, it was wrong oops
-            process->page_table.rows[page_to_change].present = false;
-            frames[process->page_table.rows[page_to_change].frame].contents = process->pages[page];
+        std::cout << summary_fmt
+            % "Makespan (ms):"
+            % (this->makespan / 1e6)
+            % "CPU utilization:"
+            % percent(this->cpu_busy_time)
+            % "Device utilization:"
+            % percent(this->swap_device->get_busy_time())
+            % "Device reads:"
+            % this->swap_device->reads
+            % "Device writes:"
+            % this->swap_device->writes
+            % "Mean page-in wait (ms):"
+            % (read_wait / 1e6)
+            % "Accesses per second:"
+            % (this->makespan == 0.0 ? 0.0 : this->memory_accesses / (this->makespan / 1e9));
+    }
 
-            // set present, times, and frame
-            process->page_table.rows[page].present = true;
-            process->page_table.rows[page].last_accessed_at = this->time;
-            process->page_table.rows[page].loaded_at = this->time;
-            process->page_table.rows[page].frame = process->page_table.rows[page_to_change].frame;
+    if (this->flags.csv) {
+        boost::format process_fmt(
+            "%d,"
+            "%.2f,"
+            "%.2f\n");
 
+        for (auto entry : this->processes) {
+            std::cout << process_fmt
+                % entry.first
+                % (entry.second->ready_at / 1e6)
+                % (entry.second->blocked_time / 1e6);
         }
-    }
 
-    // return when done
-    return;
+        boost::format summary_fmt(
+            "%.2f,,\n"
+            "%.2f,,\n"
+            "%.2f,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%.2f,,\n"
+            "%.2f,,\n");
+
+        std::cout << summary_fmt
+            % (this->makespan / 1e6)
+            % percent(this->cpu_busy_time)
+            % percent(this->swap_device->get_busy_time())
+            % this->swap_device->reads
+            % this->swap_device->writes
+            % (read_wait / 1e6)
+            % (this->makespan == 0.0 ? 0.0 : this->memory_accesses / (this->makespan / 1e9));
+    }
 }
 
-void Simulation::print_summary() {
+void Simulation::print_zswap_summary() {
+    const CompressedPool& pool = *this->compressed_pool;
+    auto percent = [](size_t part, size_t whole) {
+        return whole == 0 ? 0.0 : 100.0 * part / whole;
+    };
+
     if (!this->flags.csv) {
         boost::format process_fmt(
             "Process %3d:  "
-            "ACCESSES: %-6lu "
-            "FAULTS: %-6lu "
-            "FAULT RATE: %-8.2f "
-            "RSS: %-6lu\n");
+            "POOL HITS: %-6lu "
+            "FAULTS SERVED: %-6.2f\n");
 
+        std::cout << "\n";
         for (auto entry : this->processes) {
             std::cout << process_fmt
                 % entry.first
-                % entry.second->memory_accesses
-                % entry.second->page_faults
-                % entry.second->get_fault_percent()
-                % entry.second->get_rss();
+                % entry.second->pool_hits
+                % percent(entry.second->pool_hits, entry.second->page_faults);
         }
 
-        // Print statistics.
         boost::format summary_fmt(
             "\n%-25s %12lu\n"
             "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
+            "%-25s %12.2f\n"
+            "%-25s %12.2f\n"
+            "%-25s %12lu\n"
+            "%-25s %12lu\n"
             "%-25s %12lu\n");
 
         std::cout << summary_fmt
-            % "Total memory accesses:"
-            % this->virtual_addresses.size()
-            % "Total page faults:"
-            % this->page_faults
-            % "Free frames remaining:"
-            % this->free_frames.size();
+            % "Pages stored:"
+            % pool.stores
+            % "Pages rejected:"
+            % pool.rejects
+            % "Pool hits:"
+            % pool.hits
+            % "Pool misses:"
+            % pool.misses
+            % "Pool hit rate:"
+            % percent(pool.hits, pool.hits + pool.misses)
+            % "Compression ratio:"
+            % pool.get_compression_ratio()
+            % "Pool memory (bytes):"
+            % pool.get_used()
+            % "Pool memory (peak):"
+            % pool.get_peak_used()
+            % "Pages pushed out:"
+            % pool.evictions;
     }
 
     if (this->flags.csv) {
         boost::format process_fmt(
             "%d,"
             "%lu,"
-            "%lu,"
-            "%.2f,"
-            "%lu\n");
+            "%.2f\n");
 
-        for (auto entry : processes) {
+        for (auto entry : this->processes) {
             std::cout << process_fmt
                 % entry.first
-                % entry.second->memory_accesses
-                % entry.second->page_faults
-                % entry.second->get_fault_percent()
-                % entry.second->get_rss();
+                % entry.second->pool_hits
+                % percent(entry.second->pool_hits, entry.second->page_faults);
         }
 
-        // Print statistics.
         boost::format summary_fmt(
-            "%lu,,,,\n"
-            "%lu,,,,\n"
-            "%lu,,,,\n");
+            "%lu,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%.2f,,\n"
+            "%.2f,,\n"
+            "%lu,,\n"
+            "%lu,,\n"
+            "%lu,,\n");
 
         std::cout << summary_fmt
-            % this->virtual_addresses.size()
-            % this->page_faults
-            % this->free_frames.size();
+            % pool.stores
+            % pool.rejects
+            % pool.hits
+            % pool.misses
+            % percent(pool.hits, pool.hits + pool.misses)
+            % pool.get_compression_ratio()
+            % pool.get_used()
+            % pool.get_peak_used()
+            % pool.evictions;
+    }
+}
+
+bool Simulation::supports_prefetch() const {
+    return flags.strategy != ReplacementStrategy::OPT
+        && this->get_adaptive_policy() == PageTable::AdaptivePolicy::NONE;
+}
+
+double Simulation::get_io_cost(size_t page_ins, size_t writebacks, size_t pool_loads) const {
+    return (page_ins * this->flags.page_in_latency + writebacks * this->flags.writeback_latency
+        + pool_loads * this->flags.zswap_latency) / 1e6;
+}
+
+size_t Simulation::get_memory_writes() const {
+    size_t writes = 0;
+    for (auto entry : this->processes) {
+        writes += entry.second->memory_writes;
+    }
+    return writes;
+}
+
+int Simulation::run_mrc() {
+    // sampling only applies if asked for, and error estimates only with sampling
+    bool sampled = this->flags.sample_rate < 1.0 || this->flags.mrc_max_keys > 0;
+    bool with_error = sampled && this->flags.mrc_error;
+
+    // the curve runs up to the size of memory
+    size_t num_frames = this->flags.num_frames;
+
+    // one analyzer per process for local replacement, plus one for everything
+    std::map<int, StackDistance> local, local_exact;
+    for (auto entry : this->processes) {
+        local.emplace(entry.first, StackDistance(num_frames, flags.sample_rate, flags.mrc_max_keys));
+        if (with_error) {
+            local_exact.emplace(entry.first, StackDistance(num_frames));
+        }
+    }
+    StackDistance global(num_frames, flags.sample_rate, flags.mrc_max_keys);
+    StackDistance global_exact(with_error ? num_frames : 0);
+
+    std::vector<VirtualAddress> chunk;
+    while (this->next_addresses(chunk)) {
+        for (const VirtualAddress& address : chunk) {
+            Process* process = this->processes[address.process_id];
+            if (!process->is_valid_page(address.page)) {
+                std::cout << "SEGFAULT - INVALID PAGE" << std::endl;
+                exit(-1);
+            }
+
+            // key every page by (pid, page), so sampling picks the same pages
+            // in the per-process and global analyses
+            uint64_t key = ((uint64_t) (uint32_t) address.process_id << 32) | address.page;
+            local.at(address.process_id).access(key);
+            global.access(key);
+
+            if (with_error) {
+                local_exact.at(address.process_id).access(key);
+                global_exact.access(key);
+            }
+        }
+    }
+
+    if (this->read_error) {
+        return 1;
+    }
+
+    // the miss ratio errors of one column of the curve
+    auto mean_error = [num_frames](const StackDistance& approx, const StackDistance& exact) {
+        double total = 0.0;
+        for (size_t frames = 1; frames <= num_frames; frames++) {
+            total += std::abs(approx.get_miss_ratio(frames) - exact.get_miss_ratio(frames));
+        }
+        return total / num_frames;
+    };
+    auto max_error = [num_frames](const StackDistance& approx, const StackDistance& exact) {
+        double worst = 0.0;
+        for (size_t frames = 1; frames <= num_frames; frames++) {
+            worst = std::max(worst, std::abs(approx.get_miss_ratio(frames) - exact.get_miss_ratio(frames)));
+        }
+        return worst;
+    };
+
+    if (!this->flags.csv) {
+        std::cout << boost::format("%-8s") % "Frames";
+        for (auto& entry : local) {
+            std::cout << boost::format("PID %-6d ") % entry.first;
+        }
+        std::cout << boost::format("%-10s\n") % "GLOBAL";
+
+        for (size_t frames = 1; frames <= num_frames; frames++) {
+            std::cout << boost::format("%-8lu") % frames;
+            for (auto& entry : local) {
+                std::cout << boost::format("%-10lu ") % entry.second.get_fault_count(frames);
+            }
+            std::cout << boost::format("%-10lu\n") % global.get_fault_count(frames);
+        }
+
+        if (sampled) {
+            std::cout << boost::format("\n%-25s %12.6f\n%-25s %12lu\n")
+                % "Final sample rate:"
+                % global.get_sample_rate()
+                % "Pages tracked:"
+                % global.get_distinct_count();
+        }
+
+        if (with_error) {
+            std::cout << boost::format("%-25s %12lu\n\n") % "Pages tracked (exact):" % global_exact.get_distinct_count();
+
+            std::cout << boost::format("%-8s") % "MEANERR";
+            for (auto& entry : local) {
+                std::cout << boost::format("%-10.4f ") % mean_error(entry.second, local_exact.at(entry.first));
+            }
+            std::cout << boost::format("%-10.4f\n") % mean_error(global, global_exact);
+
+            std::cout << boost::format("%-8s") % "MAXERR";
+            for (auto& entry : local) {
+                std::cout << boost::format("%-10.4f ") % max_error(entry.second, local_exact.at(entry.first));
+            }
+            std::cout << boost::format("%-10.4f\n") % max_error(global, global_exact);
+        }
+    }
+
+    if (this->flags.csv) {
+        std::cout << "frames";
+        for (auto& entry : local) {
+            std::cout << "," << entry.first;
+        }
+        std::cout << ",global\n";
+
+        for (size_t frames = 1; frames <= num_frames; frames++) {
+            std::cout << frames;
+            for (auto& entry : local) {
+                std::cout << "," << entry.second.get_fault_count(frames);
+            }
+            std::cout << "," << global.get_fault_count(frames) << "\n";
+        }
+
+        if (with_error) {
+            std::cout << "mean_error";
+            for (auto& entry : local) {
+                std::cout << "," << mean_error(entry.second, local_exact.at(entry.first));
+            }
+            std::cout << "," << mean_error(global, global_exact) << "\n";
+
+            std::cout << "max_error";
+            for (auto& entry : local) {
+                std::cout << "," << max_error(entry.second, local_exact.at(entry.first));
+            }
+            std::cout << "," << max_error(global, global_exact) << "\n";
+        }
     }
+
+    return 0;
 }
 
 int Simulation::read_processes(std::istream& simulation_file) {
@@ -266,56 +2451,115 @@ int Simulation::read_processes(std::istream& simulation_file) {
 
         simulation_file >> pid >> process_image_path;
 
+        int error = this->read_process(pid, process_image_path);
+        if (error) {
+            return error;
+        }
+    }
+    return 0;
+}
+
+int Simulation::read_process(int pid, const std::string& process_image_path) {
+    // map the image instead of copying it, unless it cannot be mapped (a pipe,
+    // for instance)
+    Process* process = Process::read_from_file(process_image_path);
+
+    if (process == nullptr) {
         std::ifstream proc_img_file(process_image_path);
+        if (proc_img_file) {
+            process = Process::read_from_input(proc_img_file);
+        }
+    }
 
-        if (!proc_img_file) {
-            std::cerr << "Unable to read file for PID " << pid << ": " << process_image_path << std::endl;
-            return 1;
+    if (process == nullptr) {
+        std::cerr << "Unable to read file for PID " << pid << ": " << process_image_path << std::endl;
+        return 1;
+    }
+    process->asid = this->processes.size();
+    this->processes[pid] = process;
+    return 0;
+}
+
+int Simulation::read_binary_simulation_file(std::shared_ptr<MappedFile> trace) {
+    BinaryTraceHeader header;
+    size_t records_offset;
+
+    try {
+        records_offset = header.read(trace->data(), trace->size());
+    } catch (const std::exception& except) {
+        std::cerr << "Error reading binary trace header." << std::endl;
+        std::cerr << except.what() << std::endl;
+        return 1;
+    }
+
+    for (auto& process : header.processes) {
+        int error = this->read_process(process.first, process.second);
+        if (error) {
+            return error;
         }
-        this->processes[pid] = Process::read_from_input(proc_img_file);
     }
+
+    // decode the records straight out of the mapping in the background
+    this->address_stream.reset(new AddressStream(
+        std::unique_ptr<AddressSource>(new BinaryAddressSource(trace, records_offset, header.version))));
     return 0;
 }
 
 int Simulation::read_addresses(std::istream& simulation_file) {
-    int pid;
-    std::string virtual_address;
+    // start parsing the rest of the file in the background
+    this->address_stream.reset(new AddressStream(
+        std::unique_ptr<AddressSource>(new TextAddressSource(simulation_file))));
+    return 0;
+}
 
+bool Simulation::next_addresses(std::vector<VirtualAddress>& chunk) {
     try {
-        while (simulation_file >> pid >> virtual_address) {
-            this->virtual_addresses.push_back(VirtualAddress::from_string(pid, virtual_address));
+        if (!this->address_stream->next_chunk(chunk)) {
+            return false;
         }
     } catch (const std::exception& except) {
         std::cerr << "Error reading virtual addresses." << std::endl;
         std::cerr << except.what() << std::endl;
-        return 1;
+        this->read_error = true;
+        return false;
     } catch (...) {
         std::cerr << "Error reading virtual addresses." << std::endl;
-        return 1;
+        this->read_error = true;
+        return false;
     }
-    return 0;
-}
 
-int Simulation::read_simulation_file() {
-    std::ifstream simulation_file(this->flags.filename);
-    // this->simulation_file.open(this->flags.filename);
+    this->memory_accesses += chunk.size();
 
-    if (!simulation_file) {
-        std::cerr << "Unable to open file: " << this->flags.filename << std::endl;
-        return -1;
+    if (this->flags.file_verbose) {
+        for (auto entry : chunk) {
+            std::cout << entry << std::endl;
+        }
     }
+    return true;
+}
+
+int Simulation::read_simulation_file() {
     int error = 0;
-    error = this->read_processes(simulation_file);
+    std::shared_ptr<MappedFile> trace = MappedFile::open(this->flags.filename);
 
-    if (error) {
-        std::cerr << "Error reading processes. Exit: " << error << std::endl;
-        return error;
-    }
+    if (trace && BinaryTraceHeader::has_magic(trace->data(), trace->size())) {
+        error = this->read_binary_simulation_file(trace);
+    } else {
+        this->simulation_file.open(this->flags.filename);
 
-    error = this->read_addresses(simulation_file);
+        if (!this->simulation_file) {
+            std::cerr << "Unable to open file: " << this->flags.filename << std::endl;
+            return -1;
+        }
+        error = this->read_processes(this->simulation_file);
+
+        if (!error) {
+            error = this->read_addresses(this->simulation_file);
+        }
+    }
 
     if (error) {
-        std::cerr << "Error reading addresses." << std::endl;
+        std::cerr << "Error reading processes. Exit: " << error << std::endl;
         return error;
     }
 
@@ -323,10 +2567,6 @@ int Simulation::read_simulation_file() {
         for (auto entry: this->processes) {
             std::cout << "Process " << entry.first << ": Size: " << entry.second->size() << std::endl;
         }
-
-        for (auto entry : this->virtual_addresses) {
-            std::cout << entry << std::endl;
-        }
     }
 
     return 0;
@@ -10,11 +10,25 @@
 #include "virtual_address/virtual_address.h"
 #include "flag_parser/flag_parser.h"
 #include "frame/frame.h"
+#include "frame_allocator/frame_allocator.h"
+#include "frame_budget/frame_budget.h"
 #include "physical_address/physical_address.h"
+#include "stack_distance/stack_distance.h"
+#include "address_stream/address_stream.h"
+#include "binary_trace/binary_trace.h"
+#include "mapped_file/mapped_file.h"
+#include "chunk_queue/chunk_queue.h"
+#include "swap_device/swap_device.h"
+#include "buffered_writer/buffered_writer.h"
+#include "trace_sink/trace_sink.h"
+#include "compressed_pool/compressed_pool.h"
+#include "tlb/tlb.h"
+#include "cache/cache.h"
 
 
 #include <map>
-#include <list>
+#include <unordered_map>
+#include <memory>
 #include <fstream>
 #include <cstdlib>
 #include <iostream>
@@ -34,9 +48,85 @@ public:
     //===================================
 
     /**
-    * Runs the simulation.
+    * Runs the simulation (or the miss-ratio-curve analysis, if requested) and
+    * frees the processes afterwards. Returns nonzero if the trace could not be
+    * read.
     */
-    void run();
+    int run();
+
+    /**
+    * Simulates every memory access in the trace and prints the summary. OPT
+    * and --compare need the future of the trace, --dedup a second run without
+    * merging, and a swap device lets accesses run ahead of a blocked process,
+    * so for them the whole trace is read into memory first.
+    */
+    int simulate();
+
+    /**
+    * Closes the per-interval metrics and the trace sink and prints every
+    * summary that applies to the run. Returns 1, printing nothing, if reading
+    * the trace failed partway.
+    */
+    int finish_simulation();
+
+    /**
+    * Simulates a single memory access, printing it if verbose, and advances
+    * the clock.
+    */
+    void simulate_access(const VirtualAddress& address);
+
+    /**
+    * Simulates the trace (the buffered one, if given) with the processes
+    * sharded across worker threads. Each process gets its own block of frames,
+    * and the position of each access in the trace serves as the time, so the
+    * results are the same as a serial run's.
+    */
+    int simulate_parallel(const std::vector<VirtualAddress>* trace);
+
+    /**
+    * The body of a worker thread, simulating the accesses on the given queue.
+    */
+    void run_shard(ChunkQueue* queue);
+
+    /**
+    * Simulates a single memory access on a worker thread, at the given
+    * position in the trace. Only touches state belonging to the process.
+    */
+    void simulate_shard_access(const VirtualAddress& address, size_t position);
+
+    /**
+    * Simulates the buffered trace against the swap device, on a single CPU.
+    * Each access takes the memory latency, and a fault blocks its process
+    * until its page has been read in, while the CPU moves on to the other
+    * processes' accesses, in trace order. Writebacks and prefetches go to the
+    * device too, without blocking anyone.
+    */
+    void simulate_with_swap(const std::vector<VirtualAddress>& trace);
+
+    /**
+    * Runs every replacement strategy over the buffered trace and prints the
+    * number of faults each one takes.
+    */
+    void compare_strategies(const std::vector<VirtualAddress>& trace);
+
+    /**
+    * Empties memory and clears every statistic, so the trace can be simulated
+    * again from the start.
+    */
+    void reset();
+
+    /**
+    * Reads the rest of the trace into memory. Returns nonzero if reading it
+    * failed.
+    */
+    int read_trace(std::vector<VirtualAddress>& trace);
+
+    /**
+    * Returns, for every access in the trace, the index of the next access to
+    * the same page of the same process, or PageTable::NONE if there is none.
+    * Computed in a single backward sweep.
+    */
+    static std::vector<size_t> compute_next_uses(const std::vector<VirtualAddress>& trace);
 
     /**
     * The constructor.
@@ -52,9 +142,247 @@ public:
 
     /**
     * Handles a page fault, attempting to load the given page for the given
-    * process into memory.
+    * process into memory. Returns true if, with --dedup, the page could share
+    * a frame already holding the same contents, so nothing had to be read in.
+    */
+    bool handle_page_fault(Process* process, size_t page);
+
+    /**
+    * If a frame holds the same contents as the given page, which must never
+    * have been written, maps the page to that frame too and returns true.
+    */
+    bool map_shared_frame(Process* process, size_t page);
+
+    /**
+    * Records the contents of the given page, just loaded into the given frame,
+    * so identical pages can share the frame. Written pages are left out.
+    */
+    void index_contents(Process* process, size_t page, size_t frame);
+
+    /**
+    * Stops offering the given frame to pages with the same contents.
+    */
+    void forget_contents(size_t frame);
+
+    /**
+    * Called on a write to the given (present) page with --dedup. The page's
+    * contents stop matching its image, and if it shares a frame it gets a
+    * private copy (copy on write).
+    */
+    void break_sharing(Process* process, size_t page);
+
+    /**
+    * Returns the number of pages in a huge page (1 without huge pages).
+    */
+    size_t get_huge_page_size() const;
+
+    /**
+    * If the run of pages around the given page was a huge page before, and
+    * none of it is in memory, brings the whole run back in as a huge page and
+    * returns true. Makes room for it within the process's budget first. If no
+    * contiguous frames can be found, the run goes back to base pages.
+    */
+    bool fault_huge_page(Process* process, size_t page);
+
+    /**
+    * If every page of the run around the given page is in memory as base
+    * pages, and contiguous frames can be found for them, moves the pages into
+    * those frames and maps them as a huge page.
+    */
+    void promote(Process* process, size_t page);
+
+    /**
+    * Maps the pages of the huge page holding the given page as base pages
+    * again, leaving them in the same frames.
+    */
+    void split_huge_page(Process* process, size_t page);
+
+    /**
+    * Loads the given pages of the process ahead of time, skipping any that are
+    * invalid or already present, and stopping short of filling its frame
+    * budget so that the page about to be faulted in stays in memory. While a
+    * page is in use (after a hit), only free frames within the budget are
+    * filled, since evicting anything could evict that very page.
+    */
+    void prefetch_pages(Process* process, const std::vector<size_t>& pages, bool evict = true);
+
+    /**
+    * Runs the given physical address, accessed by the given process, through
+    * the CPU caches.
+    */
+    void access_caches(Process* process, const PhysicalAddress& address);
+
+    /**
+    * Takes the given page out of the compressed pool, if it is there,
+    * setting dirty to whether it was evicted dirty, and returns true if so.
+    */
+    bool load_from_pool(Process* process, size_t page, bool& dirty);
+
+    /**
+    * Puts the given page, which is being evicted, into the compressed pool,
+    * and returns false if it would not compress. Dirty pages pushed out of
+    * the pool to make room are written back.
+    */
+    bool store_in_pool(Process* process, size_t page);
+
+    /**
+    * Picks the page to replace to make room for the given page, according to
+    * the replacement strategy, among the pages in the given table. That is
+    * either the faulting process's page table, or the frame table.
+    */
+    size_t select_victim(PageTable& page_table, size_t page);
+
+    /**
+    * Evicts a page from the given frame, through the frame's reverse mapping.
+    * Every page sharing the frame is unmapped. A page of a huge page takes the
+    * rest of it along, freeing their frames, unless there are no free frames
+    * left; then the huge page is demoted and only the one page goes.
+    */
+    void evict_frame(size_t frame);
+
+    /**
+    * Evicts the page in the given frame and returns the frame to the free list.
+    */
+    void release_frame(size_t frame);
+
+    /**
+    * Returns the number of frames the given process may currently hold.
+    */
+    size_t get_frame_budget(Process* process) const;
+
+    /**
+    * Releases the frames of every page that has dropped out of its process's
+    * working set, oldest first, stopping at the first page still in it.
+    */
+    void trim_working_sets();
+
+    /**
+    * At the end of each window of the given process's accesses, grows or
+    * shrinks its frame budget if its fault rate over the window crossed the
+    * thresholds, releasing frames it can no longer hold.
+    */
+    void adjust_frame_budget(Process* process);
+
+    /**
+    * Prints how many frames each process held at the end of each window of
+    * the trace.
+    */
+    void print_allocation_history();
+
+    /**
+    * Sets up the trace sink the events of each access go to: the event log,
+    * if there is one, or standard output with -v. Returns 1 if the event log
+    * could not be opened.
+    */
+    int open_trace_sink();
+
+    /**
+    * Opens the destination of the per-interval metrics and writes their
+    * header, returning 1 if the file could not be opened.
+    */
+    int open_intervals();
+
+    /**
+    * Writes each process's metrics for the window of accesses ending at the
+    * given time, and starts the next window.
+    */
+    void write_interval(size_t end);
+
+    /**
+    * Writes the window the trace ended in, if it is not empty, and flushes
+    * the per-interval metrics.
+    */
+    void close_intervals();
+
+    /**
+    * Prints the TLB hit rate of each process, and the effective access time
+    * it leads to.
+    */
+    void print_tlb_summary();
+
+    /**
+    * Prints each process's hit rate in every level of the CPU cache, and the
+    * average memory access time they lead to.
+    */
+    void print_cache_summary();
+
+    /**
+    * Returns the average time a memory access takes (page faults aside) at
+    * the given TLB hit rate: a TLB lookup and the access itself, plus a page
+    * table reference on a miss.
+    */
+    double get_effective_access_time(double hit_rate) const;
+
+    /**
+    * Prints how many writes each process made and how many of its dirty pages
+    * had to be written back, and the I/O time its faults and writebacks cost.
+    */
+    void print_io_summary();
+
+    /**
+    * Prints how many pages were prefetched for each process, and how many of
+    * those were used or evicted unused.
+    */
+    void print_prefetch_summary();
+
+    /**
+    * Prints how many frames were allocated and freed, and how many
+    * allocations found no free frame.
+    */
+    void print_allocator_summary();
+
+    /**
+    * Prints how many faults same-page merging served from shared frames and
+    * how many frames it saved, against the fault rate of a run without it.
     */
-    void handle_page_fault(Process* process, size_t page);
+    void print_dedup_summary();
+
+    /**
+    * Prints the faults, mappings and internal fragmentation of huge pages and
+    * of base pages, and the TLB's hits and reach for each.
+    */
+    void print_huge_page_summary();
+
+    /**
+    * Prints when each process finished and how long it waited on the swap
+    * device, and the makespan and the utilization of the CPU and device.
+    */
+    void print_swap_summary();
+
+    /**
+    * Prints how many of each process's faults the compressed pool served,
+    * and how many pages it kept, how well they compressed and how much
+    * memory it took.
+    */
+    void print_zswap_summary();
+
+    /**
+    * Returns true if the replacement strategy works with prefetching.
+    */
+    bool supports_prefetch() const;
+
+    /**
+    * Returns the time, in milliseconds, that reading in the given number of
+    * pages, writing back the given number of dirty pages and decompressing
+    * the given number of pages from the compressed pool take.
+    */
+    double get_io_cost(size_t page_ins, size_t writebacks, size_t pool_loads = 0) const;
+
+    /**
+    * Returns the total number of writes in the trace so far.
+    */
+    size_t get_memory_writes() const;
+
+    /**
+    * Returns true if the replacement strategy sweeps a clock hand.
+    */
+    bool uses_clock_hand() const;
+
+    /**
+    * Returns the adaptive policy whose queues the page tables must maintain for
+    * the replacement strategy, if any.
+    */
+    PageTable::AdaptivePolicy get_adaptive_policy() const;
 
     /**
     * Prints information about the simulation.
@@ -62,21 +390,36 @@ public:
     void print_summary();
 
     /**
-    * Functions for reading in a simulation.
+    * Computes the LRU stack distance of every access in a single pass over the
+    * trace and prints, for every frame budget from 1 to --num-frames, the number
+    * of faults each process would take under local LRU replacement with that
+    * many frames, along with the faults a single global LRU pool of that many
+    * frames would take.
+    */
+    int run_mrc();
+
+    /**
+    * Replaces the contents of chunk with the next chunk of the trace, counting
+    * the accesses in it. Returns false at the end of the trace, or if reading
+    * it failed (in which case read_error is set).
+    */
+    bool next_addresses(std::vector<VirtualAddress>& chunk);
+
+    /**
+    * Functions for reading in a simulation. Binary traces are detected by
+    * their magic bytes and read through a memory mapping; anything else is
+    * read as text.
     */
     int read_simulation_file();
     int read_addresses(std::istream& simulation_file);
     int read_processes(std::istream& simulation_file);
+    int read_process(int pid, const std::string& process_image_path);
+    int read_binary_simulation_file(std::shared_ptr<MappedFile> trace);
     
     //===================================
     // Member Variables
     //===================================
 
-    /**
-    * The maximum number of frames in the simulated system (512).
-    */
-    static const size_t NUM_FRAMES = 1 << 9;
-
     /**
     * A map of processes included in this simulation, keyed by their PIDs.
     */
@@ -89,12 +432,26 @@ public:
     FlagOptions flags;
 
     /**
-    * The virtual memory addresses that represent the sequence of memory accesses
-    * to be simulated.
+    * The (text) simulation file, which the address stream keeps reading from
+    * after the processes have been read in.
     */
-    std::vector<VirtualAddress> virtual_addresses;
+    std::ifstream simulation_file;
 
-    // std::ifstream simulation_file;
+    /**
+    * The stream of virtual memory addresses that represent the sequence of
+    * memory accesses to be simulated, parsed while the simulation runs.
+    */
+    std::unique_ptr<AddressStream> address_stream;
+
+    /**
+    * The total number of memory accesses read from the trace so far.
+    */
+    size_t memory_accesses = 0;
+
+    /**
+    * True if reading the trace failed partway through.
+    */
+    bool read_error = false;
 
     /**
     * A vector of frames constituting the entirety of main memory.
@@ -107,9 +464,120 @@ public:
     size_t page_faults = 0;
 
     /**
-    * A list containing the indices of all frames that are not currently in use.
+    * The total number of writebacks and prefetches, and of the prefetches
+    * served from the compressed pool, across every process.
+    */
+    size_t writebacks = 0;
+    size_t prefetches = 0;
+    size_t pooled_prefetches = 0;
+
+    /**
+    * Hands out the frames that are not currently in use.
+    */
+    std::unique_ptr<FrameAllocator> frame_allocator;
+
+    /**
+    * A table with a row for each frame rather than for each page, whose
+    * replacement structures order every page in memory. Used for global
+    * replacement, and to find pages that left their working sets.
+    */
+    PageTable frame_table;
+
+    /**
+    * For dynamic allocation, the resident set size of every process (in PID
+    * order) at the end of each window of the trace.
+    */
+    std::vector<size_t> allocation_history;
+
+    /**
+    * Decides when the working-set and page-fault-frequency allocators take
+    * frames back, unless every process has a fixed number of frames.
+    */
+    std::unique_ptr<FrameBudget> budget;
+
+    /**
+    * With --interval, the file the metrics of each window go to (unless they
+    * go to standard output), the writer buffering them, and the number of
+    * windows written so far.
+    */
+    std::ofstream interval_file;
+    std::unique_ptr<BufferedWriter> interval_writer;
+    size_t intervals_written = 0;
+
+    /**
+    * Where the events of each access are reported, if anywhere, and the
+    * event log file it writes to.
+    */
+    std::unique_ptr<TraceSink> trace_sink;
+    std::ofstream event_log_file;
+
+    /**
+    * For parallel runs, the first of the block of frames given to each
+    * process, keyed by PID.
+    */
+    std::map<int, size_t> first_frames;
+
+    /**
+    * The TLB, if the simulation has one.
+    */
+    std::unique_ptr<Tlb> tlb;
+
+    /**
+    * The CPU caches in front of physical memory, if any.
+    */
+    std::unique_ptr<CacheHierarchy> caches;
+
+    /**
+    * The process that performed the previous access, and the number of times
+    * the trace switched from one process to another.
+    */
+    const Process* last_process = nullptr;
+    size_t context_switches = 0;
+
+    /**
+    * The pages a prefetcher suggested, reused from one access to the next.
+    */
+    std::vector<size_t> prefetch_candidates;
+
+    /**
+    * With --dedup, the frame holding each page contents that never-written
+    * pages may share, keyed by the hash of the contents.
+    */
+    std::unordered_map<uint64_t, size_t> content_frames;
+
+    /**
+    * The number of frames same-page merging saves right now, and at most.
+    */
+    size_t frames_saved = 0;
+    size_t peak_frames_saved = 0;
+
+    /**
+    * The number of page faults the trace took without same-page merging.
+    */
+    size_t baseline_page_faults = 0;
+
+    /**
+    * The swap device, when timing the trace against one.
+    */
+    std::unique_ptr<SwapDevice> swap_device;
+
+    /**
+    * With a swap device, when the last process finished, and how long the
+    * CPU spent performing accesses, in nanoseconds.
+    */
+    double makespan = 0.0;
+    double cpu_busy_time = 0.0;
+
+    /**
+    * The compressed pool evicted pages are kept in, if there is one.
+    */
+    std::unique_ptr<CompressedPool> compressed_pool;
+
+    /**
+    * For OPT, the index of the next access to the page touched by each access
+    * in the trace.
     */
-    std::list<size_t> free_frames;
+    std::vector<size_t> next_uses;
 
-    int time = 0;   // variable to hold the time
+    size_t time = 0;   // variable to hold the time
 };
@@ -0,0 +1,99 @@
+/**
+ * This file contains tests for the Simulation class, run over small traces.
+ */
+
+#include "simulation/simulation.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+
+bool parse_flags(initializer_list<string>, FlagOptions&);
+
+
+/**
+ * A trace of one process, written to temporary files, that the simulation
+ * reads like any other.
+ */
+class TraceFile {
+public:
+  TraceFile(size_t num_pages, const vector<VirtualAddress>& addresses) {
+    close(mkstemp(this->image));
+    {
+      ofstream out(this->image, ios::binary);
+      out << string(num_pages * Page::PAGE_SIZE, 'x');
+    }
+
+    close(mkstemp(this->trace));
+    ofstream out(this->trace);
+    out << "1\n1 " << this->image << "\n";
+    for (const VirtualAddress& address : addresses) {
+      out << "1 " << address.to_string() << (address.write ? " W\n" : "\n");
+    }
+  }
+
+  ~TraceFile() {
+    remove(this->image);
+    remove(this->trace);
+  }
+
+  char image[32] = "/tmp/simulation_imageXXXXXX";
+  char trace[32] = "/tmp/simulation_traceXXXXXX";
+};
+
+
+TEST(Simulation, PrefetchOnHitKeepsPageInUse) {
+  // a sequential scan through four frames, where each hit on a readahead page
+  // asks for more pages than there is room for
+  vector<VirtualAddress> addresses;
+  for (size_t page = 0; page < 64; page++) {
+    addresses.push_back(VirtualAddress(1, page, 0));
+  }
+  TraceFile file(64, addresses);
+
+  FlagOptions flags;
+  ASSERT_TRUE(parse_flags({file.trace, "-s", "FIFO", "--prefetch", "readahead", "-f", "4"}, flags));
+
+  Simulation simulation(flags);
+  ASSERT_EQ(0, simulation.read_simulation_file());
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(0, simulation.run());
+  testing::internal::GetCapturedStdout();
+
+  // every prefetched page is used before it could be evicted, so only the
+  // first page of each readahead faults
+  ASSERT_EQ(16, simulation.page_faults);
+  ASSERT_EQ(48, simulation.prefetches);
+}
+
+
+TEST(Simulation, PrefetchFromPoolKeepsDirtyPage) {
+  // with two frames, page 1 is written, pushed into the pool dirty, and then
+  // prefetched back when page 0 faults
+  TraceFile file(16, {
+    VirtualAddress(1, 1, 0, true),
+    VirtualAddress(1, 5, 0),
+    VirtualAddress(1, 0, 0),
+  });
+
+  FlagOptions flags;
+  ASSERT_TRUE(parse_flags({file.trace, "-s", "FIFO", "-f", "2", "--prefetch", "next-n",
+      "--prefetch-depth", "1", "--zswap", "4"}, flags));
+
+  Simulation simulation(flags);
+  ASSERT_EQ(0, simulation.read_simulation_file());
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(0, simulation.simulate());
+  testing::internal::GetCapturedStdout();
+
+  // the page comes back from the pool rather than the disk, still dirty
+  Process* process = simulation.processes[1];
+  ASSERT_EQ(1, process->pooled_prefetches);
+  ASSERT_TRUE(process->page_table.rows[1].present);
+  ASSERT_TRUE(process->page_table.rows[1].dirty);
+  ASSERT_EQ(0, process->writebacks);
+
+  delete process;
+}
@@ -0,0 +1,197 @@
+/**
+ * This file contains implementations for methods in the StackDistance class.
+ */
+
+#include "stack_distance/stack_distance.h"
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// Ensure COLD and SKIPPED are initialized.
+const size_t StackDistance::COLD;
+const size_t StackDistance::SKIPPED;
+
+// The number of slots the tree starts out with.
+static const size_t INITIAL_SLOTS = 1 << 12;
+
+// Sampling thresholds are taken out of this many hash values.
+static const uint64_t HASH_SPACE = 1 << 24;
+
+
+/**
+ * Mixes the bits of a key (the splitmix64 finalizer), so that nearby pages land
+ * far apart in the hash space.
+ */
+static uint64_t hash_key(uint64_t key) {
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    key = key ^ (key >> 31);
+    return key % HASH_SPACE;
+}
+
+
+StackDistance::StackDistance(size_t max_frames, double sample_rate, size_t max_keys)
+    : max_frames(max_frames),
+      threshold(sample_rate >= 1.0 ? HASH_SPACE : (uint64_t) (sample_rate * HASH_SPACE)),
+      max_keys(max_keys),
+      tree(INITIAL_SLOTS + 1, 0),
+      histogram(max_frames + 1, 0) {}
+
+
+size_t StackDistance::access(uint64_t key) {
+    this->accesses++;
+    if (!is_sampled(key)) {
+        return SKIPPED;
+    }
+    this->far_counts.clear();
+
+    if (this->next_slot + 1 >= this->tree.size()) {
+        compact();
+    }
+
+    // every sampled access stands in for 1 / rate accesses
+    double rate = get_sample_rate();
+    double weight = 1.0 / rate;
+
+    size_t slot = this->next_slot++;
+    size_t distance = COLD;
+
+    auto entry = this->last_slot.find(key);
+    if (entry == this->last_slot.end()) {
+        this->last_slot.emplace(key, slot);
+        this->cold_accesses += weight;
+
+        if (this->max_keys > 0) {
+            this->keys_by_hash.emplace(hash_key(key), key);
+        }
+    } else {
+        // count the distinct keys touched since (and including) the last access
+        size_t previous = entry->second;
+        distance = prefix_sum(slot - 1) - (previous == 0 ? 0 : prefix_sum(previous - 1));
+
+        update(previous, -1);
+        entry->second = slot;
+
+        // each sampled key stands in for 1 / rate keys in the full stack
+        if (rate < 1.0) {
+            distance = (size_t) (distance / rate + 0.5);
+        }
+
+        if (distance <= this->max_frames) {
+            this->histogram[distance] += weight;
+        } else {
+            this->far_accesses += weight;
+        }
+    }
+
+    update(slot, 1);
+
+    if (this->max_keys > 0 && this->last_slot.size() > this->max_keys) {
+        shrink_sample();
+    }
+    return distance;
+}
+
+
+size_t StackDistance::get_fault_count(size_t frames) const {
+    // an access hits in an LRU cache of n frames iff its distance is at most n,
+    // so sum the histogram from the top down once, for every n at a time
+    if (this->far_counts.empty()) {
+        this->far_counts.assign(this->max_frames + 1, 0.0);
+        for (size_t d = this->max_frames; d-- > 0;) {
+            this->far_counts[d] = this->far_counts[d + 1] + this->histogram[d + 1];
+        }
+    }
+
+    double faults = this->cold_accesses + this->far_accesses;
+    if (frames < this->max_frames) {
+        faults += this->far_counts[frames];
+    }
+    return (size_t) (faults + 0.5);
+}
+
+
+double StackDistance::get_miss_ratio(size_t frames) const {
+    if (this->accesses == 0) {
+        return 0.0;
+    }
+
+    // dividing by the true access count rather than the sampled estimate of it
+    // corrects for sampling bias (the SHARDS_adj adjustment)
+    return min(1.0, static_cast<double>(get_fault_count(frames)) / this->accesses);
+}
+
+
+size_t StackDistance::get_access_count() const {
+    return this->accesses;
+}
+
+
+size_t StackDistance::get_distinct_count() const {
+    return this->last_slot.size();
+}
+
+
+double StackDistance::get_sample_rate() const {
+    return static_cast<double>(this->threshold) / HASH_SPACE;
+}
+
+
+bool StackDistance::is_sampled(uint64_t key) const {
+    return this->threshold >= HASH_SPACE || hash_key(key) < this->threshold;
+}
+
+
+void StackDistance::shrink_sample() {
+    while (this->last_slot.size() > this->max_keys) {
+        // the largest remaining hash becomes the new (exclusive) threshold
+        this->threshold = this->keys_by_hash.top().first;
+
+        while (!this->keys_by_hash.empty()
+                && this->keys_by_hash.top().first >= this->threshold) {
+            uint64_t key = this->keys_by_hash.top().second;
+            this->keys_by_hash.pop();
+
+            auto entry = this->last_slot.find(key);
+            update(entry->second, -1);
+            this->last_slot.erase(entry);
+        }
+    }
+}
+
+
+void StackDistance::update(size_t slot, int delta) {
+    for (size_t i = slot + 1; i < this->tree.size(); i += i & (~i + 1)) {
+        this->tree[i] += delta;
+    }
+}
+
+
+size_t StackDistance::prefix_sum(size_t slot) const {
+    int sum = 0;
+    for (size_t i = slot + 1; i > 0; i -= i & (~i + 1)) {
+        sum += this->tree[i];
+    }
+    return sum;
+}
+
+
+void StackDistance::compact() {
+    // order the live slots by age, then hand them out again from zero
+    vector<pair<size_t, uint64_t>> live;
+    live.reserve(this->last_slot.size());
+    for (auto& entry : this->last_slot) {
+        live.emplace_back(entry.second, entry.first);
+    }
+    sort(live.begin(), live.end());
+
+    size_t slots = max(INITIAL_SLOTS, 2 * live.size());
+    this->tree.assign(slots + 1, 0);
+
+    for (size_t i = 0; i < live.size(); i++) {
+        this->last_slot[live[i].second] = i;
+        update(i, 1);
+    }
+    this->next_slot = live.size();
+}
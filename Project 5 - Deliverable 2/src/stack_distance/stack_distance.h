@@ -0,0 +1,189 @@
+/**
+ * This file contains the definition of the StackDistance class.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Computes LRU stack distances for a stream of accesses in a single pass
+ * (Mattson's stack algorithm), and from them the number of faults an LRU cache
+ * of every size up to some maximum would take on that stream.
+ *
+ * Each key remembers the 'slot' (logical time) of its last access, and a
+ * Fenwick tree over the slots marks which of them are still the most recent
+ * access of their key. The stack distance of an access is then the number of
+ * marked slots at or after the key's previous slot, which takes O(log n) per
+ * access. Slots are renumbered whenever the tree fills up, so memory stays
+ * proportional to the number of distinct keys rather than the trace length.
+ *
+ * For very large traces the analysis can be restricted to a spatially hashed
+ * sample of the keys (SHARDS): only keys whose hash falls under a threshold are
+ * tracked, their distances are scaled up by the inverse of the sampling rate,
+ * and each sampled access stands in for 1 / rate accesses. Optionally the
+ * number of tracked keys is capped, in which case the threshold is lowered
+ * (evicting the keys with the largest hashes) whenever the cap is exceeded.
+ */
+class StackDistance {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The distance reported for the first access to a key (a cold miss).
+    */
+    static const size_t COLD = -1;
+
+    /**
+    * The distance reported for an access to a key outside of the sample.
+    */
+    static const size_t SKIPPED = -2;
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. Fault counts can be queried for cache sizes up to and
+    * including max_frames. A sample_rate below 1 only tracks that fraction of
+    * the keys, and a nonzero max_keys caps the number of keys tracked at once.
+    */
+    StackDistance(size_t max_frames, double sample_rate = 1.0, size_t max_keys = 0);
+
+    /**
+    * Records an access to the given key and returns its (scaled) stack
+    * distance, where a distance of 1 means the key was the most recently used
+    * one. Returns COLD if the key has never been accessed before, or SKIPPED if
+    * the key is not part of the sample.
+    */
+    size_t access(uint64_t key);
+
+    /**
+    * Returns the number of recorded accesses that would have faulted in an LRU
+    * cache holding the given number of frames (at most max_frames). This is an
+    * estimate, rounded to the nearest access, when sampling.
+    */
+    size_t get_fault_count(size_t frames) const;
+
+    /**
+    * Returns the fraction of all recorded accesses that would have faulted in
+    * an LRU cache holding the given number of frames.
+    */
+    double get_miss_ratio(size_t frames) const;
+
+    /**
+    * Returns the total number of recorded accesses, sampled or not.
+    */
+    size_t get_access_count() const;
+
+    /**
+    * Returns the number of distinct keys currently tracked.
+    */
+    size_t get_distinct_count() const;
+
+    /**
+    * Returns the current sampling rate, which only ever decreases.
+    */
+    double get_sample_rate() const;
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Returns true if the given key falls under the sampling threshold.
+    */
+    bool is_sampled(uint64_t key) const;
+
+    /**
+    * Lowers the sampling threshold until no more than max_keys keys remain,
+    * forgetting the keys that fall out of the sample.
+    */
+    void shrink_sample();
+
+    /**
+    * Adds delta to the mark count of the given slot.
+    */
+    void update(size_t slot, int delta);
+
+    /**
+    * Returns the number of marked slots in [0, slot].
+    */
+    size_t prefix_sum(size_t slot) const;
+
+    /**
+    * Renumbers the live slots densely from zero and rebuilds the tree, growing
+    * it if the live slots would fill more than half of it.
+    */
+    void compact();
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The largest cache size fault counts are kept for.
+    */
+    size_t max_frames;
+
+    /**
+    * Keys whose hash (modulo the hash space) is below this are sampled.
+    */
+    uint64_t threshold;
+
+    /**
+    * The maximum number of keys to track at once, or 0 for no limit.
+    */
+    size_t max_keys;
+
+    /**
+    * The tracked keys, ordered by hash so the largest can be evicted first.
+    * Only maintained when max_keys is set.
+    */
+    std::priority_queue<std::pair<uint64_t, uint64_t>> keys_by_hash;
+
+    /**
+    * The Fenwick tree over slots, stored 1-based.
+    */
+    std::vector<int> tree;
+
+    /**
+    * The slot the next access will take.
+    */
+    size_t next_slot = 0;
+
+    /**
+    * The slot of the last access to each key.
+    */
+    std::unordered_map<uint64_t, size_t> last_slot;
+
+    /**
+    * histogram[d] is the (weighted) number of accesses with stack distance d,
+    * for d in [1, max_frames]. Index 0 is unused.
+    */
+    std::vector<double> histogram;
+
+    /**
+    * far_counts[n] is the (weighted) number of accesses with a stack distance
+    * in (n, max_frames], built from the histogram on the first fault count
+    * asked for after an access, so the whole curve takes one pass over it.
+    */
+    mutable std::vector<double> far_counts;
+
+    /**
+    * The weighted number of accesses with a stack distance beyond max_frames.
+    */
+    double far_accesses = 0;
+
+    /**
+    * The weighted number of cold accesses.
+    */
+    double cold_accesses = 0;
+
+    /**
+    * The total number of accesses.
+    */
+    size_t accesses = 0;
+};
@@ -0,0 +1,177 @@
+/**
+ * This file contains tests for the StackDistance class.
+ */
+
+#include "stack_distance/stack_distance.h"
+#include "gtest/gtest.h"
+#include <list>
+#include <algorithm>
+#include <random>
+
+using namespace std;
+
+
+/**
+ * Counts the faults of a straightforward LRU cache of the given size.
+ */
+size_t naive_lru_faults(const vector<uint64_t>& keys, size_t frames) {
+  list<uint64_t> stack;
+  size_t faults = 0;
+
+  for (uint64_t key : keys) {
+    auto it = find(stack.begin(), stack.end(), key);
+    if (it == stack.end()) {
+      faults++;
+      if (stack.size() == frames) {
+        stack.pop_back();
+      }
+    } else {
+      stack.erase(it);
+    }
+    stack.push_front(key);
+  }
+  return faults;
+}
+
+
+TEST(StackDistance, ColdAccess) {
+  StackDistance distances(8);
+
+  ASSERT_EQ(StackDistance::COLD, distances.access(42));
+  ASSERT_EQ(StackDistance::COLD, distances.access(7));
+}
+
+
+TEST(StackDistance, Distances) {
+  StackDistance distances(8);
+
+  distances.access(1);
+  distances.access(2);
+  distances.access(3);
+
+  ASSERT_EQ(1, distances.access(3));
+  ASSERT_EQ(3, distances.access(1));
+  ASSERT_EQ(2, distances.access(3));
+  ASSERT_EQ(3, distances.access(2));
+}
+
+
+TEST(StackDistance, FaultCounts) {
+  StackDistance distances(4);
+
+  // 1 2 3 1 2 3: three cold misses, then three accesses at distance 3.
+  for (int round = 0; round < 2; round++) {
+    for (uint64_t key = 1; key <= 3; key++) {
+      distances.access(key);
+    }
+  }
+
+  ASSERT_EQ(6, distances.get_access_count());
+  ASSERT_EQ(3, distances.get_distinct_count());
+  ASSERT_EQ(6, distances.get_fault_count(1));
+  ASSERT_EQ(6, distances.get_fault_count(2));
+  ASSERT_EQ(3, distances.get_fault_count(3));
+  ASSERT_EQ(3, distances.get_fault_count(4));
+}
+
+
+TEST(StackDistance, FaultCountsFollowLaterAccesses) {
+  StackDistance distances(4);
+
+  // 1 2 1: the second access to 1 is at distance 2
+  distances.access(1);
+  distances.access(2);
+  distances.access(1);
+  ASSERT_EQ(3, distances.get_fault_count(1));
+  ASSERT_EQ(2, distances.get_fault_count(2));
+
+  // asking for the curve does not freeze it: 2 is now at distance 2 as well,
+  // and 3 is cold
+  distances.access(2);
+  distances.access(3);
+  ASSERT_EQ(5, distances.get_fault_count(1));
+  ASSERT_EQ(3, distances.get_fault_count(2));
+  ASSERT_EQ(3, distances.get_fault_count(4));
+}
+
+
+TEST(StackDistance, MatchesNaiveLru) {
+  // Long enough to force the slots to be compacted several times.
+  mt19937 random(1234);
+  vector<uint64_t> keys;
+  for (int i = 0; i < 20000; i++) {
+    keys.push_back(random() % (i % 3 == 0 ? 300 : 40));
+  }
+
+  const size_t max_frames = 64;
+  StackDistance distances(max_frames);
+  for (uint64_t key : keys) {
+    distances.access(key);
+  }
+
+  for (size_t frames : {1, 2, 10, 39, 40, 41, 64}) {
+    ASSERT_EQ(naive_lru_faults(keys, frames), distances.get_fault_count(frames))
+        << "frames = " << frames;
+  }
+}
+
+
+TEST(StackDistance, SampleRateOneIsExact) {
+  StackDistance exact(16);
+  StackDistance sampled(16, 1.0);
+
+  for (uint64_t i = 0; i < 1000; i++) {
+    uint64_t key = (i * 7) % 23;
+    ASSERT_EQ(exact.access(key), sampled.access(key));
+  }
+  ASSERT_DOUBLE_EQ(1.0, sampled.get_sample_rate());
+}
+
+
+TEST(StackDistance, SampledSkipsKeys) {
+  StackDistance sampled(16, 0.1);
+
+  size_t skipped = 0;
+  for (uint64_t key = 0; key < 10000; key++) {
+    if (sampled.access(key) == StackDistance::SKIPPED) {
+      skipped++;
+    }
+  }
+
+  ASSERT_EQ(10000, sampled.get_access_count());
+  ASSERT_NEAR(9000, skipped, 300);
+  ASSERT_EQ(10000 - skipped, sampled.get_distinct_count());
+}
+
+
+TEST(StackDistance, SampledApproximatesExact) {
+  mt19937 random(42);
+  const size_t max_frames = 8192;
+  StackDistance exact(max_frames);
+  StackDistance sampled(max_frames, 0.1);
+
+  // A loop over 3000 keys mixed with a hot set of 1000.
+  for (int i = 0; i < 200000; i++) {
+    uint64_t key = (i % 2 == 0) ? (i / 2) % 3000 : 100000 + random() % 1000;
+    exact.access(key);
+    sampled.access(key);
+  }
+
+  for (size_t frames : {100, 1000, 2000, 3000, 6000}) {
+    ASSERT_NEAR(exact.get_miss_ratio(frames), sampled.get_miss_ratio(frames), 0.05)
+        << "frames = " << frames;
+  }
+}
+
+
+TEST(StackDistance, MaxKeysBoundsMemory) {
+  StackDistance sampled(64, 1.0, 100);
+
+  for (uint64_t i = 0; i < 50000; i++) {
+    sampled.access(i % 5000);
+    ASSERT_LE(sampled.get_distinct_count(), 100);
+  }
+
+  ASSERT_LT(sampled.get_sample_rate(), 0.05);
+  ASSERT_EQ(50000, sampled.get_access_count());
+}
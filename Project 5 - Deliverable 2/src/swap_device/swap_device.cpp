@@ -0,0 +1,52 @@
+/**
+ * This file contains implementations for methods in the SwapDevice class.
+ */
+
+#include "swap_device/swap_device.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+
+SwapDevice::SwapDevice(double read_latency, double write_latency, size_t queue_depth, double bandwidth)
+    : read_latency(read_latency), write_latency(write_latency), bandwidth(bandwidth), slots(queue_depth, 0.0)
+{
+    assert(queue_depth > 0 && bandwidth > 0.0);
+}
+
+
+double SwapDevice::submit(double time, size_t bytes, bool write) {
+    // wait for the first slot to free up, then for the link
+    auto slot = min_element(this->slots.begin(), this->slots.end());
+    double serviced = max(time, *slot) + (write ? this->write_latency : this->read_latency);
+    double done = max(serviced, this->link_free_at) + bytes / this->bandwidth;
+    this->link_free_at = done;
+    *slot = done;
+
+    // requests arrive in order, so the busy periods only ever grow at the end
+    if (time >= this->busy_until) {
+        this->busy_time += done - time;
+    } else if (done > this->busy_until) {
+        this->busy_time += done - this->busy_until;
+    }
+    this->busy_until = max(this->busy_until, done);
+
+    if (write) {
+        this->writes++;
+    } else {
+        this->reads++;
+        this->read_wait += done - time;
+    }
+    return done;
+}
+
+
+double SwapDevice::get_busy_time() const {
+    return this->busy_time;
+}
+
+
+double SwapDevice::get_read_wait() const {
+    return this->read_wait;
+}
@@ -0,0 +1,85 @@
+/**
+ * This file contains the definition of the SwapDevice class.
+ */
+
+#pragma once
+#include <cstdlib>
+#include <vector>
+
+
+/**
+ * A model of the device pages are swapped to and from. Up to queue_depth
+ * requests are serviced at once, each taking the device's read or write
+ * latency, after which its bytes are transferred over a link shared by every
+ * request, at the device's bandwidth. Requests beyond the queue depth wait
+ * for the first request to finish.
+ *
+ * Times are in nanoseconds. Requests must be submitted in order of time.
+ */
+class SwapDevice {
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. The bandwidth is in bytes per nanosecond.
+    */
+    SwapDevice(double read_latency, double write_latency, size_t queue_depth, double bandwidth);
+
+    /**
+    * Submits a request to read (or write) the given number of bytes at the
+    * given time, and returns the time it completes.
+    */
+    double submit(double time, size_t bytes, bool write);
+
+    /**
+    * Returns the total time during which at least one request was waiting or
+    * being serviced.
+    */
+    double get_busy_time() const;
+
+    /**
+    * Returns the total time reads spent waiting in the queue and being
+    * serviced, from submission to completion.
+    */
+    double get_read_wait() const;
+
+// CLASS INSTANCE VARIABLES
+public:
+
+    /**
+    * The number of reads and writes submitted.
+    */
+    size_t reads = 0;
+    size_t writes = 0;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The shape of the device.
+    */
+    double read_latency;
+    double write_latency;
+    double bandwidth;
+
+    /**
+    * When each slot of the queue next becomes free.
+    */
+    std::vector<double> slots;
+
+    /**
+    * When the link finishes the transfers already scheduled on it.
+    */
+    double link_free_at = 0.0;
+
+    /**
+    * When the last request completes, and the busy time up to then.
+    */
+    double busy_until = 0.0;
+    double busy_time = 0.0;
+
+    /**
+    * The total time from submission to completion of every read.
+    */
+    double read_wait = 0.0;
+};
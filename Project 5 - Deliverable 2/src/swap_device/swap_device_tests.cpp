@@ -0,0 +1,46 @@
+/**
+ * This file contains tests for the SwapDevice class.
+ */
+
+#include "swap_device/swap_device.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(SwapDevice, LatencyAndTransfer) {
+  SwapDevice device(100.0, 300.0, 1, 2.0);
+
+  ASSERT_DOUBLE_EQ(1132.0, device.submit(1000.0, 64, false));
+  ASSERT_DOUBLE_EQ(2332.0, device.submit(2000.0, 64, true));
+  ASSERT_EQ(1, device.reads);
+  ASSERT_EQ(1, device.writes);
+  ASSERT_DOUBLE_EQ(132.0 + 332.0, device.get_busy_time());
+  ASSERT_DOUBLE_EQ(132.0, device.get_read_wait());
+}
+
+
+TEST(SwapDevice, QueueDepth) {
+  SwapDevice shallow(100.0, 100.0, 1, 1000.0);
+  SwapDevice deep(100.0, 100.0, 2, 1000.0);
+
+  // one slot services the requests one after another, two at once
+  shallow.submit(0.0, 0, false);
+  ASSERT_DOUBLE_EQ(200.0, shallow.submit(0.0, 0, false));
+  deep.submit(0.0, 0, false);
+  ASSERT_DOUBLE_EQ(100.0, deep.submit(0.0, 0, false));
+  ASSERT_DOUBLE_EQ(200.0, deep.submit(0.0, 0, false));
+
+  ASSERT_DOUBLE_EQ(200.0, shallow.get_busy_time());
+  ASSERT_DOUBLE_EQ(200.0, deep.get_busy_time());
+  ASSERT_DOUBLE_EQ(100.0 + 100.0 + 200.0, deep.get_read_wait());
+}
+
+
+TEST(SwapDevice, SharedBandwidth) {
+  SwapDevice device(10.0, 10.0, 4, 1.0);
+
+  // the latencies overlap, but the transfers take turns on the link
+  ASSERT_DOUBLE_EQ(74.0, device.submit(0.0, 64, false));
+  ASSERT_DOUBLE_EQ(138.0, device.submit(0.0, 64, false));
+}
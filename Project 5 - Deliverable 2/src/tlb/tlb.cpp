@@ -0,0 +1,143 @@
+/**
+ * This file contains implementations for methods in the Tlb class.
+ */
+
+#include "tlb/tlb.h"
+#include <algorithm>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const size_t Tlb::NONE;
+const uint64_t Tlb::EMPTY;
+
+
+/**
+ * The tag bit set for entries mapping huge pages.
+ */
+static const uint64_t HUGE_TAG = uint64_t(1) << 31;
+
+
+/**
+ * Packs an address space and page (or huge page) into a single tag.
+ */
+static uint64_t make_tag(size_t asid, size_t page, bool huge) {
+    return ((uint64_t) asid << 32) | (huge ? HUGE_TAG : 0) | (page & (HUGE_TAG - 1));
+}
+
+
+Tlb::Tlb(size_t num_entries, size_t ways, Policy policy)
+    : num_sets(num_entries / ways), ways(ways), policy(policy),
+      tags(num_entries, EMPTY), frames(num_entries, NONE), stamps(num_entries, 0)
+{
+}
+
+
+bool Tlb::lookup(size_t asid, size_t page, size_t& frame, bool huge) {
+    size_t set = page % this->num_sets;
+    size_t way = find(set, make_tag(asid, page, huge));
+
+    if (asid >= this->hits_by_asid.size()) {
+        this->hits_by_asid.resize(asid + 1, 0);
+        this->misses_by_asid.resize(asid + 1, 0);
+    }
+
+    if (way == NONE) {
+        this->misses++;
+        this->misses_by_asid[asid]++;
+        this->huge_misses += huge;
+        return false;
+    }
+
+    size_t entry = set * this->ways + way;
+    if (this->policy == Policy::LRU) {
+        this->stamps[entry] = ++this->clock;
+    }
+    frame = this->frames[entry];
+    this->hits++;
+    this->hits_by_asid[asid]++;
+    this->huge_hits += huge;
+    return true;
+}
+
+
+void Tlb::insert(size_t asid, size_t page, size_t frame, bool huge) {
+    size_t set = page % this->num_sets;
+    size_t first = set * this->ways;
+    uint64_t tag = make_tag(asid, page, huge);
+
+    // reuse the entry if it is already cached, or else an empty one
+    size_t way = find(set, tag);
+    if (way == NONE) {
+        way = find(set, EMPTY);
+    }
+
+    if (way == NONE) {
+        if (this->policy == Policy::RANDOM) {
+            // xorshift64
+            this->random_state ^= this->random_state << 13;
+            this->random_state ^= this->random_state >> 7;
+            this->random_state ^= this->random_state << 17;
+            way = this->random_state % this->ways;
+        } else {
+            // the oldest stamp was used (LRU) or inserted (FIFO) longest ago
+            way = min_element(this->stamps.begin() + first, this->stamps.begin() + first + this->ways)
+                - (this->stamps.begin() + first);
+        }
+    }
+
+    size_t entry = first + way;
+    this->tags[entry] = tag;
+    this->frames[entry] = frame;
+    this->stamps[entry] = ++this->clock;
+}
+
+
+void Tlb::invalidate(size_t asid, size_t page, bool huge) {
+    size_t set = page % this->num_sets;
+    size_t way = find(set, make_tag(asid, page, huge));
+
+    if (way != NONE) {
+        this->tags[set * this->ways + way] = EMPTY;
+        this->shootdowns++;
+    }
+}
+
+
+void Tlb::flush() {
+    fill(this->tags.begin(), this->tags.end(), EMPTY);
+    this->flushes++;
+}
+
+
+size_t Tlb::get_entry_count(bool huge) const {
+    size_t count = 0;
+    for (uint64_t tag : this->tags) {
+        if (tag != EMPTY && ((tag & HUGE_TAG) != 0) == huge) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+size_t Tlb::get_hits(size_t asid) const {
+    return asid < this->hits_by_asid.size() ? this->hits_by_asid[asid] : 0;
+}
+
+
+size_t Tlb::get_misses(size_t asid) const {
+    return asid < this->misses_by_asid.size() ? this->misses_by_asid[asid] : 0;
+}
+
+
+size_t Tlb::find(size_t set, uint64_t tag) const {
+    const uint64_t* first = &this->tags[set * this->ways];
+
+    for (size_t way = 0; way < this->ways; way++) {
+        if (first[way] == tag) {
+            return way;
+        }
+    }
+    return NONE;
+}
@@ -0,0 +1,161 @@
+/**
+ * This file contains the definition of the Tlb class.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+
+/**
+ * A set-associative translation lookaside buffer, caching page-to-frame
+ * translations in front of the page tables.
+ *
+ * Entries are tagged with an address space identifier (ASID) as well as the
+ * page, so translations of several processes can be cached at once; a TLB
+ * without ASIDs is modelled by flushing it on every context switch. The sets
+ * are laid out one after another in flat arrays of tags, frames and
+ * replacement stamps, so a lookup only reads a few adjacent words.
+ *
+ * Entries may also map huge pages, numbered by the huge page rather than the
+ * base page and tagged apart from base pages, so that a single entry covers a
+ * whole run of base pages.
+ */
+class Tlb {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The way (or frame) reported when there is none.
+    */
+    static const size_t NONE = -1;
+
+    /**
+    * The policies for choosing which entry of a full set to replace.
+    */
+    enum class Policy {
+        LRU,
+        FIFO,
+        RANDOM
+    };
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor. num_entries must be a positive multiple of ways.
+    */
+    Tlb(size_t num_entries, size_t ways, Policy policy);
+
+    /**
+    * Looks up the translation of the given page (or huge page) of the given
+    * address space, setting frame and returning true on a hit.
+    */
+    bool lookup(size_t asid, size_t page, size_t& frame, bool huge = false);
+
+    /**
+    * Caches the translation of the given page (or huge page) to the given
+    * frame, replacing an entry of its set if it is full.
+    */
+    void insert(size_t asid, size_t page, size_t frame, bool huge = false);
+
+    /**
+    * Drops the translation of the given page (or huge page), if cached (a
+    * TLB shootdown, for when the page is evicted).
+    */
+    void invalidate(size_t asid, size_t page, bool huge = false);
+
+    /**
+    * Drops every translation.
+    */
+    void flush();
+
+    /**
+    * Returns the number of entries mapping huge pages, or base pages.
+    */
+    size_t get_entry_count(bool huge) const;
+
+    /**
+    * Returns the number of lookups in the given address space that hit.
+    */
+    size_t get_hits(size_t asid) const;
+
+    /**
+    * Returns the number of lookups in the given address space that missed.
+    */
+    size_t get_misses(size_t asid) const;
+
+// CLASS INSTANCE VARIABLES
+public:
+
+    /**
+    * The total number of lookups that hit and missed.
+    */
+    size_t hits = 0;
+    size_t misses = 0;
+
+    /**
+    * The number of lookups of huge pages that hit and missed, which are also
+    * counted in hits and misses.
+    */
+    size_t huge_hits = 0;
+    size_t huge_misses = 0;
+
+    /**
+    * The number of times the whole TLB was flushed.
+    */
+    size_t flushes = 0;
+
+    /**
+    * The number of cached translations dropped because their page was evicted.
+    */
+    size_t shootdowns = 0;
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Returns the way of the given set holding the given tag, or NONE.
+    */
+    size_t find(size_t set, uint64_t tag) const;
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * The tag of an empty entry.
+    */
+    static const uint64_t EMPTY = -1;
+
+    /**
+    * The shape of the TLB.
+    */
+    size_t num_sets;
+    size_t ways;
+    Policy policy;
+
+    /**
+    * For each entry, set by set: its (ASID, page) tag, the frame it maps to,
+    * and when it was last used (LRU) or inserted (FIFO).
+    */
+    std::vector<uint64_t> tags;
+    std::vector<size_t> frames;
+    std::vector<size_t> stamps;
+
+    /**
+    * Advances on every lookup and insertion, to stamp entries with.
+    */
+    size_t clock = 0;
+
+    /**
+    * The state of the generator picking victims for the RANDOM policy.
+    */
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+    /**
+    * Hits and misses by ASID.
+    */
+    std::vector<size_t> hits_by_asid;
+    std::vector<size_t> misses_by_asid;
+};
@@ -0,0 +1,168 @@
+/**
+ * This file contains tests for the Tlb class.
+ */
+
+#include "tlb/tlb.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+
+TEST(Tlb, MissThenHit) {
+  Tlb tlb(16, 4, Tlb::Policy::LRU);
+  size_t frame;
+
+  ASSERT_FALSE(tlb.lookup(0, 5, frame));
+  tlb.insert(0, 5, 42);
+
+  ASSERT_TRUE(tlb.lookup(0, 5, frame));
+  ASSERT_EQ(42, frame);
+  ASSERT_EQ(1, tlb.hits);
+  ASSERT_EQ(1, tlb.misses);
+}
+
+
+TEST(Tlb, TaggedByAddressSpace) {
+  Tlb tlb(16, 4, Tlb::Policy::LRU);
+  size_t frame;
+
+  tlb.insert(0, 5, 42);
+  tlb.insert(1, 5, 43);
+
+  ASSERT_TRUE(tlb.lookup(1, 5, frame));
+  ASSERT_EQ(43, frame);
+  ASSERT_TRUE(tlb.lookup(0, 5, frame));
+  ASSERT_EQ(42, frame);
+  ASSERT_FALSE(tlb.lookup(2, 5, frame));
+
+  ASSERT_EQ(1, tlb.get_hits(0));
+  ASSERT_EQ(1, tlb.get_hits(1));
+  ASSERT_EQ(1, tlb.get_misses(2));
+  ASSERT_EQ(0, tlb.get_misses(7));
+}
+
+
+TEST(Tlb, LruReplacement) {
+  // Two sets of two ways; even pages share set 0.
+  Tlb tlb(4, 2, Tlb::Policy::LRU);
+  size_t frame;
+
+  tlb.insert(0, 0, 10);
+  tlb.insert(0, 2, 12);
+  ASSERT_TRUE(tlb.lookup(0, 0, frame));
+  tlb.insert(0, 4, 14);
+
+  ASSERT_TRUE(tlb.lookup(0, 0, frame));
+  ASSERT_FALSE(tlb.lookup(0, 2, frame));
+  ASSERT_TRUE(tlb.lookup(0, 4, frame));
+}
+
+
+TEST(Tlb, FifoReplacement) {
+  Tlb tlb(4, 2, Tlb::Policy::FIFO);
+  size_t frame;
+
+  tlb.insert(0, 0, 10);
+  tlb.insert(0, 2, 12);
+  ASSERT_TRUE(tlb.lookup(0, 0, frame));
+  tlb.insert(0, 4, 14);
+
+  ASSERT_FALSE(tlb.lookup(0, 0, frame));
+  ASSERT_TRUE(tlb.lookup(0, 2, frame));
+}
+
+
+TEST(Tlb, SetsAreIndependent) {
+  Tlb tlb(4, 2, Tlb::Policy::LRU);
+  size_t frame;
+
+  // Filling set 0 leaves the odd pages in set 1 alone.
+  tlb.insert(0, 1, 11);
+  for (size_t page = 0; page < 10; page += 2) {
+    tlb.insert(0, page, page);
+  }
+
+  ASSERT_TRUE(tlb.lookup(0, 1, frame));
+  ASSERT_EQ(11, frame);
+}
+
+
+TEST(Tlb, RandomReplacementStaysInSet) {
+  Tlb tlb(8, 4, Tlb::Policy::RANDOM);
+  size_t frame;
+
+  for (size_t page = 0; page < 100; page += 2) {
+    tlb.insert(0, page, page);
+  }
+
+  // Only the last insertion is sure to be cached, but all of set 0 is full.
+  ASSERT_TRUE(tlb.lookup(0, 98, frame));
+  size_t cached = 0;
+  for (size_t page = 0; page < 100; page += 2) {
+    cached += tlb.lookup(0, page, frame);
+  }
+  ASSERT_EQ(4, cached);
+}
+
+
+TEST(Tlb, Invalidate) {
+  Tlb tlb(16, 4, Tlb::Policy::LRU);
+  size_t frame;
+
+  tlb.insert(0, 5, 42);
+  tlb.invalidate(0, 5);
+  tlb.invalidate(0, 6);
+
+  ASSERT_FALSE(tlb.lookup(0, 5, frame));
+  ASSERT_EQ(1, tlb.shootdowns);
+}
+
+
+TEST(Tlb, Flush) {
+  Tlb tlb(16, 4, Tlb::Policy::LRU);
+  size_t frame;
+
+  tlb.insert(0, 5, 42);
+  tlb.insert(1, 6, 43);
+  tlb.flush();
+
+  ASSERT_FALSE(tlb.lookup(0, 5, frame));
+  ASSERT_FALSE(tlb.lookup(1, 6, frame));
+  ASSERT_EQ(1, tlb.flushes);
+}
+
+
+TEST(Tlb, FullyAssociative) {
+  Tlb tlb(8, 8, Tlb::Policy::LRU);
+  size_t frame;
+
+  for (size_t page = 0; page < 8; page++) {
+    tlb.insert(0, page * 3, page);
+  }
+  for (size_t page = 0; page < 8; page++) {
+    ASSERT_TRUE(tlb.lookup(0, page * 3, frame));
+    ASSERT_EQ(page, frame);
+  }
+}
+
+
+TEST(Tlb, HugePagesTaggedApart) {
+  Tlb tlb(16, 4, Tlb::Policy::LRU);
+  size_t frame;
+
+  tlb.insert(0, 2, 64, true);
+  ASSERT_FALSE(tlb.lookup(0, 2, frame));
+  ASSERT_TRUE(tlb.lookup(0, 2, frame, true));
+  ASSERT_EQ(64, frame);
+  ASSERT_EQ(1, tlb.huge_hits);
+  ASSERT_EQ(0, tlb.huge_misses);
+
+  tlb.insert(0, 2, 7);
+  ASSERT_EQ(1, tlb.get_entry_count(true));
+  ASSERT_EQ(1, tlb.get_entry_count(false));
+
+  tlb.invalidate(0, 2, true);
+  ASSERT_FALSE(tlb.lookup(0, 2, frame, true));
+  ASSERT_TRUE(tlb.lookup(0, 2, frame));
+  ASSERT_EQ(1, tlb.huge_misses);
+}
@@ -0,0 +1,328 @@
+/**
+ * This file contains implementations for methods in the TraceSink class, and
+ * the event log decoder.
+ */
+
+#include "trace_sink/trace_sink.h"
+#include "mapped_file/mapped_file.h"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// Ensure the constants are initialized.
+const char TraceSink::MAGIC[8] = {'M', 'E', 'M', 'S', 'I', 'M', 'E', 'V'};
+const uint16_t TraceSink::VERSION;
+
+
+/**
+ * The text of the events without fields, by type.
+ */
+static const char* const EVENT_TEXT[] = {
+    nullptr,
+    "\t-> TLB HIT\n",
+    "\t-> TLB MISS\n",
+    "\t-> IN MEMORY\n",
+    "\t-> PAGE FAULT\n",
+    "\t-> SHARED FRAME\n",
+    nullptr,
+    nullptr,
+    "\t-> HUGE PAGE FAULT\n",
+    "\t-> PROMOTED TO HUGE PAGE\n",
+    "\t-> DEMOTED HUGE PAGE\n",
+    "\t-> COPY ON WRITE\n",
+    nullptr,
+    nullptr,
+    "\t-> CACHE MISS\n",
+    "\t-> FROM COMPRESSED POOL\n"
+};
+
+
+/**
+ * Appends the given text to the line at end, returning the new end.
+ */
+static char* append(char* end, const char* text) {
+    size_t length = strlen(text);
+    memcpy(end, text, length);
+    return end + length;
+}
+
+
+/**
+ * Appends the given number in decimal.
+ */
+template <typename Integer>
+static char* append_decimal(char* end, Integer value) {
+    return to_chars(end, end + 24, value).ptr;
+}
+
+
+/**
+ * Appends the low bits of the given number in binary, highest first.
+ */
+static char* append_binary(char* end, uint64_t value, size_t bits) {
+    for (size_t i = bits; i-- > 0;) {
+        *end++ = '0' + ((value >> i) & 1);
+    }
+    return end;
+}
+
+
+TraceSink::TraceSink(ostream& out, bool binary) : binary(binary), writer(out) {
+    if (binary) {
+        char header[12];
+        memcpy(header, MAGIC, sizeof(MAGIC));
+        header[8] = (char) (VERSION & 0xFF);
+        header[9] = (char) (VERSION >> 8);
+        header[10] = (char) VirtualAddress::PAGE_BITS;
+        header[11] = (char) VirtualAddress::OFFSET_BITS;
+        this->writer.write(header, sizeof(header));
+    }
+}
+
+
+void TraceSink::access(const VirtualAddress& address) {
+    this->events++;
+    if (this->binary) {
+        int64_t pid = address.process_id;
+        uint64_t bits = ((uint64_t) address.page << VirtualAddress::OFFSET_BITS) | address.offset;
+        this->write_type(Event::ACCESS);
+        this->write_varint(((uint64_t) pid << 1) ^ (uint64_t) (pid >> 63));
+        this->write_varint((bits << 1) | address.write);
+        return;
+    }
+
+    // the same text as VirtualAddress's output operator, without the strings
+    char line[128];
+    char* end = append(line, "PID ");
+    end = append_decimal(end, address.process_id);
+    end = append(end, " @ ");
+    end = append_binary(end, address.page, VirtualAddress::PAGE_BITS);
+    end = append_binary(end, address.offset, VirtualAddress::OFFSET_BITS);
+    end = append(end, " [page: ");
+    end = append_decimal(end, address.page);
+    end = append(end, "; offset: ");
+    end = append_decimal(end, address.offset);
+    end = append(end, address.write ? "] (write)\n" : "]\n");
+    this->writer.write(line, end - line);
+}
+
+
+void TraceSink::event(Event event) {
+    this->events++;
+    if (this->binary) {
+        this->write_type(event);
+    } else {
+        const char* text = EVENT_TEXT[(size_t) event];
+        this->writer.write(text, strlen(text));
+    }
+}
+
+
+void TraceSink::physical_address(const PhysicalAddress& address) {
+    this->events++;
+    if (this->binary) {
+        this->write_type(Event::PHYSICAL_ADDRESS);
+        this->write_varint(address.frame);
+        this->write_varint(address.offset);
+        return;
+    }
+
+    // the frame is widened past FRAME_BITS when it needs more, as in
+    // PhysicalAddress::to_string()
+    size_t frame_bits = PhysicalAddress::FRAME_BITS;
+    while (frame_bits < 64 && ((uint64_t) address.frame >> frame_bits) != 0) {
+        frame_bits++;
+    }
+
+    char line[192];
+    char* end = append(line, "\t-> physical address ");
+    end = append_binary(end, address.frame, frame_bits);
+    end = append_binary(end, address.offset, PhysicalAddress::OFFSET_BITS);
+    end = append(end, " [frame: ");
+    end = append_decimal(end, address.frame);
+    end = append(end, "; offset: ");
+    end = append_decimal(end, address.offset);
+    end = append(end, "]\n");
+    this->writer.write(line, end - line);
+}
+
+
+void TraceSink::rss(size_t rss) {
+    this->events++;
+    if (this->binary) {
+        this->write_type(Event::RSS);
+        this->write_varint(rss);
+        return;
+    }
+
+    char line[48];
+    char* end = append(line, "\t-> RSS: ");
+    end = append_decimal(end, rss);
+    *end++ = '\n';
+    this->writer.write(line, end - line);
+}
+
+
+void TraceSink::prefetched(size_t page) {
+    this->events++;
+    if (this->binary) {
+        this->write_type(Event::PREFETCHED);
+        this->write_varint(page);
+        return;
+    }
+
+    char line[48];
+    char* end = append(line, "\t-> PREFETCHED PAGE ");
+    end = append_decimal(end, page);
+    *end++ = '\n';
+    this->writer.write(line, end - line);
+}
+
+
+void TraceSink::cache_hit(const string& level) {
+    this->events++;
+    if (this->binary) {
+        this->write_type(Event::CACHE_HIT);
+        this->write_varint(level.size());
+        this->writer.write(level);
+        return;
+    }
+
+    this->writer.write("\t-> ", 4);
+    this->writer.write(level);
+    this->writer.write(" HIT\n", 5);
+}
+
+
+void TraceSink::flush() {
+    this->writer.flush();
+}
+
+
+size_t TraceSink::get_event_count() const {
+    return this->events;
+}
+
+
+void TraceSink::write_type(Event event) {
+    char type = (char) event;
+    this->writer.write(&type, 1);
+}
+
+
+void TraceSink::write_varint(uint64_t value) {
+    char bytes[10];
+    size_t count = 0;
+    while (value >= 0x80) {
+        bytes[count++] = (char) (value | 0x80);
+        value >>= 7;
+    }
+    bytes[count++] = (char) value;
+    this->writer.write(bytes, count);
+}
+
+
+/**
+ * Decodes the varint at the given position, advancing past it. Returns false
+ * if the data ends in the middle of it.
+ */
+static bool read_varint(const char* data, size_t size, size_t& position, uint64_t& value) {
+    value = 0;
+    for (size_t shift = 0; position < size && shift < 64; shift += 7) {
+        uint8_t byte = data[position++];
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int decode_event_log(const char* data, size_t size, ostream& out) {
+    if (size < 12 || memcmp(data, TraceSink::MAGIC, sizeof(TraceSink::MAGIC)) != 0) {
+        cerr << "Not an event log." << endl;
+        return 1;
+    }
+    uint16_t version = (uint8_t) data[8] | ((uint8_t) data[9] << 8);
+    if (version != TraceSink::VERSION || (size_t) data[10] != VirtualAddress::PAGE_BITS
+            || (size_t) data[11] != VirtualAddress::OFFSET_BITS) {
+        cerr << "Event log was written by an incompatible version." << endl;
+        return 1;
+    }
+
+    TraceSink sink(out);
+    size_t position = 12;
+    uint64_t first;
+    uint64_t second;
+    while (position < size) {
+        TraceSink::Event event = (TraceSink::Event) (uint8_t) data[position++];
+        bool valid = true;
+
+        switch (event) {
+            case TraceSink::Event::ACCESS:
+                valid = read_varint(data, size, position, first) && read_varint(data, size, position, second);
+                if (valid) {
+                    int pid = (int) ((int64_t) (first >> 1) ^ -(int64_t) (first & 1));
+                    size_t bits = second >> 1;
+                    sink.access(VirtualAddress(pid, bits >> VirtualAddress::OFFSET_BITS,
+                        bits & VirtualAddress::OFFSET_BITMASK, second & 1));
+                }
+                break;
+
+            case TraceSink::Event::PHYSICAL_ADDRESS:
+                valid = read_varint(data, size, position, first) && read_varint(data, size, position, second);
+                if (valid) {
+                    sink.physical_address(PhysicalAddress(first, second));
+                }
+                break;
+
+            case TraceSink::Event::RSS:
+                valid = read_varint(data, size, position, first);
+                if (valid) {
+                    sink.rss(first);
+                }
+                break;
+
+            case TraceSink::Event::PREFETCHED:
+                valid = read_varint(data, size, position, first);
+                if (valid) {
+                    sink.prefetched(first);
+                }
+                break;
+
+            case TraceSink::Event::CACHE_HIT:
+                valid = read_varint(data, size, position, first) && first <= size - position;
+                if (valid) {
+                    sink.cache_hit(string(data + position, first));
+                    position += first;
+                }
+                break;
+
+            default:
+                valid = (size_t) event <= (size_t) TraceSink::Event::FROM_POOL;
+                if (valid) {
+                    sink.event(event);
+                }
+        }
+
+        if (!valid) {
+            sink.flush();
+            cerr << "Malformed event log record at byte " << position << "." << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+int decode_event_log(const string& path, ostream& out) {
+    shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file) {
+        cerr << "Unable to open file: " << path << endl;
+        return 1;
+    }
+    return decode_event_log(file->data(), file->size(), out);
+}
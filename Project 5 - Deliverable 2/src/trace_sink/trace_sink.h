@@ -0,0 +1,171 @@
+/**
+ * This file contains the definition of the TraceSink class and of the event
+ * log format it can write.
+ *
+ * An event log starts with a header, and then holds one record per event. All
+ * integers are little-endian.
+ *
+ *   magic        8 bytes, "MEMSIMEV"
+ *   version      uint16
+ *   page bits    uint8, must match VirtualAddress::PAGE_BITS
+ *   offset bits  uint8, must match VirtualAddress::OFFSET_BITS
+ *   records      one per event, up to the end of the file
+ *
+ * Each record is the event's type in a byte, followed by its fields as
+ * varints (LEB128):
+ *
+ *   ACCESS            zigzag-encoded PID, then the address shifted left by
+ *                     one, with the low bit set for a write
+ *   PHYSICAL_ADDRESS  the frame, then the offset
+ *   RSS               the resident set size
+ *   PREFETCHED        the page
+ *   CACHE_HIT         the length of the level's name, then the name itself
+ *
+ * The other events have no fields.
+ */
+
+#pragma once
+#include "buffered_writer/buffered_writer.h"
+#include "physical_address/physical_address.h"
+#include "virtual_address/virtual_address.h"
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+
+
+/**
+ * Where the simulation reports what happens on each access, for -v. The
+ * events are either formatted as the verbose text, into a reusable line
+ * buffer and on through a BufferedWriter, or recorded in the compact binary
+ * event log, which decode_event_log() turns back into the same text.
+ *
+ * Nothing is flushed per line; flush() must be called before anything else
+ * is written to the same stream.
+ */
+class TraceSink {
+// PUBLIC CONSTANTS
+public:
+
+    /**
+    * The magic bytes every event log starts with.
+    */
+    static const char MAGIC[8];
+
+    /**
+    * The current version of the event log format.
+    */
+    static const uint16_t VERSION = 1;
+
+    /**
+    * The events of an access.
+    */
+    enum class Event : uint8_t {
+        ACCESS,
+        TLB_HIT,
+        TLB_MISS,
+        IN_MEMORY,
+        PAGE_FAULT,
+        SHARED_FRAME,
+        PHYSICAL_ADDRESS,
+        RSS,
+        HUGE_PAGE_FAULT,
+        PROMOTED,
+        DEMOTED,
+        COPY_ON_WRITE,
+        PREFETCHED,
+        CACHE_HIT,
+        CACHE_MISS,
+        FROM_POOL
+    };
+
+// PUBLIC API METHODS
+public:
+
+    /**
+    * Constructor, for a sink writing text, or the event log if binary is
+    * set (starting with its header), to the given stream. The stream must
+    * outlive this sink.
+    */
+    TraceSink(std::ostream& out, bool binary = false);
+
+    /**
+    * Reports an access to the given address, which starts its events.
+    */
+    void access(const VirtualAddress& address);
+
+    /**
+    * Reports an event without any fields.
+    */
+    void event(Event event);
+
+    /**
+    * Reports the physical address an access was translated to.
+    */
+    void physical_address(const PhysicalAddress& address);
+
+    /**
+    * Reports the resident set size of the process after an access.
+    */
+    void rss(size_t rss);
+
+    /**
+    * Reports that the given page was prefetched.
+    */
+    void prefetched(size_t page);
+
+    /**
+    * Reports that an access hit in the cache level of the given name.
+    */
+    void cache_hit(const std::string& level);
+
+    /**
+    * Writes out everything buffered.
+    */
+    void flush();
+
+    /**
+    * Returns the number of events reported.
+    */
+    size_t get_event_count() const;
+
+// PRIVATE METHODS
+private:
+
+    /**
+    * Appends the given event's type, or value as a varint, to the event log.
+    */
+    void write_type(Event event);
+    void write_varint(uint64_t value);
+
+// PRIVATE INSTANCE VARIABLES
+private:
+
+    /**
+    * Whether the event log is written rather than text.
+    */
+    bool binary;
+
+    /**
+    * Buffers the output on its way to the stream.
+    */
+    BufferedWriter writer;
+
+    /**
+    * The number of events reported.
+    */
+    size_t events = 0;
+};
+
+
+/**
+ * Writes the verbose text of the events in the given event log to out.
+ * Returns nonzero (after printing why) if the log is malformed.
+ */
+int decode_event_log(const char* data, size_t size, std::ostream& out);
+
+/**
+ * Writes the verbose text of the events in the event log at the given path
+ * to out. Returns nonzero (after printing why) on failure.
+ */
+int decode_event_log(const std::string& path, std::ostream& out);
@@ -0,0 +1,88 @@
+/**
+ * This file contains tests for the TraceSink class and the event log decoder.
+ */
+
+#include "trace_sink/trace_sink.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+using namespace std;
+
+
+/**
+ * Reports one of every event to the given sink.
+ */
+static void report_events(TraceSink& sink) {
+  sink.access(VirtualAddress(12, 85, 60));
+  sink.event(TraceSink::Event::TLB_MISS);
+  sink.event(TraceSink::Event::PAGE_FAULT);
+  sink.prefetched(86);
+  sink.physical_address(PhysicalAddress(3, 60));
+  sink.cache_hit("L2");
+  sink.rss(2);
+  sink.access(VirtualAddress(-1, 0, 1, true));
+  sink.event(TraceSink::Event::FROM_POOL);
+  sink.physical_address(PhysicalAddress(5000, 1));
+  sink.event(TraceSink::Event::CACHE_MISS);
+}
+
+
+TEST(TraceSink, MatchesOutputOperators) {
+  ostringstream out;
+  ostringstream expected;
+  {
+    TraceSink sink(out);
+    report_events(sink);
+    ASSERT_EQ("", out.str());
+    ASSERT_EQ(11, sink.get_event_count());
+  }
+
+  expected << VirtualAddress(12, 85, 60) << "\n"
+    << "\t-> TLB MISS\n"
+    << "\t-> PAGE FAULT\n"
+    << "\t-> PREFETCHED PAGE 86\n"
+    << "\t-> physical address " << PhysicalAddress(3, 60) << "\n"
+    << "\t-> L2 HIT\n"
+    << "\t-> RSS: 2\n"
+    << VirtualAddress(-1, 0, 1, true) << "\n"
+    << "\t-> FROM COMPRESSED POOL\n"
+    << "\t-> physical address " << PhysicalAddress(5000, 1) << "\n"
+    << "\t-> CACHE MISS\n";
+  ASSERT_EQ(expected.str(), out.str());
+}
+
+
+TEST(TraceSink, EventLogDecodesToText) {
+  ostringstream text;
+  ostringstream log;
+  {
+    TraceSink text_sink(text);
+    TraceSink log_sink(log, true);
+    report_events(text_sink);
+    report_events(log_sink);
+  }
+
+  // a record is a few bytes, far shorter than its line of text
+  ASSERT_LT(log.str().size(), text.str().size() / 4);
+
+  ostringstream decoded;
+  ASSERT_EQ(0, decode_event_log(log.str().data(), log.str().size(), decoded));
+  ASSERT_EQ(text.str(), decoded.str());
+}
+
+
+TEST(TraceSink, RejectsMalformedLogs) {
+  ostringstream log;
+  {
+    TraceSink sink(log, true);
+    sink.access(VirtualAddress(1, 2, 3));
+  }
+  string bytes = log.str();
+  ostringstream decoded;
+
+  testing::internal::CaptureStderr();
+  ASSERT_NE(0, decode_event_log("MEMSIMTR", 8, decoded));
+  ASSERT_NE(0, decode_event_log(bytes.data(), bytes.size() - 1, decoded));
+  ASSERT_NE(0, decode_event_log((bytes + "\x7f").data(), bytes.size() + 1, decoded));
+  testing::internal::GetCapturedStderr();
+}
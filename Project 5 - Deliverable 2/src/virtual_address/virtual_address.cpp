@@ -5,26 +5,65 @@
  */
 
 #include "virtual_address/virtual_address.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 
 using namespace std;
 
 VirtualAddress VirtualAddress::from_string(int process_id, string address) {
-    // split address into page and offset
-    string page = "", offset = "";
-    for (int i = 0; i < PAGE_BITS; i++) {
-        page += address.at(i);
+    return from_chars(process_id, address.data(), address.size());
+}
+
+
+VirtualAddress VirtualAddress::from_chars(int process_id, const char* address, size_t length, bool write) {
+    if (length < ADDRESS_BITS) {
+        throw out_of_range("virtual address has fewer than " + std::to_string(ADDRESS_BITS) + " bits");
     }
-    for(int i = PAGE_BITS; i < PAGE_BITS + OFFSET_BITS; i++) {
-        offset += address.at(i);
+
+    // turn the binary digits into an integer and split it into page and offset
+    bool valid = true;
+    size_t bits = parse_binary(address, ADDRESS_BITS, valid);
+    if (!valid) {
+        throw invalid_argument("virtual address contains a digit other than 0 or 1");
     }
 
-    // turn string binary into integers
-    int page_integer = bitset<PAGE_BITS>(page).to_ulong();
-    int offset_integer = bitset<OFFSET_BITS>(offset).to_ulong();
+    return VirtualAddress(process_id, (bits & PAGE_BITMASK) >> OFFSET_BITS, bits & OFFSET_BITMASK, write);
+}
 
-    // create and return a new virtual address
-    VirtualAddress virtual_address = VirtualAddress(process_id, page_integer, offset_integer);
-    return virtual_address;
+
+size_t VirtualAddress::parse_binary(const char* digits, size_t count, bool& valid) {
+    const uint64_t ONES = 0x0101010101010101ULL;
+    const uint64_t ZEROS = 0x3030303030303030ULL;
+
+    size_t value = 0;
+    uint64_t invalid = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        // load eight digits with the first one in the lowest byte
+        uint64_t chunk;
+        memcpy(&chunk, digits + i, sizeof(chunk));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        chunk = __builtin_bswap64(chunk);
+#endif
+
+        // every byte must be '0' (0x30) or '1' (0x31)
+        invalid |= (chunk & ~ONES) ^ ZEROS;
+
+        // gather the low bit of each byte into the top byte, first digit highest
+        uint64_t byte = ((chunk & ONES) * 0x8040201008040201ULL) >> 56;
+        value = (value << 8) | byte;
+    }
+
+    for (; i < count; i++) {
+        unsigned char digit = digits[i] - '0';
+        invalid |= digit & ~1;
+        value = (value << 1) | (digit & 1);
+    }
+
+    valid = (invalid == 0);
+    return value;
 }
 
 
@@ -42,6 +81,9 @@ string VirtualAddress::to_string() const {
 ostream& operator <<(ostream& out, const VirtualAddress& address) {
     // convert the virtual address into a readable string
     string output = "PID " + to_string(address.process_id) + " @ " + address.to_string() + " [page: " + to_string(address.page) + "; offset: " + to_string(address.offset) + "]";
+    if (address.write) {
+        output += " (write)";
+    }
     out << output;
     return out;
 }
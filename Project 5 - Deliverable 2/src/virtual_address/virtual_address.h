@@ -3,6 +3,7 @@
  */
 
 #pragma once
+#include "address_layout/address_layout.h"
 #include <cstdlib>
 #include <ostream>
 #include <bitset>
@@ -17,32 +18,37 @@ class VirtualAddress {
 // PUBLIC CONSTANTS
 public:
 
+  /**
+   * The layout of the virtual addresses in a trace.
+   */
+  typedef TraceLayout Layout;
+
   /**
    * The number of bits in the virtual address that are used to represent which
    * the page to be accessed.
    */
-  static const size_t PAGE_BITS = 10;
+  static const size_t PAGE_BITS = Layout::PAGE_BITS;
 
   /**
    * The number of bits in the virtual address that are used to represent the
    * offset into the corresponding page.
    */
-  static const size_t OFFSET_BITS = 6;
+  static const size_t OFFSET_BITS = Layout::OFFSET_BITS;
 
   /**
    * The total number of bits in a virtual address.
    */
-  static const size_t ADDRESS_BITS = PAGE_BITS + OFFSET_BITS;
+  static const size_t ADDRESS_BITS = Layout::ADDRESS_BITS;
 
   /**
    * A bitmask for the offset portion of the address.
    */
-  static const size_t OFFSET_BITMASK = (1 << OFFSET_BITS) - 1;
+  static const size_t OFFSET_BITMASK = Layout::OFFSET_BITMASK;
 
   /**
    * A bitmask for the page portion of the address.
    */
-  static const size_t PAGE_BITMASK = ((1 << PAGE_BITS) - 1) << OFFSET_BITS;
+  static const size_t PAGE_BITMASK = Layout::PAGE_BITMASK;
 
 // PUBLIC API METHODS
 public:
@@ -52,11 +58,26 @@ public:
    */
   static VirtualAddress from_string(int process_id, std::string address);
 
+  /**
+   * Creates a new VirtualAddress instance from the first ADDRESS_BITS binary
+   * digits of the given buffer, without allocating. Throws std::out_of_range if
+   * the buffer is too short, or std::invalid_argument if the digits are not all
+   * '0' or '1'.
+   */
+  static VirtualAddress from_chars(int process_id, const char* address, size_t length, bool write = false);
+
+  /**
+   * Converts count binary digits into an integer, eight digits at a time with
+   * no branches on the digit values. Sets valid to false if any of the digits
+   * are not '0' or '1'.
+   */
+  static size_t parse_binary(const char* digits, size_t count, bool& valid);
+
   /**
    * Constructor.
    */
-  VirtualAddress(int process_id, int page, int offset)
-      : process_id(process_id), page(page), offset(offset) {}
+  VirtualAddress(int process_id, int page, int offset, bool write = false)
+      : process_id(process_id), page(page), offset(offset), write(write) {}
 
   /**
    * Returns the full address as a binary string (1's and 0's).
@@ -80,6 +101,11 @@ public:
    * The offset into the specified page represented by this address.
    */
   const size_t offset;
+
+  /**
+   * True if the access writes to the address, or false if it only reads it.
+   */
+  const bool write;
 };
 
 
@@ -8,6 +8,7 @@
 #include "gtest/gtest.h"
 #include <bitset>
 #include <sstream>
+#include <stdexcept>
 
 using namespace std;
 
@@ -68,3 +69,56 @@ TEST(VirtualAddress, OutputOperator) {
   ASSERT_EQ(expected_output.str(), output.str());
 }
 
+
+
+TEST(VirtualAddress, OutputOperator_Write) {
+  VirtualAddress address = VirtualAddress::from_chars(PID, ADDRESS_STRING.data(), ADDRESS_STRING.size(), true);
+  stringstream output;
+
+  output << address;
+
+  ASSERT_TRUE(address.write);
+  ASSERT_NE(string::npos, output.str().find("] (write)"));
+}
+
+
+TEST(VirtualAddress, FromChars) {
+  // Only the first ADDRESS_BITS characters are part of the address.
+  const string buffer = ADDRESS_STRING + " trailing";
+  VirtualAddress address = VirtualAddress::from_chars(PID, buffer.data(), buffer.size());
+
+  ASSERT_EQ(PID, address.process_id);
+  ASSERT_EQ(PAGE, address.page);
+  ASSERT_EQ(OFFSET, address.offset);
+}
+
+
+TEST(VirtualAddress, FromChars_TooShort) {
+  ASSERT_THROW(VirtualAddress::from_chars(PID, "10101", 5), out_of_range);
+}
+
+
+TEST(VirtualAddress, FromChars_InvalidDigit) {
+  ASSERT_THROW(VirtualAddress::from_string(PID, "1000100021101010"), invalid_argument);
+  ASSERT_THROW(VirtualAddress::from_string(PID, "100010001110101a"), invalid_argument);
+}
+
+
+TEST(VirtualAddress, ParseBinary) {
+  bool valid = true;
+
+  for (size_t value : {0, 1, 2, 0x5a5a, 0xffff, 0x8001}) {
+    string digits = bitset<16>(value).to_string();
+    ASSERT_EQ(value, VirtualAddress::parse_binary(digits.data(), 16, valid));
+    ASSERT_TRUE(valid);
+  }
+
+  // Counts that are not a multiple of eight.
+  ASSERT_EQ(0x2b, VirtualAddress::parse_binary("101011", 6, valid));
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(0x5a5, VirtualAddress::parse_binary("10110100101", 11, valid));
+  ASSERT_TRUE(valid);
+
+  VirtualAddress::parse_binary("0101010/", 8, valid);
+  ASSERT_FALSE(valid);
+}